@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Cortex-A9 MPCore private timer, used by the sampling profiler
+ *
+ * The private timer and the GIC are at fixed offsets from PERIPHBASE. The
+ * timer interrupt (PPI 29) is enabled in the secure group 0, which U-Boot
+ * normally runs in, and signalled as IRQ. The timer is clocked by
+ * PERIPHCLK, whose rate is not known here, so it is measured against the
+ * system timer when the profiler is started.
+ */
+
+#include <common.h>
+#include <profile.h>
+#include <asm/armv7.h>
+#include <asm/gic.h>
+#include <asm/io.h>
+
+#define PRIVATE_TIMER_OFFSET	0x600
+#define PRIVATE_TIMER_IRQ	29
+
+/* Private timer registers */
+#define PTIMER_LOAD		0x00
+#define PTIMER_COUNTER		0x04
+#define PTIMER_CONTROL		0x08
+#define PTIMER_ISR		0x0c
+
+#define PTIMER_CONTROL_ENABLE		BIT(0)
+#define PTIMER_CONTROL_AUTO_RELOAD	BIT(1)
+#define PTIMER_CONTROL_IRQ_ENABLE	BIT(2)
+#define PTIMER_ISR_EVENT		BIT(0)
+
+#define GICC_IAR_IRQ_MASK	0x3ff
+#define GIC_SPURIOUS_IRQ	1023
+#define GIC_TIMER_PRIORITY	0xa0
+#define GIC_PRIORITY_MASK	0xf0
+
+/* Time over which PERIPHCLK is measured */
+#define CALIBRATE_US		10000
+
+/**
+ * struct mpcore_timer - State of the timer
+ *
+ * @timer:	Private timer base address
+ * @gicd:	GIC distributor base address
+ * @gicc:	GIC CPU interface base address
+ * @gicd_ctlr:	Saved GICD_CTLR
+ * @gicc_ctlr:	Saved GICC_CTLR
+ * @gicc_pmr:	Saved GICC_PMR
+ */
+static struct mpcore_timer {
+	ulong timer;
+	ulong gicd;
+	ulong gicc;
+	u32 gicd_ctlr;
+	u32 gicc_ctlr;
+	u32 gicc_pmr;
+} mpcore;
+
+static ulong mpcore_get_periphbase(void)
+{
+#ifdef CONFIG_ARM_GIC_BASE_ADDRESS
+	return CONFIG_ARM_GIC_BASE_ADDRESS;
+#else
+	u32 periphbase;
+
+	/* PERIPHBASE is in the Configuration Base Address Register */
+	asm("mrc p15, 4, %0, c15, c0, 0" : "=r" (periphbase));
+
+	return periphbase & CBAR_MASK;
+#endif
+}
+
+/* Return the number of timer ticks per second */
+static ulong mpcore_measure_clock(void)
+{
+	u32 ticks;
+
+	writel(0, mpcore.timer + PTIMER_CONTROL);
+	writel(~0U, mpcore.timer + PTIMER_LOAD);
+	writel(PTIMER_CONTROL_ENABLE, mpcore.timer + PTIMER_CONTROL);
+	udelay(CALIBRATE_US);
+	ticks = ~readl(mpcore.timer + PTIMER_COUNTER);
+	writel(0, mpcore.timer + PTIMER_CONTROL);
+
+	return ticks * (1000000 / CALIBRATE_US);
+}
+
+int profile_timer_start(uint rate)
+{
+	ulong periphbase = mpcore_get_periphbase();
+	ulong load;
+
+	mpcore.timer = periphbase + PRIVATE_TIMER_OFFSET;
+	mpcore.gicd = periphbase + GIC_DIST_OFFSET;
+	mpcore.gicc = periphbase + GIC_CPU_OFFSET_A9;
+
+	load = mpcore_measure_clock() / rate;
+	if (!load)
+		return -EINVAL;
+	debug("%s: %lu ticks per sample\n", __func__, load);
+	writel(PTIMER_ISR_EVENT, mpcore.timer + PTIMER_ISR);
+
+	mpcore.gicd_ctlr = readl(mpcore.gicd + GICD_CTLR);
+	mpcore.gicc_ctlr = readl(mpcore.gicc + GICC_CTLR);
+	mpcore.gicc_pmr = readl(mpcore.gicc + GICC_PMR);
+	writeb(GIC_TIMER_PRIORITY,
+	       mpcore.gicd + GICD_IPRIORITYRn + PRIVATE_TIMER_IRQ);
+	writel(BIT(PRIVATE_TIMER_IRQ), mpcore.gicd + GICD_ISENABLERn);
+	writel(mpcore.gicd_ctlr | 1, mpcore.gicd + GICD_CTLR);
+	writel(GIC_PRIORITY_MASK, mpcore.gicc + GICC_PMR);
+	writel(mpcore.gicc_ctlr | 1, mpcore.gicc + GICC_CTLR);
+
+	writel(load - 1, mpcore.timer + PTIMER_LOAD);
+	writel(PTIMER_CONTROL_ENABLE | PTIMER_CONTROL_AUTO_RELOAD |
+	       PTIMER_CONTROL_IRQ_ENABLE, mpcore.timer + PTIMER_CONTROL);
+
+	return 0;
+}
+
+void profile_timer_stop(void)
+{
+	writel(0, mpcore.timer + PTIMER_CONTROL);
+	writel(PTIMER_ISR_EVENT, mpcore.timer + PTIMER_ISR);
+	writel(BIT(PRIVATE_TIMER_IRQ), mpcore.gicd + GICD_ICENABLERn);
+	writel(BIT(PRIVATE_TIMER_IRQ), mpcore.gicd + GICD_ICPENDRn);
+
+	writel(mpcore.gicc_ctlr, mpcore.gicc + GICC_CTLR);
+	writel(mpcore.gicc_pmr, mpcore.gicc + GICC_PMR);
+	writel(mpcore.gicd_ctlr, mpcore.gicd + GICD_CTLR);
+}
+
+int profile_timer_irq(void)
+{
+	u32 iar, irq;
+
+	/* The profiler has never been started */
+	if (!mpcore.gicc)
+		return -ENOENT;
+	iar = readl(mpcore.gicc + GICC_IAR);
+	irq = iar & GICC_IAR_IRQ_MASK;
+	if (irq == GIC_SPURIOUS_IRQ)
+		return 0;
+	if (irq == PRIVATE_TIMER_IRQ)
+		writel(PTIMER_ISR_EVENT, mpcore.timer + PTIMER_ISR);
+	writel(iar, mpcore.gicc + GICC_EOIR);
+
+	return irq == PRIVATE_TIMER_IRQ ? 1 : -ENOENT;
+}
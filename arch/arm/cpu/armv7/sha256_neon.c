@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * SHA-256 block function with the message schedule computed using NEON
+ *
+ * The 48 expanded message words are computed four at a time in NEON
+ * registers and stored together with the round constants already added,
+ * so the integer pipeline only has to run the compression rounds, with
+ * one addition less per round.
+ *
+ * Only <arm_neon.h> is included here: the compiler's fixed-width integer
+ * types do not match U-Boot's on all toolchains, so this file must not
+ * pull in any U-Boot header. The prototype is in <u-boot/sha256.h>.
+ */
+
+#include <arm_neon.h>
+
+static const uint32_t sha256_k[64] __attribute__((aligned(16))) = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define ROR(x, n)	(((x) >> (n)) | ((x) << (32 - (n))))
+#define S0(x)		(ROR(x, 2) ^ ROR(x, 13) ^ ROR(x, 22))
+#define S1(x)		(ROR(x, 6) ^ ROR(x, 11) ^ ROR(x, 25))
+#define CH(x, y, z)	((z) ^ ((x) & ((y) ^ (z))))
+#define MAJ(x, y, z)	(((x) & (y)) | ((z) & ((x) | (y))))
+
+#define ROUND(a, b, c, d, e, f, g, h, wk) do {			\
+	uint32_t t1 = (h) + S1(e) + CH(e, f, g) + (wk);		\
+	uint32_t t2 = S0(a) + MAJ(a, b, c);			\
+	(d) += t1;						\
+	(h) = t1 + t2;						\
+} while (0)
+
+/* sigma0(x) = ror(x, 7) ^ ror(x, 18) ^ (x >> 3), on four words */
+static inline uint32x4_t sigma0_q(uint32x4_t x)
+{
+	uint32x4_t r;
+
+	r = veorq_u32(vsriq_n_u32(vshlq_n_u32(x, 25), x, 7),
+		      vsriq_n_u32(vshlq_n_u32(x, 14), x, 18));
+
+	return veorq_u32(r, vshrq_n_u32(x, 3));
+}
+
+/* sigma1(x) = ror(x, 17) ^ ror(x, 19) ^ (x >> 10), on two words */
+static inline uint32x2_t sigma1_d(uint32x2_t x)
+{
+	uint32x2_t r;
+
+	r = veor_u32(vsri_n_u32(vshl_n_u32(x, 15), x, 17),
+		     vsri_n_u32(vshl_n_u32(x, 13), x, 19));
+
+	return veor_u32(r, vshr_n_u32(x, 10));
+}
+
+/*
+ * Compute W[t..t+3] from w0 = W[t-16..t-13], w1 = W[t-12..t-9],
+ * w2 = W[t-8..t-5] and w3 = W[t-4..t-1]
+ */
+static inline uint32x4_t sha256_neon_expand(uint32x4_t w0, uint32x4_t w1,
+					    uint32x4_t w2, uint32x4_t w3)
+{
+	uint32x4_t x;
+	uint32x2_t lo, hi;
+
+	/* W[t-16] + sigma0(W[t-15]) + W[t-7] */
+	x = vaddq_u32(w0, sigma0_q(vextq_u32(w0, w1, 1)));
+	x = vaddq_u32(x, vextq_u32(w2, w3, 1));
+
+	/* sigma1(W[t-2]) needs the first two new words for the last two */
+	lo = vadd_u32(vget_low_u32(x), sigma1_d(vget_high_u32(w3)));
+	hi = vadd_u32(vget_high_u32(x), sigma1_d(lo));
+
+	return vcombine_u32(lo, hi);
+}
+
+int sha256_blocks_arch(uint32_t state[8], const uint8_t *data,
+		       unsigned int blocks)
+{
+	uint32_t wk[64] __attribute__((aligned(16)));
+	uint32_t a, b, c, d, e, f, g, h;
+	uint32x4_t w[4];
+	int i;
+
+	while (blocks--) {
+		for (i = 0; i < 4; i++) {
+			w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data)));
+			data += 16;
+			vst1q_u32(&wk[4 * i],
+				  vaddq_u32(w[i], vld1q_u32(&sha256_k[4 * i])));
+		}
+		for (i = 4; i < 16; i++) {
+			w[i & 3] = sha256_neon_expand(w[i & 3], w[(i + 1) & 3],
+						      w[(i + 2) & 3],
+						      w[(i + 3) & 3]);
+			vst1q_u32(&wk[4 * i],
+				  vaddq_u32(w[i & 3],
+					    vld1q_u32(&sha256_k[4 * i])));
+		}
+
+		a = state[0];
+		b = state[1];
+		c = state[2];
+		d = state[3];
+		e = state[4];
+		f = state[5];
+		g = state[6];
+		h = state[7];
+
+		for (i = 0; i < 64; i += 8) {
+			ROUND(a, b, c, d, e, f, g, h, wk[i + 0]);
+			ROUND(h, a, b, c, d, e, f, g, wk[i + 1]);
+			ROUND(g, h, a, b, c, d, e, f, wk[i + 2]);
+			ROUND(f, g, h, a, b, c, d, e, wk[i + 3]);
+			ROUND(e, f, g, h, a, b, c, d, wk[i + 4]);
+			ROUND(d, e, f, g, h, a, b, c, wk[i + 5]);
+			ROUND(c, d, e, f, g, h, a, b, wk[i + 6]);
+			ROUND(b, c, d, e, f, g, h, a, wk[i + 7]);
+		}
+
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+		state[5] += f;
+		state[6] += g;
+		state[7] += h;
+	}
+
+	return 1;
+}
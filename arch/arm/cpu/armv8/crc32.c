@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * CRC32 using the ARMv8 CRC32 instructions
+ */
+
+#include <common.h>
+#include <efi_loader.h>
+#include <u-boot/crc.h>
+
+/* ID_AA64ISAR0_EL1.CRC32, bits [19:16] */
+#define ISAR0_CRC32_SHIFT	16
+#define ISAR0_CRC32_MASK	0xf
+
+/* Not in lib/crc32.c: its const tables share the EFI runtime data section */
+int __efi_runtime_data crc32_use_arch = 1;
+
+int __efi_runtime crc32_no_comp_arch(uint32_t *crcp, const unsigned char *buf,
+				     uint len)
+{
+	uint32_t crc = *crcp;
+	u64 isar0;
+
+	asm volatile("mrs %0, id_aa64isar0_el1" : "=r" (isar0));
+	if (!((isar0 >> ISAR0_CRC32_SHIFT) & ISAR0_CRC32_MASK))
+		return 0;
+
+	/* Unaligned loads trap while the MMU is off, so align first */
+	for (; len && ((uintptr_t)buf & 7); len--, buf++)
+		asm("crc32b %w0, %w0, %w1" : "+r" (crc) : "r" (*buf));
+
+	for (; len >= 8; len -= 8, buf += 8)
+		asm("crc32x %w0, %w0, %x1" : "+r" (crc)
+		    : "r" (le64_to_cpu(*(const u64 *)buf)));
+
+	if (len & 4) {
+		asm("crc32w %w0, %w0, %w1" : "+r" (crc)
+		    : "r" (le32_to_cpu(*(const u32 *)buf)));
+		buf += 4;
+	}
+	if (len & 2) {
+		asm("crc32h %w0, %w0, %w1" : "+r" (crc)
+		    : "r" (le16_to_cpu(*(const u16 *)buf)));
+		buf += 2;
+	}
+	if (len & 1)
+		asm("crc32b %w0, %w0, %w1" : "+r" (crc) : "r" (*buf));
+
+	*crcp = crc;
+
+	return 1;
+}
@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * SHA-1 block function using the ARMv8 Cryptography Extensions
+ *
+ * Only <arm_neon.h> is included here: the compiler's fixed-width integer
+ * types do not match U-Boot's on all toolchains, so this file must not
+ * pull in any U-Boot header. The prototype is in <u-boot/sha1.h>.
+ */
+
+#include <arm_neon.h>
+
+/* ID_AA64ISAR0_EL1.SHA1, bits [11:8] */
+#define ISAR0_SHA1_SHIFT	8
+#define ISAR0_SHA1_MASK		0xf
+
+static const uint32_t sha1_k[4] = {
+	0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6,
+};
+
+static int sha1_ce_supported(void)
+{
+	uint64_t isar0;
+
+	asm volatile("mrs %0, id_aa64isar0_el1" : "=r" (isar0));
+
+	return !!((isar0 >> ISAR0_SHA1_SHIFT) & ISAR0_SHA1_MASK);
+}
+
+static inline uint32x4_t sha1_ce_load(const uint8_t *data)
+{
+	return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data)));
+}
+
+/* The context holds the state as unsigned long, which is 64-bit here */
+int sha1_blocks_arch(unsigned long state[5], const uint8_t *data,
+		     unsigned int blocks)
+{
+	uint32x4_t abcd, abcd_save, wk;
+	uint32x4_t msg[4];
+	uint32_t e0, e1, e_save;
+	int i;
+
+	if (!sha1_ce_supported())
+		return 0;
+
+	abcd = vsetq_lane_u32(state[0], vdupq_n_u32(0), 0);
+	abcd = vsetq_lane_u32(state[1], abcd, 1);
+	abcd = vsetq_lane_u32(state[2], abcd, 2);
+	abcd = vsetq_lane_u32(state[3], abcd, 3);
+	e0 = state[4];
+
+	while (blocks--) {
+		abcd_save = abcd;
+		e_save = e0;
+
+		for (i = 0; i < 4; i++)
+			msg[i] = sha1_ce_load(data + 16 * i);
+		data += 64;
+
+		/* 20 groups of four rounds; the schedule runs 4 words ahead */
+		for (i = 0; i < 20; i++) {
+			wk = vaddq_u32(msg[i & 3], vdupq_n_u32(sha1_k[i / 5]));
+			if (i < 16)
+				msg[i & 3] = vsha1su1q_u32(
+					vsha1su0q_u32(msg[i & 3],
+						      msg[(i + 1) & 3],
+						      msg[(i + 2) & 3]),
+					msg[(i + 3) & 3]);
+			e1 = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+			if (i < 5)
+				abcd = vsha1cq_u32(abcd, e0, wk);
+			else if (i >= 10 && i < 15)
+				abcd = vsha1mq_u32(abcd, e0, wk);
+			else
+				abcd = vsha1pq_u32(abcd, e0, wk);
+			e0 = e1;
+		}
+
+		abcd = vaddq_u32(abcd, abcd_save);
+		e0 += e_save;
+	}
+
+	state[0] = vgetq_lane_u32(abcd, 0);
+	state[1] = vgetq_lane_u32(abcd, 1);
+	state[2] = vgetq_lane_u32(abcd, 2);
+	state[3] = vgetq_lane_u32(abcd, 3);
+	state[4] = e0;
+
+	return 1;
+}
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * SHA-256 block function using the ARMv8 Cryptography Extensions
+ *
+ * Only <arm_neon.h> is included here: the compiler's fixed-width integer
+ * types do not match U-Boot's on all toolchains, so this file must not
+ * pull in any U-Boot header. The prototype is in <u-boot/sha256.h>.
+ */
+
+#include <arm_neon.h>
+
+/* ID_AA64ISAR0_EL1.SHA2, bits [15:12] */
+#define ISAR0_SHA2_SHIFT	12
+#define ISAR0_SHA2_MASK		0xf
+
+static const uint32_t sha256_k[64] __attribute__((aligned(16))) = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static int sha256_ce_supported(void)
+{
+	uint64_t isar0;
+
+	asm volatile("mrs %0, id_aa64isar0_el1" : "=r" (isar0));
+
+	return !!((isar0 >> ISAR0_SHA2_SHIFT) & ISAR0_SHA2_MASK);
+}
+
+static inline uint32x4_t sha256_ce_load(const uint8_t *data)
+{
+	return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data)));
+}
+
+int sha256_blocks_arch(uint32_t state[8], const uint8_t *data,
+		       unsigned int blocks)
+{
+	uint32x4_t abcd, efgh, abcd_save, efgh_save, tmp, wk;
+	uint32x4_t msg[4];
+	int i;
+
+	if (!sha256_ce_supported())
+		return 0;
+
+	abcd = vld1q_u32(&state[0]);
+	efgh = vld1q_u32(&state[4]);
+
+	while (blocks--) {
+		abcd_save = abcd;
+		efgh_save = efgh;
+
+		for (i = 0; i < 4; i++)
+			msg[i] = sha256_ce_load(data + 16 * i);
+		data += 64;
+
+		/* 16 groups of four rounds; the schedule runs 4 words ahead */
+		for (i = 0; i < 16; i++) {
+			wk = vaddq_u32(msg[i & 3], vld1q_u32(&sha256_k[4 * i]));
+			if (i < 12)
+				msg[i & 3] = vsha256su1q_u32(
+					vsha256su0q_u32(msg[i & 3],
+							msg[(i + 1) & 3]),
+					msg[(i + 2) & 3], msg[(i + 3) & 3]);
+			tmp = abcd;
+			abcd = vsha256hq_u32(abcd, efgh, wk);
+			efgh = vsha256h2q_u32(efgh, tmp, wk);
+		}
+
+		abcd = vaddq_u32(abcd, abcd_save);
+		efgh = vaddq_u32(efgh, efgh_save);
+	}
+
+	vst1q_u32(&state[0], abcd);
+	vst1q_u32(&state[4], efgh);
+
+	return 1;
+}
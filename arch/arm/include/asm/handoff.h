@@ -0,0 +1,16 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Architecture-specific SPL handoff information for ARM
+ */
+
+#ifndef __asm_handoff_h
+#define __asm_handoff_h
+
+#ifdef CONFIG_ARCH_SOCFPGA
+#include <asm/arch/handoff.h>
+#else
+struct arch_spl_handoff {
+};
+#endif
+
+#endif
@@ -20,6 +20,9 @@ extern char * strchr(const char * s, int c);
 extern void * memcpy(void *, const void *, __kernel_size_t);
 
 #undef __HAVE_ARCH_MEMMOVE
+#if CONFIG_IS_ENABLED(ARM_NEON_MEM)
+#define __HAVE_ARCH_MEMMOVE
+#endif
 extern void * memmove(void *, const void *, __kernel_size_t);
 
 #undef __HAVE_ARCH_MEMCHR
@@ -31,6 +34,18 @@ extern void * memchr(const void *, int, __kernel_size_t);
 #endif
 extern void * memset(void *, int, __kernel_size_t);
 
+#if CONFIG_IS_ENABLED(ARM_NEON_MEM)
+/*
+ * The individual implementations behind memcpy() and memset(), e.g. for
+ * benchmarking. The NEON versions need at least 64 bytes and fall back to
+ * the ARM versions if NEON is not enabled.
+ */
+extern void *memcpy_arm(void *, const void *, __kernel_size_t);
+extern void *memcpy_neon(void *, const void *, __kernel_size_t);
+extern void *memset_arm(void *, int, __kernel_size_t);
+extern void *memset_neon(void *, int, __kernel_size_t);
+#endif
+
 #if 0
 extern void __memzero(void *ptr, __kernel_size_t n);
 
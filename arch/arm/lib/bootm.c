@@ -20,6 +20,8 @@
 #include <asm/byteorder.h>
 #include <linux/libfdt.h>
 #include <mapmem.h>
+#include <profile.h>
+#include <serial.h>
 #include <fdt_support.h>
 #include <asm/bootm.h>
 #include <asm/secure.h>
@@ -97,6 +99,14 @@ static void announce_and_cleanup(int fake)
 #ifdef CONFIG_BOOTSTAGE_REPORT
 	bootstage_report();
 #endif
+#if CONFIG_IS_ENABLED(DM_SERIAL)
+	/* Buffered console output would be lost once the kernel runs */
+	serial_flush();
+#endif
+#if CONFIG_IS_ENABLED(PROFILE)
+	/* The kernel must not get the profiler's timer interrupt */
+	profile_stop();
+#endif
 
 #ifdef CONFIG_USB_DEVICE
 	udc_disconnect();
@@ -20,6 +20,7 @@
 
 #include <common.h>
 #include <efi_loader.h>
+#include <profile.h>
 #include <asm/proc-armv/ptrace.h>
 #include <asm/u-boot-arm.h>
 
@@ -31,17 +32,39 @@ int interrupt_init (void)
 	 * setup up stacks if necessary
 	 */
 	IRQ_STACK_START_IN = gd->irq_sp + 8;
+#if CONFIG_IS_ENABLED(PROFILE)
+	/* see arch_reserve_stacks() */
+	IRQ_STACK_START = gd->irq_sp - 16;
+#endif
 
 	return 0;
 }
 
+/*
+ * Interrupts are only used by the sampling profiler. Until it has set up its
+ * timer and the GIC, this does nothing, so that a stray interrupt cannot be
+ * taken, e.g. from board_init_r() or after a failed bootm.
+ */
 void enable_interrupts (void)
 {
+#if CONFIG_IS_ENABLED(PROFILE)
+	if (profile_running())
+		asm volatile("cpsie i" : : : "memory");
+#endif
 	return;
 }
 int disable_interrupts (void)
 {
+#if CONFIG_IS_ENABLED(PROFILE)
+	ulong cpsr;
+
+	asm volatile("mrs %0, cpsr\n"
+		     "cpsid i" : "=r" (cpsr) : : "memory");
+
+	return !(cpsr & I_BIT);
+#else
 	return 0;
+#endif
 }
 
 void bad_mode (void)
@@ -191,9 +214,20 @@ void do_fiq (struct pt_regs *pt_regs)
 
 void do_irq (struct pt_regs *pt_regs)
 {
+#if CONFIG_IS_ENABLED(PROFILE)
+	int ret = profile_timer_irq();
+
+	if (ret > 0)
+		profile_sample(instruction_pointer(pt_regs), pt_regs->ARM_lr);
+	if (ret >= 0)
+		return;
+#endif
 	efi_restore_gd();
 	printf ("interrupt request\n");
+#if !CONFIG_IS_ENABLED(PROFILE)
+	/* with the profiler, the pc in the frame is already correct */
 	fixup_pc(pt_regs, -8);
+#endif
 	show_regs (pt_regs);
 	show_efi_loaded_images(pt_regs);
 	bad_mode ();
@@ -21,6 +21,7 @@
  */
 
 #include <common.h>
+#include <serial.h>
 
 __weak void reset_misc(void)
 {
@@ -30,6 +31,9 @@ int do_reset(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 {
 	puts ("resetting ...\n");
 
+#if CONFIG_IS_ENABLED(DM_SERIAL)
+	serial_flush();
+#endif
 	udelay (50000);				/* wait 50 ms */
 
 	disable_interrupts();
@@ -11,6 +11,7 @@
  * Marius Groeger <mgroeger@sysgo.de>
  */
 #include <common.h>
+#include <profile.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -26,6 +27,10 @@ int arch_reserve_stacks(void)
 # if !defined(CONFIG_ARM64)
 	/* leave 3 words for abort-stack, plus 1 for alignment */
 	gd->start_addr_sp -= 16;
+#  if CONFIG_IS_ENABLED(PROFILE)
+	/* and a stack for the profiler's timer interrupt */
+	gd->start_addr_sp -= PROFILE_IRQ_STACK_SIZE;
+#  endif
 # endif
 #endif
 
@@ -4,6 +4,7 @@
  */
 
 #include <common.h>
+#include <handoff.h>
 #include <wait_bit.h>
 #include <asm/io.h>
 #include <asm/arch/clock_manager.h>
@@ -60,6 +61,15 @@ int set_cpu_clk_info(void)
 	return 0;
 }
 
+#if defined(CONFIG_SPL_BUILD) && CONFIG_IS_ENABLED(HANDOFF)
+void handoff_save_arch(struct spl_handoff *ho)
+{
+	ho->arch.mpu_clk_hz = cm_get_mpu_clk_hz();
+	ho->arch.qspi_clk_hz = cm_get_qspi_controller_clk_hz();
+	ho->arch.l4_sp_clk_hz = cm_get_l4_sp_clk_hz();
+}
+#endif
+
 #ifndef CONFIG_SPL_BUILD
 static int do_showclocks(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 {
@@ -9,8 +9,11 @@
 #include <dm.h>
 #include <clk.h>
 #include <dm/device-internal.h>
+#include <handoff.h>
 #include <asm/arch/clock_manager.h>
 
+DECLARE_GLOBAL_DATA_PTR;
+
 #ifdef CONFIG_SPL_BUILD
 
 static u32 eosc1_hz;
@@ -962,19 +965,36 @@ static u32 cm_get_rate_dm_khz(char *name)
 	return cm_get_rate_dm(name) / 1000;
 }
 
+/*
+ * U-Boot proper uses the rates passed on by SPL where it can, rather than
+ * probing the clock driver again
+ */
+#if !defined(CONFIG_SPL_BUILD) && CONFIG_IS_ENABLED(HANDOFF)
+#define cm_get_rate_handoff(field) \
+	(gd->spl_handoff ? gd->spl_handoff->arch.field : 0)
+#else
+#define cm_get_rate_handoff(field)	0
+#endif
+
 unsigned long cm_get_mpu_clk_hz(void)
 {
-	return cm_get_rate_dm("main_mpu_base_clk");
+	unsigned long rate = cm_get_rate_handoff(mpu_clk_hz);
+
+	return rate ? rate : cm_get_rate_dm("main_mpu_base_clk");
 }
 
 unsigned int cm_get_qspi_controller_clk_hz(void)
 {
-	return cm_get_rate_dm("qspi_clk");
+	unsigned int rate = cm_get_rate_handoff(qspi_clk_hz);
+
+	return rate ? rate : cm_get_rate_dm("qspi_clk");
 }
 
 unsigned int cm_get_l4_sp_clk_hz(void)
 {
-	return cm_get_rate_dm("l4_sp_clk");
+	unsigned int rate = cm_get_rate_handoff(l4_sp_clk_hz);
+
+	return rate ? rate : cm_get_rate_dm("l4_sp_clk");
 }
 
 void cm_print_clock_quick_summary(void)
@@ -0,0 +1,25 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * SoCFPGA information passed from SPL to U-Boot proper
+ */
+
+#ifndef _SOCFPGA_HANDOFF_H_
+#define _SOCFPGA_HANDOFF_H_
+
+/**
+ * struct arch_spl_handoff - SoCFPGA SPL hand-off information
+ *
+ * SPL sets up the clocks, so U-Boot proper can use these rates rather than
+ * looking them up again. A rate of 0 means it is not known.
+ *
+ * @mpu_clk_hz:		MPU clock rate
+ * @qspi_clk_hz:	QSPI controller reference clock rate
+ * @l4_sp_clk_hz:	L4 SP clock rate
+ */
+struct arch_spl_handoff {
+	u32 mpu_clk_hz;
+	u32 qspi_clk_hz;
+	u32 l4_sp_clk_hz;
+};
+
+#endif /* _SOCFPGA_HANDOFF_H_ */
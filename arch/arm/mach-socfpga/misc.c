@@ -7,6 +7,7 @@
 #include <asm/io.h>
 #include <errno.h>
 #include <fdtdec.h>
+#include <handoff.h>
 #include <linux/libfdt.h>
 #include <altera.h>
 #include <miiphy.h>
@@ -44,6 +45,13 @@ struct bsel bsel_str[] = {
 
 int dram_init(void)
 {
+#if CONFIG_IS_ENABLED(HANDOFF)
+	/* SPL has already sized SDRAM, unless it left the size unset */
+	if (gd->spl_handoff && gd->spl_handoff->ram_size) {
+		handoff_load_dram_size(gd->spl_handoff);
+		return 0;
+	}
+#endif
 	if (fdtdec_setup_mem_size_base() != 0)
 		return -EINVAL;
 
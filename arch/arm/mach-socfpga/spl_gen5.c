@@ -17,6 +17,7 @@
 #include <asm/arch/scan_manager.h>
 #include <asm/arch/sdram.h>
 #include <asm/sections.h>
+#include <asm/system.h>
 #include <debug_uart.h>
 #include <fdtdec.h>
 #include <watchdog.h>
@@ -63,6 +64,31 @@ u32 spl_boot_mode(const u32 boot_device)
 }
 #endif
 
+/*
+ * Loading the next stage, and decompressing it in particular, is much
+ * faster with the data cache on. SPL runs from OCRAM, which is left
+ * uncached, so only SDRAM is mapped cacheable.
+ */
+static void socfpga_spl_enable_dcache(unsigned long sdram_size)
+{
+	spl_set_bd();
+	gd->bd->bi_dram[0].start = CONFIG_SYS_SDRAM_BASE;
+	gd->bd->bi_dram[0].size = sdram_size;
+
+	/* Nothing is loaded to the top of SDRAM, so put the page table there */
+	gd->arch.tlb_size = PGTABLE_SIZE;
+	gd->arch.tlb_addr = CONFIG_SYS_SDRAM_BASE + sdram_size - PGTABLE_SIZE;
+
+	dcache_enable();
+}
+
+void spl_board_prepare_for_boot(void)
+{
+	/* U-Boot expects to be entered with the MMU and data cache off */
+	if (IS_ENABLED(CONFIG_SPL_SOCFPGA_DCACHE))
+		dcache_disable();
+}
+
 void board_init_f(ulong dummy)
 {
 	const struct cm_config *cm_default_cfg = cm_get_default_config();
@@ -165,6 +191,10 @@ void board_init_f(ulong dummy)
 		puts("SDRAM size check failed!\n");
 		hang();
 	}
+	gd->ram_size = sdram_size;
+
+	if (IS_ENABLED(CONFIG_SPL_SOCFPGA_DCACHE))
+		socfpga_spl_enable_dcache(sdram_size);
 
 	if (!socfpga_is_booting_from_fpga())
 		socfpga_bridges_reset(1);
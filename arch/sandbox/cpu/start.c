@@ -350,10 +350,10 @@ int main(int argc, char *argv[])
 #endif
 	setup_ram_buf(state);
 
-	/* Do pre- and post-relocation init */
-	board_init_f(0);
+	/* Do pre- and post-relocation init. The code is never moved. */
+	board_init_f(GD_FLG_SKIP_RELOC);
 
-	board_init_r(gd->new_gd, 0);
+	board_init_r(gd, 0);
 
 	/* NOTREACHED - board_init_r() does not return */
 	return 0;
@@ -185,4 +185,33 @@ int sandbox_get_beep_frequency(struct udevice *dev);
  */
 int sandbox_get_pch_spi_protect(struct udevice *dev);
 
+/**
+ * sandbox_mmc_get_cmd_count() - Get the number of commands sent to an MMC
+ *
+ * @dev: Device to check
+ * @cmdidx: Command index (e.g. MMC_CMD_SEND_CSD)
+ * @return number of commands with that index sent since the device was bound
+ */
+int sandbox_mmc_get_cmd_count(struct udevice *dev, uint cmdidx);
+
+/**
+ * sandbox_serial_set_tx_pending() - Pretend that output is waiting to be sent
+ *
+ * The pending() method then reports @count output characters, one fewer
+ * each time it is called, as if the transmitter were slowly sending them.
+ *
+ * @dev: Serial device to update
+ * @count: Number of output characters to report as pending
+ */
+void sandbox_serial_set_tx_pending(struct udevice *dev, int count);
+
+/**
+ * sandbox_profile_tick() - Emulate the profiler's timer interrupt
+ *
+ * @pc: Program counter to record, as if it had been interrupted
+ * @lr: Link register to record
+ * @return 1 if a sample was taken, 0 if the profiler is not running
+ */
+int sandbox_profile_tick(ulong pc, ulong lr);
+
 #endif
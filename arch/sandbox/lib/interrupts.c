@@ -6,6 +6,8 @@
  */
 
 #include <common.h>
+#include <profile.h>
+#include <asm/test.h>
 
 int interrupt_init(void)
 {
@@ -20,3 +22,35 @@ int disable_interrupts(void)
 {
 	return 0;
 }
+
+#if CONFIG_IS_ENABLED(PROFILE)
+/* The profiler's timer only 'fires' when sandbox_profile_tick() is called */
+static uint profile_rate;
+
+int profile_timer_start(uint rate)
+{
+	profile_rate = rate;
+
+	return 0;
+}
+
+void profile_timer_stop(void)
+{
+	profile_rate = 0;
+}
+
+int profile_timer_irq(void)
+{
+	return profile_rate ? 1 : 0;
+}
+
+int sandbox_profile_tick(ulong pc, ulong lr)
+{
+	int ret = profile_timer_irq();
+
+	if (ret > 0)
+		profile_sample(pc, lr);
+
+	return ret;
+}
+#endif
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Falcon mode support for Enclustra Mercury and Mars modules
+ */
+
+#include <common.h>
+#include <environment.h>
+#include <serial.h>
+#include <spl.h>
+#include <asm/gpio.h>
+#include <dm/ofnode.h>
+
+#ifdef CONFIG_SPL_OS_BOOT
+/*
+ * Check the GPIO given by /config/u-boot,spl-boot-u-boot-gpio, if any. It
+ * lets a carrier board provide a button or jumper which forces U-Boot.
+ */
+static bool mercury_boot_uboot_gpio(void)
+{
+#if CONFIG_IS_ENABLED(GPIO_SUPPORT) && defined(CONFIG_DM_GPIO)
+	struct gpio_desc gpio;
+	ofnode node;
+	int ret;
+
+	node = ofnode_path("/config");
+	if (!ofnode_valid(node))
+		return false;
+
+	if (gpio_request_by_name_nodev(node, "u-boot,spl-boot-u-boot-gpio", 0,
+				       &gpio, GPIOD_IS_IN))
+		return false;
+
+	ret = dm_gpio_get_value(&gpio);
+	dm_gpio_free(NULL, &gpio);
+	debug("%s: U-Boot GPIO is %d\n", __func__, ret);
+
+	return ret > 0;
+#else
+	return false;
+#endif
+}
+
+/* Return: 1 - boot to U-Boot. 0 - boot OS (falcon mode) */
+int spl_start_uboot(void)
+{
+	/* break into full u-boot on 'c' */
+	if (serial_tstc() && serial_getc() == 'c')
+		return 1;
+
+	if (mercury_boot_uboot_gpio())
+		return 1;
+
+#ifdef CONFIG_SPL_ENV_SUPPORT
+	if (env_init() || env_load())
+		return 1;
+
+	if (env_get_yesno("boot_os") != 1)
+		return 1;
+#endif
+	return 0;
+}
+#endif
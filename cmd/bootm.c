@@ -84,12 +84,48 @@ static int do_bootm_subcommand(cmd_tbl_t *cmdtp, int flag, int argc,
 	return ret;
 }
 
+#ifdef CONFIG_FIT_DEV_LOAD
+/*
+ * Handle 'bootm dev <interface> <dev[:part]> <offset>[#conf] ...': read the
+ * FIT and the subimages of the selected configuration from the device to
+ * load_addr and build the matching 'addr#conf' specification in @spec.
+ */
+static int bootm_dev_load(char * const argv[], char *spec, int size)
+{
+	const char *conf_uname = NULL;
+	ulong offset;
+	char *endp;
+
+	offset = simple_strtoul(argv[3], &endp, 16);
+	if (*endp == '#')
+		conf_uname = endp + 1;
+	else if (*endp)
+		return CMD_RET_USAGE;
+
+	if (fit_dev_load(argv[1], argv[2], offset, load_addr, conf_uname,
+			 NULL))
+		return CMD_RET_FAILURE;
+
+	if (conf_uname)
+		snprintf(spec, size, "%lx#%s", load_addr, conf_uname);
+	else
+		snprintf(spec, size, "%lx", load_addr);
+
+	return 0;
+}
+#endif
+
 /*******************************************************************/
 /* bootm - boot application image from image in memory */
 /*******************************************************************/
 
 int do_bootm(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 {
+#ifdef CONFIG_FIT_DEV_LOAD
+	char *dev_argv[CONFIG_SYS_MAXARGS];
+	char fit_spec[64];
+	int i, ret;
+#endif
 #ifdef CONFIG_NEEDS_MANUAL_RELOC
 	static int relocated = 0;
 
@@ -106,6 +142,22 @@ int do_bootm(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 
 	/* determine if we have a sub command */
 	argc--; argv++;
+#ifdef CONFIG_FIT_DEV_LOAD
+	if (argc > 0 && !strcmp(argv[0], "dev")) {
+		if (argc < 4)
+			return CMD_RET_USAGE;
+		ret = bootm_dev_load(argv, fit_spec, sizeof(fit_spec));
+		if (ret)
+			return ret;
+
+		/* Continue as 'bootm addr[#conf] [arg ...]' */
+		dev_argv[0] = fit_spec;
+		for (i = 4; i < argc; i++)
+			dev_argv[i - 3] = argv[i];
+		argc -= 3;
+		argv = dev_argv;
+	}
+#endif
 	if (argc > 0) {
 		char *endp;
 
@@ -169,6 +221,12 @@ static char bootm_help_text[] =
 	"\taddr#<conf_uname>   - configuration specification\n"
 	"\tUse iminfo command to get the list of existing component\n"
 	"\timages and configurations.\n"
+#endif
+#if defined(CONFIG_FIT_DEV_LOAD)
+	"\ndev <interface> <dev[:part]> <offset>[#conf_uname] [arg ...]\n"
+	"\t- read a FIT stored at byte offset <offset> on a device to\n"
+	"\t  'loadaddr', fetching only the subimages of the selected\n"
+	"\t  configuration, and boot it ('sf' takes [bus:]cs as device)\n"
 #endif
 	"\nSub-commands to do part of the bootm sequence.  The sub-commands "
 	"must be\n"
@@ -4,6 +4,10 @@
  */
 
 #include <common.h>
+#include <command.h>
+#include <fs.h>
+#include <malloc.h>
+#include <mapmem.h>
 
 static int do_bootstage_report(cmd_tbl_t *cmdtp, int flag, int argc,
 			       char * const argv[])
@@ -57,10 +61,94 @@ static int do_bootstage_stash(cmd_tbl_t *cmdtp, int flag, int argc,
 	return 0;
 }
 
+/* Export the records as JSON into a new buffer, which the caller frees */
+static char *bootstage_export_alloc(int *lenp)
+{
+	char *buf;
+	int len;
+
+	len = bootstage_export_json(NULL, 0);
+	buf = malloc(len + 1);
+	if (!buf) {
+		printf("Out of memory\n");
+		return NULL;
+	}
+	bootstage_export_json(buf, len + 1);
+	*lenp = len;
+
+	return buf;
+}
+
+static int do_bootstage_export(cmd_tbl_t *cmdtp, int flag, int argc,
+			       char * const argv[])
+{
+	ulong base, size;
+	char *buf;
+	int len;
+
+	if (argc < 2) {
+		buf = bootstage_export_alloc(&len);
+		if (!buf)
+			return CMD_RET_FAILURE;
+		puts(buf);
+		free(buf);
+
+		return 0;
+	}
+
+	if (get_base_size(argc, argv, &base, &size))
+		return CMD_RET_USAGE;
+
+	buf = map_sysmem(base, size);
+	len = bootstage_export_json(buf, size);
+	unmap_sysmem(buf);
+	if (len >= size) {
+		printf("Need %d bytes to export bootstage data\n", len + 1);
+		return CMD_RET_FAILURE;
+	}
+	env_set_hex("filesize", len);
+
+	return 0;
+}
+
+#ifdef CONFIG_CMD_BOOTSTAGE_SAVE
+static int do_bootstage_save(cmd_tbl_t *cmdtp, int flag, int argc,
+			     char * const argv[])
+{
+	const char *fname = argc > 3 ? argv[3] : "bootstage.json";
+	loff_t actwrite;
+	char *buf;
+	int len, ret;
+
+	if (argc < 3)
+		return CMD_RET_USAGE;
+
+	buf = bootstage_export_alloc(&len);
+	if (!buf)
+		return CMD_RET_FAILURE;
+
+	ret = fs_set_blk_dev(argv[1], argv[2], FS_TYPE_ANY);
+	if (!ret)
+		ret = fs_write(fname, map_to_sysmem(buf), 0, len, &actwrite);
+	free(buf);
+	if (ret) {
+		printf("Cannot write %s\n", fname);
+		return CMD_RET_FAILURE;
+	}
+	printf("%llu bytes written to %s\n", actwrite, fname);
+
+	return 0;
+}
+#endif
+
 static cmd_tbl_t cmd_bootstage_sub[] = {
 	U_BOOT_CMD_MKENT(report, 2, 1, do_bootstage_report, "", ""),
 	U_BOOT_CMD_MKENT(stash, 4, 0, do_bootstage_stash, "", ""),
 	U_BOOT_CMD_MKENT(unstash, 4, 0, do_bootstage_stash, "", ""),
+	U_BOOT_CMD_MKENT(export, 3, 0, do_bootstage_export, "", ""),
+#ifdef CONFIG_CMD_BOOTSTAGE_SAVE
+	U_BOOT_CMD_MKENT(save, 4, 0, do_bootstage_save, "", ""),
+#endif
 };
 
 /*
@@ -85,10 +173,17 @@ static int do_boostage(cmd_tbl_t *cmdtp, int flag, int argc,
 }
 
 
-U_BOOT_CMD(bootstage, 4, 1, do_boostage,
+U_BOOT_CMD(bootstage, 5, 1, do_boostage,
 	"Boot stage command",
 	" - check boot progress and timing\n"
 	"report                      - Print a report\n"
 	"stash [<start> [<size>]]    - Stash data into memory\n"
-	"unstash [<start> [<size>]]  - Unstash data from memory"
+	"unstash [<start> [<size>]]  - Unstash data from memory\n"
+	"export [<start> [<size>]]   - Print all records as JSON, or write\n"
+	"                              them to memory and set 'filesize'"
+#ifdef CONFIG_CMD_BOOTSTAGE_SAVE
+	"\nsave <interface> <dev[:part]> [<filename>]\n"
+	"                            - Write all records as JSON to a file\n"
+	"                              (default bootstage.json)"
+#endif
 );
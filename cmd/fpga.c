@@ -344,8 +344,8 @@ static int do_fpga_loadmk(cmd_tbl_t *cmdtp, int flag, int argc,
 		}
 
 		/* get fpga subimage data address and length */
-		if (fit_image_get_data(fit_hdr, noffset, &fit_data,
-				       &data_size)) {
+		if (fit_image_get_data_and_size(fit_hdr, noffset, &fit_data,
+						&data_size)) {
 			puts("Fpga subimage data not found\n");
 			return CMD_RET_FAILURE;
 		}
@@ -360,6 +360,50 @@ static int do_fpga_loadmk(cmd_tbl_t *cmdtp, int flag, int argc,
 }
 #endif
 
+#if defined(CONFIG_CMD_FPGA_LOADMK) && defined(CONFIG_FIT_DEV_LOAD)
+static int do_fpga_loadmkdev(cmd_tbl_t *cmdtp, int flag, int argc,
+			     char * const argv[])
+{
+	const char *fit_uname;
+	char fit_spec[64];
+	char *mk_argv[2];
+	char *devstr;
+	ulong offset;
+	char *endp;
+
+	if (argc < cmdtp->maxargs - 1)
+		return CMD_RET_USAGE;
+
+	/* [dev] may be left out if the 'fpga' variable is set */
+	if (argc == cmdtp->maxargs) {
+		devstr = argv[0];
+		argv++;
+	} else {
+		devstr = env_get("fpga");
+		if (!devstr) {
+			debug("fpga: Invalid fpga device\n");
+			return CMD_RET_USAGE;
+		}
+	}
+
+	offset = simple_strtoul(argv[2], &endp, 16);
+	if (*endp != ':' || !endp[1]) {
+		puts("No FIT subimage unit name\n");
+		return CMD_RET_USAGE;
+	}
+	fit_uname = endp + 1;
+
+	if (fit_dev_load(argv[0], argv[1], offset, load_addr, NULL, fit_uname))
+		return CMD_RET_FAILURE;
+
+	snprintf(fit_spec, sizeof(fit_spec), "%lx:%s", load_addr, fit_uname);
+	mk_argv[0] = devstr;
+	mk_argv[1] = fit_spec;
+
+	return do_fpga_loadmk(cmdtp, flag, 2, mk_argv);
+}
+#endif
+
 static cmd_tbl_t fpga_commands[] = {
 	U_BOOT_CMD_MKENT(info, 1, 1, do_fpga_info, "", ""),
 	U_BOOT_CMD_MKENT(dump, 3, 1, do_fpga_dump, "", ""),
@@ -377,6 +421,9 @@ static cmd_tbl_t fpga_commands[] = {
 #if defined(CONFIG_CMD_FPGA_LOADMK)
 	U_BOOT_CMD_MKENT(loadmk, 2, 1, do_fpga_loadmk, "", ""),
 #endif
+#if defined(CONFIG_CMD_FPGA_LOADMK) && defined(CONFIG_FIT_DEV_LOAD)
+	U_BOOT_CMD_MKENT(loadmkdev, 4, 1, do_fpga_loadmkdev, "", ""),
+#endif
 #if defined(CONFIG_CMD_FPGA_LOAD_SECURE)
 	U_BOOT_CMD_MKENT(loads, 6, 1, do_fpga_loads, "", ""),
 #endif
@@ -445,6 +492,12 @@ U_BOOT_CMD(fpga, 6, 1, do_fpga_wrapper,
 	   "\tFor loadmk operating on FIT format uImage address must include\n"
 	   "\tsubimage unit name in the form of addr:<subimg_uname>"
 #endif
+#if defined(CONFIG_FIT_DEV_LOAD)
+	   "\n"
+	   "  loadmkdev [dev] <interface> <dev[:part]> <offset>:<subimg_uname>\n"
+	   "\tLoad device from a FIT subimage which is read on demand from\n"
+	   "\tbyte offset <offset> of a block device or SPI flash (sf)"
+#endif
 #endif
 #if defined(CONFIG_CMD_FPGA_LOAD_SECURE)
 	   "Load encrypted bitstream (Xilinx only)\n"
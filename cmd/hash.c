@@ -12,13 +12,90 @@
 #include <common.h>
 #include <command.h>
 #include <hash.h>
+#include <malloc.h>
 #include <linux/ctype.h>
+#include <u-boot/sha1.h>
+#include <u-boot/sha256.h>
+
+#ifdef CONFIG_CMD_HASH_BENCH
+/* Algorithms timed by 'hash bench', if they are available */
+static const char *const hash_bench_algos[] = {
+	"sha1", "sha256", "crc32", "crc16-ccitt",
+};
+
+static void hash_bench_one(struct hash_algo *algo, const char *impl,
+			   const void *buf, uint size)
+{
+	u8 output[HASH_MAX_DIGEST_SIZE];
+	ulong start, us;
+
+	start = timer_get_us();
+	algo->hash_func_ws(buf, size, output, algo->chunk_size);
+	us = max(timer_get_us() - start, 1UL);
+
+	printf("%-12s %-8s %10lu us %6lu.%lu MB/s\n", algo->name, impl, us,
+	       size / us, (size * 10UL / us) % 10);
+}
+
+static int do_hash_bench(int argc, char * const argv[])
+{
+	struct hash_algo *algo;
+	uint size = 1 << 20;
+	u8 *buf;
+	int i;
+
+	if (argc > 1)
+		size = simple_strtoul(argv[1], NULL, 16);
+	if (!size)
+		return CMD_RET_USAGE;
+
+	buf = malloc(size);
+	if (!buf) {
+		printf("Cannot allocate %#x bytes\n", size);
+		return CMD_RET_FAILURE;
+	}
+	for (i = 0; i < size; i++)
+		buf[i] = i * 7 + (i >> 8);
+
+	printf("Hashing %#x bytes\n", size);
+	for (i = 0; i < ARRAY_SIZE(hash_bench_algos); i++) {
+		if (hash_lookup_algo(hash_bench_algos[i], &algo))
+			continue;
+#ifdef CONFIG_SHA1_ARCH
+		if (!strcmp(algo->name, "sha1")) {
+			sha1_use_arch = 0;
+			hash_bench_one(algo, "generic", buf, size);
+			sha1_use_arch = 1;
+			hash_bench_one(algo, "arch", buf, size);
+			continue;
+		}
+#endif
+#ifdef CONFIG_SHA256_ARCH
+		if (!strcmp(algo->name, "sha256")) {
+			sha256_use_arch = 0;
+			hash_bench_one(algo, "generic", buf, size);
+			sha256_use_arch = 1;
+			hash_bench_one(algo, "arch", buf, size);
+			continue;
+		}
+#endif
+		hash_bench_one(algo, "", buf, size);
+	}
+	free(buf);
+
+	return 0;
+}
+#endif
 
 static int do_hash(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 {
 	char *s;
 	int flags = HASH_FLAG_ENV;
 
+#ifdef CONFIG_CMD_HASH_BENCH
+	if (argc > 1 && !strcmp(argv[1], "bench"))
+		return do_hash_bench(argc - 1, argv + 1);
+#endif
 #ifdef CONFIG_HASH_VERIFY
 	if (argc < 4)
 		return CMD_RET_USAGE;
@@ -52,4 +129,9 @@ U_BOOT_CMD(
 		"    - verify message digest of memory area to immediate value, \n"
 		"      env var or *address"
 #endif
+#ifdef CONFIG_CMD_HASH_BENCH
+	"\nhash bench [size]\n"
+		"    - measure the throughput of the available algorithms\n"
+		"      on 'size' bytes (hex, default 0x100000)"
+#endif
 );
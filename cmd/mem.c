@@ -17,6 +17,7 @@
 #include <command.h>
 #include <console.h>
 #include <hash.h>
+#include <malloc.h>
 #include <mapmem.h>
 #include <watchdog.h>
 #include <asm/io.h>
@@ -1168,6 +1169,107 @@ U_BOOT_CMD(
 
 #endif
 
+#ifdef CONFIG_CMD_MEM_BENCH
+/* Bytes moved per measurement, so that small sizes can be timed too */
+#define MEM_BENCH_TOTAL		(64 << 20)
+/* Distance between source and destination for overlapping memmove */
+#define MEM_BENCH_OVERLAP	64
+
+static void *mem_bench_memmove(void *dest, const void *src, size_t n)
+{
+	return memmove((void *)src + MEM_BENCH_OVERLAP, src, n);
+}
+
+/* The NEON implementations cannot handle less than this */
+#define MEM_BENCH_NEON_MIN	64
+
+static const struct {
+	const char *name;
+	void *(*func)(void *dest, const void *src, size_t n);
+	ulong min_size;
+} mem_bench_copy[] = {
+	{ "memcpy", memcpy },
+#if CONFIG_IS_ENABLED(ARM_NEON_MEM)
+	{ "memcpy_arm", memcpy_arm },
+	{ "memcpy_neon", memcpy_neon, MEM_BENCH_NEON_MIN },
+#endif
+	{ "memmove", mem_bench_memmove },
+};
+
+static const struct {
+	const char *name;
+	void *(*func)(void *s, int c, size_t n);
+	ulong min_size;
+} mem_bench_set[] = {
+	{ "memset", memset },
+#if CONFIG_IS_ENABLED(ARM_NEON_MEM)
+	{ "memset_arm", memset_arm },
+	{ "memset_neon", memset_neon, MEM_BENCH_NEON_MIN },
+#endif
+};
+
+static void mem_bench_show(const char *name, ulong size, ulong loops,
+			   ulong start)
+{
+	ulong us = max(timer_get_us() - start, 1UL);
+
+	printf("%-12s %8lu us %6lu MB/s\n", name, us, size * loops / us);
+}
+
+static int do_mem_bench(cmd_tbl_t *cmdtp, int flag, int argc,
+			char * const argv[])
+{
+	ulong size = 1 << 20;
+	ulong loops, start, n;
+	void *src, *dst;
+	int i;
+
+	if (argc > 1)
+		size = simple_strtoul(argv[1], NULL, 16);
+	if (!size)
+		return CMD_RET_USAGE;
+	loops = max(MEM_BENCH_TOTAL / size, 1UL);
+
+	src = malloc(size + MEM_BENCH_OVERLAP);
+	dst = malloc(size);
+	if (!src || !dst) {
+		printf("Cannot allocate buffers of %#lx bytes\n", size);
+		free(src);
+		free(dst);
+		return CMD_RET_FAILURE;
+	}
+	memset(src, 0xa5, size + MEM_BENCH_OVERLAP);
+
+	printf("%lu x %#lx bytes\n", loops, size);
+	for (i = 0; i < ARRAY_SIZE(mem_bench_copy); i++) {
+		if (size < mem_bench_copy[i].min_size) {
+			printf("%-12s skipped\n", mem_bench_copy[i].name);
+			continue;
+		}
+		start = timer_get_us();
+		for (n = 0; n < loops; n++)
+			mem_bench_copy[i].func(dst, src, size);
+		mem_bench_show(mem_bench_copy[i].name, size, loops, start);
+	}
+	for (i = 0; i < ARRAY_SIZE(mem_bench_set); i++) {
+		if (size < mem_bench_set[i].min_size) {
+			printf("%-12s skipped\n", mem_bench_set[i].name);
+			continue;
+		}
+		start = timer_get_us();
+		for (n = 0; n < loops; n++)
+			mem_bench_set[i].func(dst, n, size);
+		mem_bench_show(mem_bench_set[i].name, size, loops, start);
+	}
+
+	free(src);
+	free(dst);
+
+	return 0;
+}
+
+#endif /* CONFIG_CMD_MEM_BENCH */
+
 #ifdef CONFIG_CMD_MEMINFO
 __weak void board_show_dram(phys_size_t size)
 {
@@ -1243,6 +1345,16 @@ U_BOOT_CMD(
 );
 #endif /* CONFIG_MX_CYCLIC */
 
+#ifdef CONFIG_CMD_MEM_BENCH
+U_BOOT_CMD(
+	membench,	2,	0,	do_mem_bench,
+	"measure memcpy, memmove and memset bandwidth",
+	"[size]\n"
+	"    - measure each implementation on 'size' bytes (hex, default\n"
+	"      0x100000). The NEON versions are skipped below 64 bytes."
+);
+#endif /* CONFIG_CMD_MEM_BENCH */
+
 #ifdef CONFIG_CMD_MEMINFO
 U_BOOT_CMD(
 	meminfo,	3,	1,	do_mem_info,
@@ -10,6 +10,7 @@
 #include <mmc.h>
 #include <sparse_format.h>
 #include <image-sparse.h>
+#include <linux/math64.h>
 
 static int curr_device = -1;
 
@@ -317,6 +318,61 @@ static int do_mmc_read(cmd_tbl_t *cmdtp, int flag,
 	return (n == cnt) ? CMD_RET_SUCCESS : CMD_RET_FAILURE;
 }
 
+/*
+ * Read the same blocks in transfers of one block, two blocks, four blocks
+ * and so on up to all of them, showing the throughput for each size
+ */
+static int do_mmc_bench(cmd_tbl_t *cmdtp, int flag,
+			int argc, char * const argv[])
+{
+	struct blk_desc *desc;
+	struct mmc *mmc;
+	u32 blk, cnt, size, done, n;
+	ulong start, time;
+	void *addr;
+
+	if (argc != 4)
+		return CMD_RET_USAGE;
+
+	addr = (void *)simple_strtoul(argv[1], NULL, 16);
+	blk = simple_strtoul(argv[2], NULL, 16);
+	cnt = simple_strtoul(argv[3], NULL, 16);
+
+	mmc = init_mmc_device(curr_device, false);
+	if (!mmc)
+		return CMD_RET_FAILURE;
+	desc = mmc_get_blk_desc(mmc);
+
+	printf("MMC bench: dev # %d, block # %d, count %d\n", curr_device,
+	       blk, cnt);
+	for (size = 1; size <= cnt; size *= 2) {
+		start = timer_get_us();
+		for (done = 0; done < cnt; done += n) {
+			n = min(size, cnt - done);
+			if (blk_dread(desc, blk + done, n,
+				      addr + done * desc->blksz) != n) {
+				printf("Read failed at block # %d\n",
+				       blk + done);
+				return CMD_RET_FAILURE;
+			}
+			if (ctrlc())
+				return CMD_RET_FAILURE;
+		}
+		time = timer_get_us() - start;
+
+		printf("%8d blocks per read: %10lu us", size, time);
+		if (time > 0) {
+			puts(" (");
+			print_size(div_u64((u64)cnt * desc->blksz * 1000000,
+					   time), "/s");
+			puts(")");
+		}
+		puts("\n");
+	}
+
+	return CMD_RET_SUCCESS;
+}
+
 #if CONFIG_IS_ENABLED(CMD_MMC_SWRITE)
 static lbaint_t mmc_sparse_write(struct sparse_storage *info, lbaint_t blk,
 				 lbaint_t blkcnt, const void *buffer)
@@ -875,6 +931,7 @@ static int do_mmc_bkops_enable(cmd_tbl_t *cmdtp, int flag,
 static cmd_tbl_t cmd_mmc[] = {
 	U_BOOT_CMD_MKENT(info, 1, 0, do_mmcinfo, "", ""),
 	U_BOOT_CMD_MKENT(read, 4, 1, do_mmc_read, "", ""),
+	U_BOOT_CMD_MKENT(bench, 4, 0, do_mmc_bench, "", ""),
 #if CONFIG_IS_ENABLED(MMC_WRITE)
 	U_BOOT_CMD_MKENT(write, 4, 0, do_mmc_write, "", ""),
 	U_BOOT_CMD_MKENT(erase, 3, 0, do_mmc_erase, "", ""),
@@ -935,6 +992,8 @@ U_BOOT_CMD(
 	"MMC sub system",
 	"info - display info of the current MMC device\n"
 	"mmc read addr blk# cnt\n"
+	"mmc bench addr blk# cnt - show read throughput for transfer sizes\n"
+	"    from one block up to cnt\n"
 	"mmc write addr blk# cnt\n"
 #if CONFIG_IS_ENABLED(CMD_MMC_SWRITE)
 	"mmc swrite addr blk#\n"
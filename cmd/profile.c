@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Control the sampling profiler
+ */
+
+#include <common.h>
+#include <command.h>
+#include <mapmem.h>
+#include <profile.h>
+
+static int do_profile_start(cmd_tbl_t *cmdtp, int flag, int argc,
+			    char * const argv[])
+{
+	uint rate = CONFIG_PROFILE_RATE;
+	int ret;
+
+	if (argc > 1)
+		rate = simple_strtoul(argv[1], NULL, 10);
+	ret = profile_start(rate);
+	if (ret) {
+		printf("Cannot start profiler (err=%d)\n", ret);
+		return CMD_RET_FAILURE;
+	}
+
+	return 0;
+}
+
+static int do_profile_stop(cmd_tbl_t *cmdtp, int flag, int argc,
+			   char * const argv[])
+{
+	profile_stop();
+
+	return 0;
+}
+
+static int do_profile_report(cmd_tbl_t *cmdtp, int flag, int argc,
+			     char * const argv[])
+{
+	int count = 20;
+	int ret;
+
+	if (argc > 1)
+		count = simple_strtol(argv[1], NULL, 10);
+	profile_stop();
+	ret = profile_report(count);
+	if (ret == -ENOENT) {
+		printf("No samples\n");
+		return CMD_RET_FAILURE;
+	} else if (ret) {
+		printf("Cannot create report (err=%d)\n", ret);
+		return CMD_RET_FAILURE;
+	}
+
+	return 0;
+}
+
+/* Arguments work as for 'trace calls', see cmd/trace.c */
+static int do_profile_dump(cmd_tbl_t *cmdtp, int flag, int argc,
+			   char * const argv[])
+{
+	size_t buff_size, buff_ptr;
+	unsigned int needed;
+	char *buff;
+
+	if (argc == 2 || argc > 3)
+		return CMD_RET_USAGE;
+	if (argc < 3) {
+		buff_size = env_get_ulong("profsize", 16, 0);
+		buff = map_sysmem(env_get_ulong("profbase", 16, 0), buff_size);
+		buff_ptr = env_get_ulong("profoffset", 16, 0);
+	} else {
+		buff_size = simple_strtoul(argv[2], NULL, 16);
+		buff = map_sysmem(simple_strtoul(argv[1], NULL, 16),
+				  buff_size);
+		buff_ptr = 0;
+	}
+	if (buff_ptr > buff_size)
+		return CMD_RET_USAGE;
+
+	profile_stop();
+	if (profile_list_samples(buff + buff_ptr, buff_size - buff_ptr,
+				 &needed)) {
+		printf("Error: buffer too small (%#x bytes needed)\n", needed);
+		return CMD_RET_FAILURE;
+	}
+	printf("Samples dumped to %08lx, size %#x\n",
+	       (ulong)map_to_sysmem(buff + buff_ptr), needed);
+	env_set_hex("profbase", map_to_sysmem(buff));
+	env_set_hex("profsize", buff_size);
+	env_set_hex("profoffset", buff_ptr + needed);
+
+	return 0;
+}
+
+static cmd_tbl_t cmd_profile_sub[] = {
+	U_BOOT_CMD_MKENT(start, 2, 0, do_profile_start, "", ""),
+	U_BOOT_CMD_MKENT(stop, 1, 0, do_profile_stop, "", ""),
+	U_BOOT_CMD_MKENT(report, 2, 0, do_profile_report, "", ""),
+	U_BOOT_CMD_MKENT(dump, 3, 0, do_profile_dump, "", ""),
+};
+
+static int do_profile(cmd_tbl_t *cmdtp, int flag, int argc,
+		      char * const argv[])
+{
+	cmd_tbl_t *cp;
+
+	if (argc < 2)
+		return CMD_RET_USAGE;
+	cp = find_cmd_tbl(argv[1], cmd_profile_sub,
+			  ARRAY_SIZE(cmd_profile_sub));
+	argc--;
+	argv++;
+	if (!cp || argc > cp->maxargs)
+		return CMD_RET_USAGE;
+
+	return cp->cmd(cmdtp, flag, argc, argv);
+}
+
+U_BOOT_CMD(
+	profile, 4, 0, do_profile,
+	"sampling profiler",
+	"start [<rate>]        - start taking <rate> samples per second\n"
+	"profile stop                  - stop taking samples\n"
+	"profile report [<count>]      - stop, and show the <count> functions\n"
+	"                                with most samples (0 for all)\n"
+	"profile dump [<addr> <size>]  - stop, and dump the samples into a\n"
+	"                                buffer for tools/proftool"
+);
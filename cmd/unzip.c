@@ -6,6 +6,9 @@
 
 #include <common.h>
 #include <command.h>
+#include <asm/unaligned.h>
+
+#define ZSTD_MAGIC	0xfd2fb528
 
 static int do_unzip(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 {
@@ -24,8 +27,20 @@ static int do_unzip(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 			return CMD_RET_USAGE;
 	}
 
-	if (gunzip((void *) dst, dst_len, (void *) src, &src_len) != 0)
+	if (IS_ENABLED(CONFIG_ZSTD) &&
+	    get_unaligned_le32((void *)src) == ZSTD_MAGIC) {
+		size_t size = dst_len;
+		int ret;
+
+		ret = zstd_decompress((void *)src, src_len, (void *)dst, &size);
+		if (ret) {
+			printf("Error: zstd returned %d\n", ret);
+			return 1;
+		}
+		src_len = size;
+	} else if (gunzip((void *) dst, dst_len, (void *) src, &src_len) != 0) {
 		return 1;
+	}
 
 	printf("Uncompressed size: %lu = 0x%lX\n", src_len, src_len);
 	env_set_hex("filesize", src_len);
@@ -35,7 +50,7 @@ static int do_unzip(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 
 U_BOOT_CMD(
 	unzip,	4,	1,	do_unzip,
-	"unzip a memory region",
+	"unzip a memory region (gzip, or zstd if enabled)",
 	"srcaddr dstaddr [dstsize]"
 );
 
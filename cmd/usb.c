@@ -18,6 +18,7 @@
 #include <memalign.h>
 #include <asm/byteorder.h>
 #include <asm/unaligned.h>
+#include <linux/math64.h>
 #include <part.h>
 #include <usb.h>
 
@@ -631,6 +632,48 @@ static void usb_show_info(struct usb_device *udev)
 /******************************************************************************
  * usb command intepreter
  */
+#ifdef CONFIG_USB_STORAGE
+/* Time a read from the current storage device, to measure throughput */
+static int do_usb_bench(int argc, char * const argv[])
+{
+	struct blk_desc *desc;
+	ulong addr, cnt, n, start, time;
+	lbaint_t blk;
+	u64 len;
+
+	if (argc != 5)
+		return CMD_RET_USAGE;
+	addr = simple_strtoul(argv[2], NULL, 16);
+	blk = simple_strtoul(argv[3], NULL, 16);
+	cnt = simple_strtoul(argv[4], NULL, 16);
+
+	desc = blk_get_devnum_by_type(IF_TYPE_USB, usb_stor_curr_dev);
+	if (!desc) {
+		printf("No USB storage device selected\n");
+		return CMD_RET_FAILURE;
+	}
+
+	start = get_timer(0);
+	n = blk_dread(desc, blk, cnt, (void *)addr);
+	time = get_timer(start);
+	if (n != cnt) {
+		printf("Read failed after %lu blocks\n", n);
+		return CMD_RET_FAILURE;
+	}
+
+	len = (u64)n * desc->blksz;
+	printf("%llu bytes read in %lu ms", len, time);
+	if (time > 0) {
+		puts(" (");
+		print_size(div_u64(len, time) * 1000, "/s");
+		puts(")");
+	}
+	puts("\n");
+
+	return 0;
+}
+#endif
+
 static int do_usb(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 {
 	struct usb_device *udev = NULL;
@@ -723,6 +766,8 @@ static int do_usb(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 #ifdef CONFIG_USB_STORAGE
 	if (strncmp(argv[1], "stor", 4) == 0)
 		return usb_stor_info();
+	if (strcmp(argv[1], "bench") == 0)
+		return do_usb_bench(argc, argv);
 
 	return blk_common_cmd(argc, argv, IF_TYPE_USB, &usb_stor_curr_dev);
 #else
@@ -749,7 +794,9 @@ U_BOOT_CMD(
 	"usb read addr blk# cnt - read `cnt' blocks starting at block `blk#'\n"
 	"    to memory address `addr'\n"
 	"usb write addr blk# cnt - write `cnt' blocks starting at block `blk#'\n"
-	"    from memory address `addr'"
+	"    from memory address `addr'\n"
+	"usb bench addr blk# cnt - read `cnt' blocks starting at block `blk#'\n"
+	"    to memory address `addr' and show the throughput"
 #endif /* CONFIG_USB_STORAGE */
 );
 
@@ -692,6 +692,8 @@ static int reloc_bloblist(void)
 		      gd->bloblist, gd->new_bloblist, size);
 		memcpy(gd->new_bloblist, gd->bloblist, size);
 		gd->bloblist = gd->new_bloblist;
+		/* The hand-off information has moved too */
+		setup_spl_handoff();
 	}
 #endif
 
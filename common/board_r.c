@@ -153,6 +153,10 @@ static int initr_reloc_global_data(void)
 	 */
 	gd->fdt_blob += gd->reloc_off;
 #endif
+#if CONFIG_IS_ENABLED(OF_INDEX)
+	/* The driver index was built in the pre-relocation malloc() area */
+	gd->of_index = NULL;
+#endif
 #ifdef CONFIG_EFI_LOADER
 	efi_runtime_relocate(gd->relocaddr, NULL);
 #endif
@@ -399,6 +403,15 @@ static int initr_onenand(void)
 }
 #endif
 
+#ifdef CONFIG_MMC_ASYNC_INIT
+static int initr_mmc_start(void)
+{
+	/* Let the cards power up while the rest of the board is set up */
+	mmc_start_async_init(gd->bd);
+	return 0;
+}
+#endif
+
 #ifdef CONFIG_MMC
 static int initr_mmc(void)
 {
@@ -718,6 +731,9 @@ static init_fnc_t init_sequence_r[] = {
 	arch_early_init_r,
 #endif
 	power_init_board,
+#ifdef CONFIG_MMC_ASYNC_INIT
+	initr_mmc_start,
+#endif
 #ifdef CONFIG_MTD_NOR_FLASH
 	initr_flash,
 #endif
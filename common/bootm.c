@@ -13,6 +13,7 @@
 #include <lmb.h>
 #include <malloc.h>
 #include <mapmem.h>
+#include <serial.h>
 #include <asm/io.h>
 #include <linux/lzo.h>
 #include <lzma/LzmaTypes.h>
@@ -352,9 +353,176 @@ static int handle_decomp_error(int comp_type, size_t uncomp_size,
 	return BOOTM_ERR_RESET;
 }
 
-int bootm_decomp_image(int comp, ulong load, ulong image_start, int type,
-		       void *load_buf, void *image_buf, ulong image_len,
-		       uint unc_len, ulong *load_end)
+static ulong get_le32(const uint8_t *p)
+{
+	return p[0] | p[1] << 8 | p[2] << 16 | (ulong)p[3] << 24;
+}
+
+/**
+ * bootm_decomp_get_size() - find the uncompressed size of an image
+ *
+ * This looks at the headers / trailers of the compressed stream only, it
+ * does not decompress anything. For LZ4 frames without a content size, an
+ * upper bound is calculated from the sizes of the blocks in the frame.
+ *
+ * @comp:	Compression type being used (IH_COMP_...)
+ * @buf:	Compressed data
+ * @len:	Length of compressed data in bytes
+ * @return uncompressed size (or upper bound) in bytes, 0 if unknown
+ */
+static ulong bootm_decomp_get_size(int comp, const uint8_t *buf, ulong len)
+{
+	switch (comp) {
+	case IH_COMP_GZIP:
+		/* ISIZE: size modulo 2^32 in the last four bytes */
+		if (len < 18 || buf[0] != 0x1f || buf[1] != 0x8b)
+			return 0;
+		return get_le32(buf + len - 4);
+	case IH_COMP_LZMA:
+		/* 5 bytes of properties, then the 64-bit size (~0 if unknown) */
+		if (len < 13 || get_le32(buf + 9))
+			return 0;
+		return get_le32(buf + 5);
+	case IH_COMP_LZ4: {
+		const uint8_t *end = buf + len;
+		ulong max_block, size = 0;
+		uint8_t flags;
+
+		if (len < 7 || get_le32(buf) != 0x184d2204)
+			return 0;
+		flags = buf[4];
+		if (flags & 0x08)	/* content size present */
+			return get_le32(buf + 10) ? 0 : get_le32(buf + 6);
+		max_block = 1UL << (8 + 2 * ((buf[5] >> 4) & 7));
+		for (buf += 7; buf + 4 <= end; ) {
+			ulong raw = get_le32(buf);
+			ulong bsize = raw & 0x7fffffff;
+
+			if (!bsize)		/* end mark */
+				return size;
+			/* LZ4 cannot expand by more than 255:1 */
+			if (raw & 0x80000000)	/* stored uncompressed */
+				size += bsize;
+			else if (bsize << 8 < max_block)
+				size += bsize << 8;
+			else
+				size += max_block;
+			buf += 4 + bsize + (flags & 0x10 ? 4 : 0);
+		}
+		return 0;
+	}
+	case IH_COMP_ZSTD: {
+		static const uint8_t fcs_size[] = { 0, 2, 4, 8 };
+		static const uint8_t did_size[] = { 0, 1, 2, 4 };
+		uint8_t fhd;
+		ulong pos, size = 0;
+		int i, n;
+
+		if (len < 6 || get_le32(buf) != 0xfd2fb528)
+			return 0;
+		fhd = buf[4];
+		n = fcs_size[fhd >> 6];
+		if (!n && (fhd & 0x20))		/* single segment */
+			n = 1;
+		pos = 5 + !(fhd & 0x20) + did_size[fhd & 3];
+		if (!n || pos + n > len || (n == 8 && get_le32(buf + pos + 4)))
+			return 0;
+		for (i = n - 1; i >= 0; i--)
+			size = size << 8 | buf[pos + i];
+		return n == 2 ? size + 256 : size;
+	}
+	default:
+		return 0;
+	}
+}
+
+/**
+ * bootm_decomp_margin() - get the margin needed for in-place decompression
+ *
+ * The gzip, LZMA, LZ4 and Zstandard decoders read their input and write
+ * their output strictly forwards, so the output may overlap the input
+ * provided that the input ends far enough beyond the end of the output that
+ * the writer can never catch up with the reader. The margins below cover
+ * the worst-case expansion of each format plus its look-ahead, following
+ * what Linux uses for its self-decompressing kernels. Zstandard reads each
+ * block in full before its output is complete, so it needs a whole block
+ * (128KB) plus the per-block overhead, as given by
+ * ZSTD_DECOMPRESSION_MARGIN() upstream.
+ *
+ * @comp:	Compression type being used (IH_COMP_...)
+ * @size:	Uncompressed size in bytes
+ * @return margin in bytes, or 0 if the format cannot be decompressed in place
+ */
+static ulong bootm_decomp_margin(int comp, ulong size)
+{
+	switch (comp) {
+	case IH_COMP_GZIP:
+		return (size >> 12) + 32768 + 18;
+	case IH_COMP_LZMA:
+		return (size >> 12) + 65536 + 128;
+	case IH_COMP_LZ4:
+		return (size >> 8) + 64;
+	case IH_COMP_ZSTD:
+		return (size >> 17) * 3 + (128 << 10) + 32;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * bootm_decomp_check_overlap() - check whether an image can be decompressed
+ *
+ * Decompressing to an area which overlaps the compressed data is allowed if
+ * the compressed data sits at the end of the area, with enough margin after
+ * the end of the uncompressed data. This allows an image to be loaded close
+ * to its final address and decompressed without copying it out of the way.
+ *
+ * If the uncompressed size cannot be determined, or the format does not
+ * support in-place decompression, no check is done.
+ *
+ * @comp:	Compression type being used (IH_COMP_...)
+ * @load:	Destination load address
+ * @image_start: Address of the compressed data
+ * @image_buf:	Compressed data
+ * @image_len:	Length of the compressed data in bytes
+ * @return 0 if there is no overlap (or it cannot be checked), 1 if the areas
+ *	overlap and the image can be decompressed in place, BOOTM_ERR_OVERLAP
+ *	if the areas overlap in a way which would corrupt the image
+ */
+static int bootm_decomp_check_overlap(int comp, ulong load, ulong image_start,
+				      const void *image_buf, ulong image_len)
+{
+	ulong image_end = image_start + image_len;
+	ulong size, margin;
+
+	if (comp == IH_COMP_NONE)
+		return 0;
+
+	size = bootm_decomp_get_size(comp, image_buf, image_len);
+	margin = bootm_decomp_margin(comp, size);
+	if (!size || !margin)
+		return 0;
+	if (load >= image_end || load + size <= image_start)
+		return 0;
+
+	if (image_start >= load && image_end >= load + size + margin) {
+		debug("   decompressing in place, margin %lx\n",
+		      image_end - load - size);
+		return 1;
+	}
+
+	printf("Image at %08lx..%08lx overlaps load area %08lx..%08lx\n",
+	       image_start, image_end, load, load + size);
+	printf("For in-place decompression it must end at or above %08lx\n",
+	       load + size + margin);
+
+	return BOOTM_ERR_OVERLAP;
+}
+
+/* Decompress an image, once bootm_decomp_check_overlap() has allowed it */
+static int decomp_image(int comp, ulong load, ulong image_start, int type,
+			void *load_buf, void *image_buf, ulong image_len,
+			uint unc_len, ulong *load_end)
 {
 	int ret = 0;
 
@@ -425,6 +593,15 @@ int bootm_decomp_image(int comp, ulong load, ulong image_start, int type,
 		break;
 	}
 #endif /* CONFIG_LZ4 */
+#ifdef CONFIG_ZSTD
+	case IH_COMP_ZSTD: {
+		size_t size = unc_len;
+
+		ret = zstd_decompress(image_buf, image_len, load_buf, &size);
+		image_len = size;
+		break;
+	}
+#endif /* CONFIG_ZSTD */
 	default:
 		printf("Unimplemented compression type %d\n", comp);
 		return BOOTM_ERR_UNIMPLEMENTED;
@@ -439,6 +616,22 @@ int bootm_decomp_image(int comp, ulong load, ulong image_start, int type,
 	return 0;
 }
 
+int bootm_decomp_image(int comp, ulong load, ulong image_start, int type,
+		       void *load_buf, void *image_buf, ulong image_len,
+		       uint unc_len, ulong *load_end)
+{
+	int ret;
+
+	*load_end = load;
+	ret = bootm_decomp_check_overlap(comp, load, image_start, image_buf,
+					 image_len);
+	if (ret < 0)
+		return ret;
+
+	return decomp_image(comp, load, image_start, type, load_buf,
+			    image_buf, image_len, unc_len, load_end);
+}
+
 #ifndef USE_HOSTCC
 static int bootm_load_os(bootm_headers_t *images, int boot_progress)
 {
@@ -453,13 +646,24 @@ static int bootm_load_os(bootm_headers_t *images, int boot_progress)
 	ulong flush_len;
 	bool no_overlap;
 	void *load_buf, *image_buf;
+	int inplace;
 	int err;
 
 	load_buf = map_sysmem(load, 0);
 	image_buf = map_sysmem(os.image_start, image_len);
-	err = bootm_decomp_image(os.comp, load, os.image_start, os.type,
-				 load_buf, image_buf, image_len,
-				 CONFIG_SYS_BOOTM_LEN, &load_end);
+	inplace = bootm_decomp_check_overlap(os.comp, load, image_start,
+					     image_buf, image_len);
+	if (inplace < 0) {
+		/*
+		 * Nothing has been loaded, so do_bootm_states() must not carry
+		 * on as it does for BOOTM_ERR_OVERLAP from the check below
+		 */
+		bootstage_error(BOOTSTAGE_ID_DECOMP_IMAGE);
+		return -EFAULT;
+	}
+	err = decomp_image(os.comp, load, os.image_start, os.type, load_buf,
+			   image_buf, image_len, CONFIG_SYS_BOOTM_LEN,
+			   &load_end);
 	if (err) {
 		bootstage_error(BOOTSTAGE_ID_DECOMP_IMAGE);
 		return err;
@@ -476,6 +680,20 @@ static int bootm_load_os(bootm_headers_t *images, int boot_progress)
 
 	no_overlap = (os.comp == IH_COMP_NONE && load == image_start);
 
+	/*
+	 * After in-place decompression only the compressed image itself has
+	 * been overwritten, so check against the remainder of the blob
+	 */
+	if (inplace > 0) {
+		ulong head_end = min(image_start, blob_end);
+		ulong tail_start = max(image_start + image_len, blob_start);
+
+		no_overlap = (head_end <= blob_start || load >= head_end ||
+			      load_end <= blob_start) &&
+			     (tail_start >= blob_end || load >= blob_end ||
+			      load_end <= tail_start);
+	}
+
 	if (!no_overlap && load < blob_end && load_end > blob_start) {
 		debug("images.os.start = 0x%lX, images.os.end = 0x%lx\n",
 		      blob_start, blob_end);
@@ -726,9 +944,13 @@ int do_bootm_states(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
 	}
 
 	/* Now run the OS! We hope this doesn't return */
-	if (!ret && (states & BOOTM_STATE_OS_GO))
+	if (!ret && (states & BOOTM_STATE_OS_GO)) {
+#if CONFIG_IS_ENABLED(DM_SERIAL)
+		serial_flush();
+#endif
 		ret = boot_selected_os(argc, argv, BOOTM_STATE_OS_GO,
 				images, boot_fn);
+	}
 
 	/* Deal with any fallout */
 err:
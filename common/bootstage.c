@@ -24,6 +24,7 @@ struct bootstage_record {
 	ulong time_us;
 	uint32_t start_us;
 	const char *name;
+	ulong addr;		/* initcall address, see BOOTSTAGEF_INITCALL */
 	int flags;		/* see enum bootstage_flags */
 	enum bootstage_id id;
 };
@@ -38,6 +39,7 @@ enum {
 	BOOTSTAGE_VERSION	= 0,
 	BOOTSTAGE_MAGIC		= 0xb00757a3,
 	BOOTSTAGE_DIGITS	= 9,
+	BOOTSTAGE_JSON_VERSION	= 1,
 };
 
 struct bootstage_hdr {
@@ -195,6 +197,71 @@ uint32_t bootstage_accum(enum bootstage_id id)
 	return duration;
 }
 
+/**
+ * Add to the time of an accumulated record, creating it if needed
+ *
+ * Records are matched by @name, or by @addr if @name is NULL, in which case
+ * the record is an initcall and is only named when it is reported.
+ *
+ * @param data		Bootstage data
+ * @param name		Name of the record, or NULL
+ * @param addr		Address of the initcall, if @name is NULL
+ * @param start_us	Start time of this iteration
+ * @param duration	Time taken by this iteration
+ */
+static void accum_record(struct bootstage_data *data, const char *name,
+			 ulong addr, uint32_t start_us, uint32_t duration)
+{
+	struct bootstage_record *rec, *end;
+
+	for (rec = data->record, end = rec + data->rec_count; rec < end;
+	     rec++) {
+		if (!rec->start_us)
+			continue;
+		if (name && rec->name &&
+		    (rec->name == name || !strcmp(rec->name, name)))
+			break;
+		if (!name && (rec->flags & BOOTSTAGEF_INITCALL) &&
+		    rec->addr == addr)
+			break;
+	}
+	if (rec == end) {
+		if (data->rec_count == RECORD_COUNT)
+			return;
+		rec = &data->record[data->rec_count++];
+		rec->id = data->next_id++;
+		rec->name = name;
+		rec->addr = addr;
+		rec->flags = name ? 0 : BOOTSTAGEF_INITCALL;
+		rec->time_us = 0;
+	}
+
+	/* A non-zero start time marks this as an accumulated record */
+	rec->start_us = start_us ? start_us : 1;
+	rec->time_us += duration;
+}
+
+uint32_t bootstage_accum_name(const char *name, uint32_t start_us)
+{
+	struct bootstage_data *data = gd->bootstage;
+	uint32_t duration = (uint32_t)timer_get_boot_us() - start_us;
+
+	/* Before bootstage_init() there is nowhere to record anything */
+	if (data)
+		accum_record(data, name, 0, start_us, duration);
+
+	return duration;
+}
+
+void bootstage_accum_initcall(ulong addr, uint32_t start_us,
+			      uint32_t duration)
+{
+	struct bootstage_data *data = gd->bootstage;
+
+	if (data)
+		accum_record(data, NULL, addr, start_us, duration);
+}
+
 /**
  * Get a record name as a printable string
  *
@@ -208,17 +275,29 @@ static const char *get_record_name(char *buf, int len,
 {
 	if (rec->name)
 		return rec->name;
-	else if (rec->id >= BOOTSTAGE_ID_USER)
+
+	if (rec->flags & BOOTSTAGEF_INITCALL) {
+#ifdef CONFIG_KALLSYMS
+		const char *name;
+		ulong base;
+
+		name = symbol_lookup(rec->addr, &base);
+		if (name)
+			return name;
+#endif
+		snprintf(buf, len, "initcall %08lx", rec->addr);
+	} else if (rec->id >= BOOTSTAGE_ID_USER) {
 		snprintf(buf, len, "user_%d", rec->id - BOOTSTAGE_ID_USER);
-	else
+	} else {
 		snprintf(buf, len, "id=%d", rec->id);
+	}
 
 	return buf;
 }
 
 static uint32_t print_time_record(struct bootstage_record *rec, uint32_t prev)
 {
-	char buf[20];
+	char buf[30];
 
 	if (prev == -1U) {
 		printf("%11s", "");
@@ -250,7 +329,7 @@ static int add_bootstages_devicetree(struct fdt_header *blob)
 {
 	struct bootstage_data *data = gd->bootstage;
 	int bootstage;
-	char buf[20];
+	char buf[30];
 	int recnum;
 	int i;
 
@@ -363,7 +442,7 @@ int bootstage_stash(void *base, int size)
 	const struct bootstage_data *data = gd->bootstage;
 	struct bootstage_hdr *hdr = (struct bootstage_hdr *)base;
 	const struct bootstage_record *rec;
-	char buf[20];
+	char buf[30];
 	char *ptr = base, *end = ptr + size;
 	uint32_t count;
 	int i;
@@ -413,6 +492,92 @@ int bootstage_stash(void *base, int size)
 	return 0;
 }
 
+/**
+ * Append text to a memory buffer, as much as fits
+ *
+ * This is like append_data() except that the text is cut short at the end
+ * of the buffer, so that the output is truncated like snprintf().
+ *
+ * @param ptrp	Pointer to buffer, updated by this function
+ * @param end	Pointer to end of buffer
+ * @param text	Text to write to buffer
+ * @param len	Number of characters to write
+ */
+static void append_text(char **ptrp, char *end, const char *text, int len)
+{
+	char *ptr = *ptrp;
+
+	*ptrp += len;
+	if (ptr < end)
+		memcpy(ptr, text, min_t(long, len, end - ptr));
+}
+
+/**
+ * Append a string to a memory buffer, quoted and escaped for JSON
+ *
+ * See append_text() for how the buffer pointer is handled.
+ *
+ * @param ptrp	Pointer to buffer, updated by this function
+ * @param end	Pointer to end of buffer
+ * @param str	String to write to buffer
+ */
+static void append_json_string(char **ptrp, char *end, const char *str)
+{
+	char esc[7];
+
+	append_text(ptrp, end, "\"", 1);
+	for (; *str; str++) {
+		if (*str == '"' || *str == '\\') {
+			esc[0] = '\\';
+			esc[1] = *str;
+			append_text(ptrp, end, esc, 2);
+		} else if ((uchar)*str < 0x20) {
+			snprintf(esc, sizeof(esc), "\\u%04x", (uchar)*str);
+			append_text(ptrp, end, esc, 6);
+		} else {
+			append_text(ptrp, end, str, 1);
+		}
+	}
+	append_text(ptrp, end, "\"", 1);
+}
+
+int bootstage_export_json(char *buf, int size)
+{
+	const struct bootstage_data *data = gd->bootstage;
+	const struct bootstage_record *rec;
+	char *ptr = buf, *end = buf + size;
+	char tmp[40];
+	bool first = true;
+	int i, len;
+
+	len = snprintf(tmp, sizeof(tmp), "{\"version\":%d,\"records\":[",
+		       BOOTSTAGE_JSON_VERSION);
+	append_text(&ptr, end, tmp, len);
+
+	for (rec = data->record, i = 0; i < data->rec_count; i++, rec++) {
+		if (rec->id != BOOTSTAGE_ID_AWAKE && rec->time_us == 0)
+			continue;
+
+		len = snprintf(tmp, sizeof(tmp), "%s\n{\"id\":%d,\"name\":",
+			       first ? "" : ",", rec->id);
+		append_text(&ptr, end, tmp, len);
+		append_json_string(&ptr, end,
+				   get_record_name(tmp, sizeof(tmp), rec));
+		len = snprintf(tmp, sizeof(tmp), ",\"%s\":%lu}",
+			       rec->start_us ? "accum" : "mark", rec->time_us);
+		append_text(&ptr, end, tmp, len);
+		first = false;
+	}
+	append_text(&ptr, end, "\n]}\n", 4);
+
+	/* Terminate the string if there is space, like snprintf() */
+	len = ptr - buf;
+	if (ptr < end)
+		*ptr = '\0';
+
+	return len;
+}
+
 int bootstage_unstash(const void *base, int size)
 {
 	const struct bootstage_hdr *hdr = (struct bootstage_hdr *)base;
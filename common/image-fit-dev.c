@@ -0,0 +1,313 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * On-demand loading of FIT images stored on a block or SPI flash device
+ *
+ * Only the FIT structure is read first. Once the configuration has been
+ * resolved, the external data of the referenced subimages is read into
+ * place, so that the in-memory copy can be handled by bootm, fpga etc. as
+ * if the whole image had been loaded.
+ */
+
+#include <common.h>
+#include <blk.h>
+#include <errno.h>
+#include <image.h>
+#include <lmb.h>
+#include <mapmem.h>
+#include <memalign.h>
+#include <part.h>
+#include <spi.h>
+#include <spi_flash.h>
+#include <linux/libfdt.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/**
+ * struct fit_dev_info - describes the device a FIT is read from
+ *
+ * @read:	Read @size bytes at byte offset @offset (relative to the start
+ *		of the FIT) to @buf. Returns 0 on success.
+ * @offset:	Byte offset of the FIT on the device
+ * @space:	Number of bytes which may be written at the load address
+ * @desc:	Block device descriptor, for block devices
+ * @start:	First block of the partition, for block devices
+ * @flash:	SPI flash device, for "sf"
+ */
+struct fit_dev_info {
+	int (*read)(struct fit_dev_info *info, ulong offset, ulong size,
+		    void *buf);
+	ulong offset;
+	ulong space;
+	struct blk_desc *desc;
+	lbaint_t start;
+	struct spi_flash *flash;
+};
+
+static int fit_dev_blk_read(struct fit_dev_info *info, ulong offset,
+			    ulong size, void *buf)
+{
+	struct blk_desc *desc = info->desc;
+	ulong blksz = desc->blksz;
+	lbaint_t blk;
+	ulong skip, len, count;
+	char *dst = buf;
+
+	offset += info->offset;
+	blk = info->start + offset / blksz;
+	skip = offset % blksz;
+
+	/* Partial first block and short tail go through a bounce buffer */
+	if (skip || size < blksz) {
+		ALLOC_CACHE_ALIGN_BUFFER(char, tmp, desc->blksz);
+
+		while (size) {
+			if (!skip && size >= blksz)
+				break;
+			if (blk_dread(desc, blk, 1, tmp) != 1)
+				return -EIO;
+			len = min(size, blksz - skip);
+			memcpy(dst, tmp + skip, len);
+			dst += len;
+			size -= len;
+			skip = 0;
+			blk++;
+		}
+	}
+
+	count = size / blksz;
+	if (count) {
+		if (blk_dread(desc, blk, count, dst) != count)
+			return -EIO;
+		dst += count * blksz;
+		size -= count * blksz;
+		blk += count;
+	}
+
+	if (size) {
+		ALLOC_CACHE_ALIGN_BUFFER(char, tail, desc->blksz);
+
+		if (blk_dread(desc, blk, 1, tail) != 1)
+			return -EIO;
+		memcpy(dst, tail, size);
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_SPI_FLASH
+static int fit_dev_sf_read(struct fit_dev_info *info, ulong offset,
+			   ulong size, void *buf)
+{
+	return spi_flash_read(info->flash, info->offset + offset, size, buf);
+}
+
+static int fit_dev_sf_open(struct fit_dev_info *info, const char *dev_str)
+{
+	unsigned int bus = CONFIG_SF_DEFAULT_BUS;
+	unsigned int cs = CONFIG_SF_DEFAULT_CS;
+	char *endp;
+
+	if (dev_str && *dev_str && strcmp(dev_str, "-")) {
+		cs = simple_strtoul(dev_str, &endp, 0);
+		if (*endp == ':') {
+			bus = cs;
+			cs = simple_strtoul(endp + 1, &endp, 0);
+		}
+		if (*endp)
+			return -EINVAL;
+	}
+
+	info->flash = spi_flash_probe(bus, cs, CONFIG_SF_DEFAULT_SPEED,
+				      CONFIG_SF_DEFAULT_MODE);
+	if (!info->flash) {
+		printf("Failed to initialize SPI flash at %u:%u\n", bus, cs);
+		return -ENODEV;
+	}
+	info->read = fit_dev_sf_read;
+
+	return 0;
+}
+#endif
+
+static int fit_dev_open(struct fit_dev_info *info, const char *ifname,
+			const char *dev_part_str, ulong offset)
+{
+	disk_partition_t part;
+	int ret;
+
+	memset(info, '\0', sizeof(*info));
+	info->offset = offset;
+
+#ifdef CONFIG_SPI_FLASH
+	if (!strcmp(ifname, "sf"))
+		return fit_dev_sf_open(info, dev_part_str);
+#endif
+
+	ret = blk_get_device_part_str(ifname, dev_part_str, &info->desc,
+				      &part, 1);
+	if (ret < 0)
+		return -ENODEV;
+	info->start = part.start;
+	info->read = fit_dev_blk_read;
+
+	return 0;
+}
+
+/* Return the number of bytes which may be written at @addr */
+static ulong fit_dev_get_space(ulong addr)
+{
+#ifdef CONFIG_LMB
+	struct lmb lmb;
+
+	lmb_init_and_reserve(&lmb, gd->bd, (void *)gd->fdt_blob);
+
+	return lmb_get_free_size(&lmb, addr);
+#else
+	return gd->ram_top > addr ? gd->ram_top - addr : 0;
+#endif
+}
+
+static int fit_dev_load_image(struct fit_dev_info *info, void *fit,
+			      int noffset)
+{
+	const char *name = fit_get_name(fit, noffset, NULL);
+	ulong start;
+	int offset, size;
+
+	/* The FIT is not verified yet, so check where the data would go */
+	if (!fit_image_get_data_position(fit, noffset, &offset)) {
+		start = offset;
+	} else if (!fit_image_get_data_offset(fit, noffset, &offset)) {
+		start = ALIGN(fdt_totalsize(fit), 4) + offset;
+	} else {
+		/* Embedded data was read together with the FIT structure */
+		debug("%s: '%s' has embedded data\n", __func__, name);
+		return 0;
+	}
+
+	if (fit_image_get_data_size(fit, noffset, &size)) {
+		printf("Can't get size of '%s' subimage\n", name);
+		return -ENOENT;
+	}
+
+	if (offset < 0 || size < 0 || start > info->space ||
+	    size > info->space - start) {
+		printf("'%s' data (%d bytes at 0x%x) does not fit in memory\n",
+		       name, size, offset);
+		return -ENOSPC;
+	}
+
+	printf("   Reading '%s' (%d bytes at 0x%lx)\n", name, size, start);
+
+	return info->read(info, start, size, fit + start);
+}
+
+/* Configuration properties which reference images that must be loaded */
+static const char *const fit_dev_conf_props[] = {
+	FIT_KERNEL_PROP,
+	FIT_RAMDISK_PROP,
+	FIT_FDT_PROP,
+	FIT_LOADABLE_PROP,
+	FIT_SETUP_PROP,
+	FIT_FPGA_PROP,
+	FIT_FIRMWARE_PROP,
+	FIT_STANDALONE_PROP,
+};
+
+static int fit_dev_load_conf(struct fit_dev_info *info, void *fit,
+			     int cfg_noffset)
+{
+	int i, index, count, noffset, ret;
+
+	for (i = 0; i < ARRAY_SIZE(fit_dev_conf_props); i++) {
+		count = fit_conf_get_prop_node_count(fit, cfg_noffset,
+						     fit_dev_conf_props[i]);
+		for (index = 0; index < count; index++) {
+			noffset = fit_conf_get_prop_node_index(fit,
+					cfg_noffset, fit_dev_conf_props[i],
+					index);
+			if (noffset < 0)
+				return -ENOENT;
+			ret = fit_dev_load_image(info, fit, noffset);
+			if (ret)
+				return ret;
+		}
+	}
+
+	return 0;
+}
+
+int fit_dev_load(const char *ifname, const char *dev_part_str, ulong offset,
+		 ulong addr, const char *conf_uname, const char *image_uname)
+{
+	struct fit_dev_info info;
+	struct fdt_header *hdr;
+	void *fit;
+	int noffset, ret;
+
+	ret = fit_dev_open(&info, ifname, dev_part_str, offset);
+	if (ret)
+		return ret;
+
+	printf("## Reading FIT from %s %s at 0x%lx to %08lx ...\n", ifname,
+	       dev_part_str ? dev_part_str : "", offset, addr);
+
+	info.space = fit_dev_get_space(addr);
+	if (info.space < sizeof(*hdr)) {
+		printf("Cannot read FIT to reserved memory at %08lx\n", addr);
+		return -ENOSPC;
+	}
+
+	/* Read the header first to find out how large the structure is */
+	hdr = map_sysmem(addr, sizeof(*hdr));
+	ret = info.read(&info, 0, sizeof(*hdr), hdr);
+	unmap_sysmem(hdr);
+	if (ret)
+		return ret;
+
+	fit = map_sysmem(addr, 0);
+	if (fdt_check_header(fit) || fdt_totalsize(fit) < sizeof(*hdr)) {
+		puts("Bad FIT header\n");
+		return -ENOEXEC;
+	}
+
+	if (fdt_totalsize(fit) > info.space) {
+		printf("FIT structure (%u bytes) does not fit in memory\n",
+		       fdt_totalsize(fit));
+		return -ENOSPC;
+	}
+
+	ret = info.read(&info, sizeof(*hdr), fdt_totalsize(fit) - sizeof(*hdr),
+			fit + sizeof(*hdr));
+	if (ret)
+		return ret;
+
+	if (!fit_check_format(fit)) {
+		puts("Bad FIT image format\n");
+		return -ENOEXEC;
+	}
+
+	if (image_uname) {
+		noffset = fit_image_get_node(fit, image_uname);
+		if (noffset < 0) {
+			printf("Can't find '%s' FIT subimage\n", image_uname);
+			return -ENOENT;
+		}
+
+		return fit_dev_load_image(&info, fit, noffset);
+	}
+
+	if (IMAGE_ENABLE_BEST_MATCH && !conf_uname)
+		noffset = fit_conf_find_compat(fit, gd_fdt_blob());
+	else
+		noffset = fit_conf_get_node(fit, conf_uname);
+	if (noffset < 0) {
+		puts("Could not find configuration node\n");
+		return -ENOENT;
+	}
+
+	printf("   Using '%s' configuration\n", fit_get_name(fit, noffset,
+							     NULL));
+
+	return fit_dev_load_conf(&info, fit, noffset);
+}
@@ -45,3 +45,7 @@ void handoff_load_dram_banks(struct spl_handoff *ho)
 	}
 #endif
 }
+
+__weak void handoff_save_arch(struct spl_handoff *ho)
+{
+}
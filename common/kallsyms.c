@@ -6,10 +6,33 @@
  */
 
 #include <common.h>
+#include <hexdump.h>
 
 /* We need the weak marking as this symbol is provided specially */
 extern const char system_map[] __attribute__((weak));
 
+/* Each entry is the address, as a fixed number of hex digits (as printed by
+ * nm), followed directly by the name. The digits must be counted, since
+ * names may start with a hex digit too.
+ */
+static unsigned long symbol_addr(const char **symp)
+{
+	unsigned long addr = 0;
+	const char *sym = *symp;
+	int i, digit;
+
+	for (i = 0; i < sizeof(unsigned long) * 2; i++) {
+		digit = hex_to_bin(*sym);
+		if (digit < 0)
+			break;
+		addr = addr << 4 | digit;
+		sym++;
+	}
+	*symp = sym;
+
+	return addr;
+}
+
 /* Given an address, return a pointer to the symbol name and store
  * the base address in caddr.  So if the symbol map had an entry:
  *		03fb9b7c_spi_cs_deactivate
@@ -21,20 +44,43 @@ extern const char system_map[] __attribute__((weak));
  *		sym = "_spi_cs_deactivate";
  */
 const char *symbol_lookup(unsigned long addr, unsigned long *caddr)
+{
+	unsigned long next;
+
+	return symbol_lookup_range(addr, caddr, &next);
+}
+
+/* As symbol_lookup(), but also store the address of the following
+ * symbol in naddr (or ~0UL if there is none), so that callers looking up
+ * many addresses can tell which ones fall in the same symbol without
+ * walking the table again.
+ */
+const char *symbol_lookup_range(unsigned long addr, unsigned long *caddr,
+				unsigned long *naddr)
+{
+	return symbol_lookup_map(system_map, addr, caddr, naddr);
+}
+
+/* As symbol_lookup_range(), but in the given table rather than the builtin
+ * one, so that the table format can be tested.
+ */
+const char *symbol_lookup_map(const char *map, unsigned long addr,
+			      unsigned long *caddr, unsigned long *naddr)
 {
 	const char *sym, *csym;
-	char *esym;
 	unsigned long sym_addr;
 
-	sym = system_map;
+	sym = map;
 	csym = NULL;
 	*caddr = 0;
+	*naddr = ~0UL;
 
 	while (*sym) {
-		sym_addr = simple_strtoul(sym, &esym, 16);
-		sym = esym;
-		if (sym_addr > addr)
+		sym_addr = symbol_addr(&sym);
+		if (sym_addr > addr) {
+			*naddr = sym_addr;
 			break;
+		}
 		*caddr = sym_addr;
 		csym = sym;
 		sym += strlen(sym) + 1;
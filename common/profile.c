@@ -0,0 +1,235 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Statistical sampling profiler
+ *
+ * A periodic timer interrupt records the interrupted PC and LR in a ring
+ * buffer. Nothing is instrumented, so this works on production builds and
+ * the only overhead is the interrupt itself.
+ */
+
+#include <common.h>
+#include <malloc.h>
+#include <profile.h>
+#include <trace.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+struct profile_ent {
+	ulong pc;
+	ulong lr;
+};
+
+/**
+ * struct profile_state - State of the profiler
+ *
+ * @samples:	Ring buffer of CONFIG_PROFILE_SAMPLES samples, allocated on
+ *		first use
+ * @head:	Index of the next sample to write
+ * @total:	Number of samples taken, which may be more than the buffer
+ *		holds
+ * @rate:	Number of samples per second
+ * @running:	true if the timer is running
+ */
+static struct profile_state {
+	struct profile_ent *samples;
+	uint head;
+	ulong total;
+	uint rate;
+	bool running;
+} prof;
+
+/**
+ * struct profile_func - Samples which hit a function
+ *
+ * @name:	Function name, or NULL if not known
+ * @addr:	Link-time address of the function, or of the sample if the
+ *		name is not known
+ * @count:	Number of samples
+ */
+struct profile_func {
+	const char *name;
+	ulong addr;
+	uint count;
+};
+
+void profile_sample(ulong pc, ulong lr)
+{
+	struct profile_ent *ent = &prof.samples[prof.head];
+
+	ent->pc = pc;
+	ent->lr = lr;
+	if (++prof.head == CONFIG_PROFILE_SAMPLES)
+		prof.head = 0;
+	prof.total++;
+}
+
+int profile_start(uint rate)
+{
+	int ret;
+
+	if (prof.running)
+		return -EBUSY;
+	if (!rate)
+		return -EINVAL;
+	if (!prof.samples) {
+		prof.samples = malloc(CONFIG_PROFILE_SAMPLES *
+				      sizeof(struct profile_ent));
+		if (!prof.samples)
+			return -ENOMEM;
+	}
+	prof.head = 0;
+	prof.total = 0;
+	prof.rate = rate;
+
+	ret = profile_timer_start(rate);
+	if (ret)
+		return ret;
+	prof.running = true;
+	enable_interrupts();
+
+	return 0;
+}
+
+bool profile_running(void)
+{
+	return prof.running;
+}
+
+void profile_stop(void)
+{
+	if (!prof.running)
+		return;
+	disable_interrupts();
+	profile_timer_stop();
+	prof.running = false;
+}
+
+/* Number of samples in the buffer, oldest first from @first */
+static uint profile_count(uint *first)
+{
+	if (prof.total < CONFIG_PROFILE_SAMPLES) {
+		*first = 0;
+		return prof.total;
+	}
+	*first = prof.head;
+
+	return CONFIG_PROFILE_SAMPLES;
+}
+
+/* Convert a run-time address to a link-time one */
+static ulong profile_addr(ulong addr)
+{
+	return (addr & ~1UL) - gd->reloc_off;
+}
+
+static const char *profile_lookup(ulong addr, ulong *base, ulong *next)
+{
+#ifdef CONFIG_KALLSYMS
+	const char *name = symbol_lookup_range(addr, base, next);
+
+	if (name)
+		return name;
+#endif
+	*base = addr;
+	*next = addr + 1;
+
+	return NULL;
+}
+
+static int profile_cmp_addr(const void *a, const void *b)
+{
+	ulong addr_a = *(const ulong *)a, addr_b = *(const ulong *)b;
+
+	return addr_a < addr_b ? -1 : addr_a > addr_b;
+}
+
+/* Sort functions by decreasing sample count, then by address */
+static int profile_cmp_count(const void *a, const void *b)
+{
+	const struct profile_func *func_a = a, *func_b = b;
+
+	if (func_a->count != func_b->count)
+		return func_a->count < func_b->count ? 1 : -1;
+
+	return profile_cmp_addr(&func_a->addr, &func_b->addr);
+}
+
+int profile_report(int count)
+{
+	struct profile_func *funcs, *func = NULL;
+	uint nsamples, nfuncs, first, i;
+	ulong *pcs, next = 0;
+
+	nsamples = profile_count(&first);
+	if (!nsamples)
+		return -ENOENT;
+	pcs = malloc(nsamples * sizeof(*pcs));
+	funcs = malloc(nsamples * sizeof(*funcs));
+	if (!pcs || !funcs) {
+		free(pcs);
+		free(funcs);
+		return -ENOMEM;
+	}
+
+	/* Sort the samples so that each function is looked up only once */
+	for (i = 0; i < nsamples; i++)
+		pcs[i] = profile_addr(prof.samples[i].pc);
+	qsort(pcs, nsamples, sizeof(*pcs), profile_cmp_addr);
+	for (i = nfuncs = 0; i < nsamples; i++) {
+		if (!func || pcs[i] >= next) {
+			func = &funcs[nfuncs++];
+			func->name = profile_lookup(pcs[i], &func->addr, &next);
+			func->count = 0;
+		}
+		func->count++;
+	}
+	qsort(funcs, nfuncs, sizeof(*funcs), profile_cmp_count);
+
+	printf("%lu samples at %u Hz", prof.total, prof.rate);
+	if (prof.total > nsamples)
+		printf(", last %u kept", nsamples);
+	printf("\n%8s %6s  %s\n", "Samples", "%", "Function");
+	if (count <= 0 || count > (int)nfuncs)
+		count = nfuncs;
+	for (i = 0, func = funcs; i < count; i++, func++) {
+		uint permille = func->count * 1000ULL / nsamples;
+
+		printf("%8u %4u.%u  ", func->count, permille / 10,
+		       permille % 10);
+		if (func->name)
+			printf("%s\n", func->name);
+		else
+			printf("%08lx\n", func->addr);
+	}
+	if (count < nfuncs)
+		printf("(%u more)\n", nfuncs - count);
+
+	free(pcs);
+	free(funcs);
+
+	return 0;
+}
+
+int profile_list_samples(void *buff, int buff_size, unsigned int *needed)
+{
+	struct trace_output_hdr *output_hdr = buff;
+	struct trace_sample *out = buff + sizeof(*output_hdr);
+	uint nsamples, first, i;
+
+	nsamples = profile_count(&first);
+	*needed = sizeof(*output_hdr) + nsamples * sizeof(*out);
+	if (*needed > buff_size)
+		return -ENOSPC;
+
+	output_hdr->type = TRACE_CHUNK_SAMPLES;
+	output_hdr->rec_count = nsamples;
+	for (i = 0; i < nsamples; i++, out++) {
+		struct profile_ent *ent;
+
+		ent = &prof.samples[(first + i) % CONFIG_PROFILE_SAMPLES];
+		out->pc = profile_addr(ent->pc) - CONFIG_SYS_TEXT_BASE;
+		out->lr = profile_addr(ent->lr) - CONFIG_SYS_TEXT_BASE;
+	}
+
+	return 0;
+}
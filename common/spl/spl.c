@@ -361,6 +361,7 @@ static int write_spl_handoff(void)
 	if (!ho)
 		return -ENOENT;
 	handoff_save_dram(ho);
+	handoff_save_arch(ho);
 #ifdef CONFIG_SANDBOX
 	ho->arch.magic = TEST_HANDOFF_MAGIC;
 #endif
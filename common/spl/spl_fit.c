@@ -150,6 +150,14 @@ static int get_aligned_image_size(struct spl_load_info *info, int data_size,
 	return (data_size + info->bl_len - 1) / info->bl_len;
 }
 
+/* Check whether an image is compressed in a format which SPL can unpack */
+static bool spl_fit_image_compressed(uint8_t comp)
+{
+	return (IS_ENABLED(CONFIG_SPL_GZIP) && comp == IH_COMP_GZIP) ||
+	       (IS_ENABLED(CONFIG_SPL_LZ4) && comp == IH_COMP_LZ4) ||
+	       (IS_ENABLED(CONFIG_SPL_ZSTD) && comp == IH_COMP_ZSTD);
+}
+
 /**
  * spl_load_fit_image(): load the image described in a certain FIT node
  * @info:	points to information about the device to load data from
@@ -192,11 +200,12 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 			debug("%s ", genimg_get_type_name(type));
 	}
 
-	if (IS_ENABLED(CONFIG_SPL_OS_BOOT) && IS_ENABLED(CONFIG_SPL_GZIP)) {
+	if (IS_ENABLED(CONFIG_SPL_GZIP) || IS_ENABLED(CONFIG_SPL_LZ4) ||
+	    IS_ENABLED(CONFIG_SPL_ZSTD)) {
+		/* Images without a compression property are not compressed */
 		if (fit_image_get_comp(fit, node, &image_comp))
-			puts("Cannot get image compression format.\n");
-		else
-			debug("%s ", genimg_get_comp_name(image_comp));
+			image_comp = IH_COMP_NONE;
+		debug("%s ", genimg_get_comp_name(image_comp));
 	}
 
 	if (fit_image_get_load(fit, node, &load_addr))
@@ -214,7 +223,17 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 		if (fit_image_get_data_size(fit, node, &len))
 			return -ENOENT;
 
-		load_ptr = (load_addr + align_len) & ~align_len;
+		/*
+		 * Decompressing in place would overwrite input which has not
+		 * been read yet. Up to CONFIG_SYS_BOOTM_LEN bytes may be
+		 * written at the load address, so read compressed data just
+		 * beyond that.
+		 */
+		if (spl_fit_image_compressed(image_comp))
+			load_ptr = ALIGN(load_addr + CONFIG_SYS_BOOTM_LEN,
+					 ARCH_DMA_MINALIGN);
+		else
+			load_ptr = (load_addr + align_len) & ~align_len;
 		length = len;
 
 		overhead = get_aligned_image_overhead(info, offset);
@@ -260,6 +279,22 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 			return -EIO;
 		}
 		length = size;
+	} else if (IS_ENABLED(CONFIG_SPL_LZ4) && image_comp == IH_COMP_LZ4) {
+		size_t lz4_size = CONFIG_SYS_BOOTM_LEN;
+
+		if (ulz4fn(src, length, (void *)load_addr, &lz4_size)) {
+			puts("Uncompressing error\n");
+			return -EIO;
+		}
+		length = lz4_size;
+	} else if (IS_ENABLED(CONFIG_SPL_ZSTD) && image_comp == IH_COMP_ZSTD) {
+		size_t zsize = CONFIG_SYS_BOOTM_LEN;
+
+		if (zstd_decompress(src, length, (void *)load_addr, &zsize)) {
+			puts("Uncompressing error\n");
+			return -EIO;
+		}
+		length = zsize;
 	} else {
 		memcpy((void *)load_addr, src, length);
 	}
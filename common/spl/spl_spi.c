@@ -19,7 +19,8 @@ DECLARE_GLOBAL_DATA_PTR;
 #ifdef CONFIG_SPL_OS_BOOT
 /*
  * Load the kernel, check for a valid header we can parse, and if found load
- * the kernel and then device tree.
+ * the device tree and then the kernel. The device tree must have been
+ * prepared (e.g. by 'spl export fdt'), otherwise U-Boot is booted instead.
  */
 static int spi_load_image_os(struct spl_image_info *spl_image,
 			     struct spi_flash *flash,
@@ -38,14 +39,19 @@ static int spi_load_image_os(struct spl_image_info *spl_image,
 	if (err)
 		return err;
 
-	spi_flash_read(flash, CONFIG_SYS_SPI_KERNEL_OFFS,
-		       spl_image->size, (void *)spl_image->load_addr);
-
 	/* Read device tree. */
 	spi_flash_read(flash, CONFIG_SYS_SPI_ARGS_OFFS,
 		       CONFIG_SYS_SPI_ARGS_SIZE,
 		       (void *)CONFIG_SYS_SPL_ARGS_ADDR);
 
+	if (fdt_magic((void *)CONFIG_SYS_SPL_ARGS_ADDR) != FDT_MAGIC) {
+		debug("%s: No device tree at args offset\n", __func__);
+		return -1;
+	}
+
+	spi_flash_read(flash, CONFIG_SYS_SPI_KERNEL_OFFS,
+		       spl_image->size, (void *)spl_image->load_addr);
+
 	return 0;
 }
 #endif
@@ -5,4 +5,7 @@
  * Licensed under the GPL-2 or later.
  */
 
-const char const system_map[] = SYSTEM_MAP;
+/* One string per symbol, generated by the top-level Makefile */
+const char system_map[] = ""
+#include <generated/system_map.h>
+	;
@@ -40,6 +40,7 @@
 #include <memalign.h>
 #include <asm/byteorder.h>
 #include <asm/processor.h>
+#include <asm/unaligned.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
 
@@ -56,11 +57,20 @@
 static const unsigned char us_direction[256/8] = {
 	0x28, 0x81, 0x14, 0x14, 0x20, 0x01, 0x90, 0x77,
 	0x0C, 0x20, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00,
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01,
+	0x00, 0x01, 0x00, 0x40, 0x00, 0x01, 0x00, 0x01,
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
 };
 #define US_DIRECTION(x) ((us_direction[x>>3] >> (x & 7)) & 1)
 
+/*
+ * 16-byte commands, for devices with more than 2^32 blocks. SCSI_READ16 in
+ * scsi.h is the value emulated by the AHCI driver, not the SBC opcode.
+ */
+#define USB_STOR_READ16		0x88
+#define USB_STOR_WRITE16	0x8a
+#define USB_STOR_SERVICE_IN16	SCSI_RD_CAPAC16
+#define USB_STOR_SAI_RD_CAPAC16	0x10
+
 static struct scsi_cmd usb_ccb __aligned(ARCH_DMA_MINALIGN);
 static __u32 CBWTag;
 
@@ -79,6 +89,7 @@ struct us_data {
 
 	unsigned int	flags;			/* from filter initially */
 #	define USB_READY	(1 << 0)
+#	define USB_CMD16	(1 << 1)	/* use READ/WRITE(16) */
 	unsigned char	ifnum;			/* interface number */
 	unsigned char	ep_in;			/* in endpoint */
 	unsigned char	ep_out;			/* out ....... */
@@ -820,6 +831,9 @@ again:
 		return USB_STOR_TRANSPORT_FAILED;
 	}
 
+	/* The device has completed a command, so is ready for the next */
+	us->flags |= USB_READY;
+
 	return result;
 }
 
@@ -943,11 +957,11 @@ static void usb_stor_set_max_xfer_blk(struct usb_device *udev,
 	int __maybe_unused ret;
 
 #if !CONFIG_IS_ENABLED(DM_USB)
-#ifdef CONFIG_USB_EHCI_HCD
+#if defined(CONFIG_USB_EHCI_HCD) || defined(CONFIG_USB_DWC2)
 	/*
-	 * The U-Boot EHCI driver can handle any transfer length as long as
-	 * there is enough free heap space left, but the SCSI READ(10) and
-	 * WRITE(10) commands are limited to 65535 blocks.
+	 * The U-Boot EHCI and DWC2 drivers can handle any transfer length as
+	 * long as there is enough free heap space left, but the SCSI READ(10)
+	 * and WRITE(10) commands are limited to 65535 blocks.
 	 */
 	blk = USHRT_MAX;
 #else
@@ -1061,6 +1075,54 @@ static int usb_read_capacity(struct scsi_cmd *srb, struct us_data *ss)
 	return -1;
 }
 
+#ifdef CONFIG_SYS_64BIT_LBA
+static int usb_read_capacity_16(struct scsi_cmd *srb, struct us_data *ss)
+{
+	int retry;
+
+	retry = 3;
+	do {
+		memset(&srb->cmd[0], 0, 16);
+		srb->cmd[0] = USB_STOR_SERVICE_IN16;
+		srb->cmd[1] = USB_STOR_SAI_RD_CAPAC16;
+		srb->cmd[13] = 32;
+		srb->datalen = 32;
+		srb->cmdlen = 16;
+		if (ss->transport(srb, ss) == USB_STOR_TRANSPORT_GOOD)
+			return 0;
+	} while (retry--);
+
+	return -1;
+}
+#endif
+
+static void usb_set_cmd16_lba(struct scsi_cmd *srb, u64 start, u32 blocks)
+{
+	put_unaligned_be64(start, &srb->cmd[2]);
+	put_unaligned_be32(blocks, &srb->cmd[10]);
+	srb->cmdlen = 16;
+}
+
+static int usb_read_16(struct scsi_cmd *srb, struct us_data *ss,
+		       u64 start, unsigned short blocks)
+{
+	memset(&srb->cmd[0], 0, 16);
+	srb->cmd[0] = USB_STOR_READ16;
+	usb_set_cmd16_lba(srb, start, blocks);
+	debug("read16: start %llx blocks %x\n", start, blocks);
+	return ss->transport(srb, ss);
+}
+
+static int usb_write_16(struct scsi_cmd *srb, struct us_data *ss,
+			u64 start, unsigned short blocks)
+{
+	memset(&srb->cmd[0], 0, 16);
+	srb->cmd[0] = USB_STOR_WRITE16;
+	usb_set_cmd16_lba(srb, start, blocks);
+	debug("write16: start %llx blocks %x\n", start, blocks);
+	return ss->transport(srb, ss);
+}
+
 static int usb_read_10(struct scsi_cmd *srb, struct us_data *ss,
 		       unsigned long start, unsigned short blocks)
 {
@@ -1132,7 +1194,7 @@ static unsigned long usb_stor_read(struct blk_desc *block_dev, lbaint_t blknr,
 	unsigned short smallblks;
 	struct usb_device *udev;
 	struct us_data *ss;
-	int retry;
+	int retry, ret;
 	struct scsi_cmd *srb = &usb_ccb;
 #if CONFIG_IS_ENABLED(BLK)
 	struct blk_desc *block_dev;
@@ -1177,7 +1239,11 @@ retry_it:
 			usb_show_progress();
 		srb->datalen = block_dev->blksz * smallblks;
 		srb->pdata = (unsigned char *)buf_addr;
-		if (usb_read_10(srb, ss, start, smallblks)) {
+		if (ss->flags & USB_CMD16)
+			ret = usb_read_16(srb, ss, start, smallblks);
+		else
+			ret = usb_read_10(srb, ss, start, smallblks);
+		if (ret) {
 			debug("Read ERROR\n");
 			usb_request_sense(srb, ss);
 			if (retry--)
@@ -1189,7 +1255,6 @@ retry_it:
 		blks -= smallblks;
 		buf_addr += srb->datalen;
 	} while (blks != 0);
-	ss->flags &= ~USB_READY;
 
 	debug("usb_read: end startblk " LBAF ", blccnt %x buffer %lx\n",
 	      start, smallblks, buf_addr);
@@ -1213,7 +1278,7 @@ static unsigned long usb_stor_write(struct blk_desc *block_dev, lbaint_t blknr,
 	unsigned short smallblks;
 	struct usb_device *udev;
 	struct us_data *ss;
-	int retry;
+	int retry, ret;
 	struct scsi_cmd *srb = &usb_ccb;
 #if CONFIG_IS_ENABLED(BLK)
 	struct blk_desc *block_dev;
@@ -1262,7 +1327,11 @@ retry_it:
 			usb_show_progress();
 		srb->datalen = block_dev->blksz * smallblks;
 		srb->pdata = (unsigned char *)buf_addr;
-		if (usb_write_10(srb, ss, start, smallblks)) {
+		if (ss->flags & USB_CMD16)
+			ret = usb_write_16(srb, ss, start, smallblks);
+		else
+			ret = usb_write_10(srb, ss, start, smallblks);
+		if (ret) {
 			debug("Write ERROR\n");
 			usb_request_sense(srb, ss);
 			if (retry--)
@@ -1274,7 +1343,6 @@ retry_it:
 		blks -= smallblks;
 		buf_addr += srb->datalen;
 	} while (blks != 0);
-	ss->flags &= ~USB_READY;
 
 	debug("usb_write: end startblk " LBAF ", blccnt %x buffer %lx\n",
 	      start, smallblks, buf_addr);
@@ -1413,9 +1481,10 @@ int usb_stor_get_info(struct usb_device *dev, struct us_data *ss,
 		      struct blk_desc *dev_desc)
 {
 	unsigned char perq, modi;
-	ALLOC_CACHE_ALIGN_BUFFER(u32, cap, 2);
+	ALLOC_CACHE_ALIGN_BUFFER(u32, cap, 8);
 	ALLOC_CACHE_ALIGN_BUFFER(u8, usb_stor_buf, 36);
-	u32 capacity, blksz;
+	lbaint_t capacity;
+	u32 blksz;
 	struct scsi_cmd *pccb = &usb_ccb;
 
 	pccb->pdata = usb_stor_buf;
@@ -1485,7 +1554,23 @@ int usb_stor_get_info(struct usb_device *dev, struct us_data *ss,
 	capacity = be32_to_cpu(cap[0]) + 1;
 	blksz = be32_to_cpu(cap[1]);
 
-	debug("Capacity = 0x%08x, blocksz = 0x%08x\n", capacity, blksz);
+	/*
+	 * A device with 2^32 blocks or more needs 16-byte commands, which
+	 * only the Bulk-Only transport can carry
+	 */
+	ss->flags &= ~USB_CMD16;
+#ifdef CONFIG_SYS_64BIT_LBA
+	if (be32_to_cpu(cap[0]) == 0xffffffff && ss->protocol == US_PR_BULK) {
+		memset(pccb->pdata, 0, 32);
+		if (!usb_read_capacity_16(pccb, ss)) {
+			capacity = get_unaligned_be64(cap) + 1;
+			blksz = be32_to_cpu(cap[2]);
+			ss->flags |= USB_CMD16;
+		}
+	}
+#endif
+
+	debug("Capacity = " LBAF ", blocksz = 0x%08x\n", capacity, blksz);
 	dev_desc->lba = capacity;
 	dev_desc->blksz = blksz;
 	dev_desc->log2blksz = LOG2(dev_desc->blksz);
@@ -0,0 +1,62 @@
+# SPDX-License-Identifier: GPL-2.0+
+
+Sampling profiler
+=================
+
+The sampling profiler shows where U-Boot spends its time, without the
+compiler instrumentation and large buffer needed by function tracing (see
+README.trace). A periodic timer interrupt records the interrupted program
+counter and link register in a ring buffer. Since nothing else changes, it
+can be left enabled in production builds.
+
+
+Configuration
+-------------
+
+CONFIG_PROFILE enables the profiler and CONFIG_CMD_PROFILE the 'profile'
+command. The architecture must provide the timer interrupt
+(CONFIG_HAVE_PROFILE_TIMER). At present this is the Cortex-A9 MPCore private
+timer, used on SoCFPGA Gen5 and Arria 10. Sandbox has a timer which only
+fires when a test calls sandbox_profile_tick().
+
+CONFIG_KALLSYMS links a symbol table into U-Boot so that the report shows
+function names. Without it, samples are shown by address, which can be
+looked up in System.map.
+
+CONFIG_PROFILE_SAMPLES sets the size of the ring buffer (default 8192
+samples, 64KiB on 32-bit machines) and CONFIG_PROFILE_RATE the default
+sampling rate (1000 Hz).
+
+
+Usage
+-----
+
+    => profile start
+    => mmc read 1000000 0 10000
+    => profile report 5
+    1853 samples at 1000 Hz
+     Samples      %  Function
+        1247   67.2  dwmci_send_cmd
+         355   19.1  bounce_buffer_stop
+         ...
+
+'profile report' and 'profile dump' stop the profiler first. Interrupts are
+only unmasked while the profiler runs, so none can be taken before it has set
+up the interrupt controller. They are disabled and the timer stopped before
+booting an OS.
+
+
+Flame graphs
+------------
+
+'profile dump [<addr> <size>]' writes the samples to memory in the same
+container format as 'trace calls', so they can be saved in the same way,
+e.g. with tftpput. On the host:
+
+    $ tools/proftool -m System.map -p profile.bin dump-flamegraph > out.folded
+    $ flamegraph.pl out.folded > profile.svg
+
+Each sample is a stack of at most two functions: the one containing the
+program counter and, where it differs, the one containing the link
+register. The latter is only the caller if the sampled function had not
+yet made a call of its own, so treat it as a hint.
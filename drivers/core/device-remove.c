@@ -195,7 +195,7 @@ int device_remove(struct udevice *dev, uint flags)
 	if (flags_remove(flags, drv->flags)) {
 		device_free(dev);
 
-		dev->seq = -1;
+		uclass_set_dev_seq(dev, -1);
 		dev->flags &= ~DM_FLAG_ACTIVATED;
 	}
 
@@ -70,6 +70,9 @@ static int device_bind_common(struct udevice *parent, const struct driver *drv,
 
 	dev->seq = -1;
 	dev->req_seq = -1;
+	if (CONFIG_IS_ENABLED(DM_DEFERRED_PROBE) && ofnode_valid(node) &&
+	    ofnode_read_bool(node, "u-boot,deferred-probe"))
+		dev->flags |= DM_FLAG_PROBE_DEFERRED;
 	if (CONFIG_IS_ENABLED(DM_SEQ_ALIAS) &&
 	    (uc->uc_drv->flags & DM_UC_FLAG_SEQ_ALIAS)) {
 		/*
@@ -305,10 +308,31 @@ static void *alloc_priv(int size, uint flags)
 	return priv;
 }
 
+#if CONFIG_IS_ENABLED(BOOTSTAGE_DM_PROBE)
+/*
+ * Check whether the probe of a device can be timed. With a driver-model
+ * timer, timer_get_boot_us() may itself probe the timer and its parents, so
+ * nothing is timed until gd->timer is set, and the timer probes never are.
+ */
+static bool device_probe_timed(struct udevice *dev)
+{
+	if (device_get_uclass_id(dev) == UCLASS_TIMER)
+		return false;
+#ifdef CONFIG_TIMER
+	if (!gd->timer)
+		return false;
+#endif
+
+	return true;
+}
+#endif
+
 int device_probe(struct udevice *dev)
 {
 	struct power_domain pd;
 	const struct driver *drv;
+	__maybe_unused uint32_t start_us = 0;
+	__maybe_unused bool timed;
 	int size = 0;
 	int ret;
 	int seq;
@@ -370,12 +394,17 @@ int device_probe(struct udevice *dev)
 			return 0;
 	}
 
+#if CONFIG_IS_ENABLED(BOOTSTAGE_DM_PROBE)
+	timed = device_probe_timed(dev);
+	if (timed)
+		start_us = timer_get_boot_us();
+#endif
 	seq = uclass_resolve_seq(dev);
 	if (seq < 0) {
 		ret = seq;
 		goto fail;
 	}
-	dev->seq = seq;
+	uclass_set_dev_seq(dev, seq);
 
 	dev->flags |= DM_FLAG_ACTIVATED;
 
@@ -429,6 +458,11 @@ int device_probe(struct udevice *dev)
 	if (dev->parent && device_get_uclass_id(dev) == UCLASS_PINCTRL)
 		pinctrl_select_state(dev, "default");
 
+#if CONFIG_IS_ENABLED(BOOTSTAGE_DM_PROBE)
+	if (timed)
+		dev->probe_time_us = bootstage_accum_name(drv->name, start_us);
+#endif
+
 	return 0;
 fail_uclass:
 	if (device_remove(dev, DM_REMOVE_NORMAL)) {
@@ -438,7 +472,7 @@ fail_uclass:
 fail:
 	dev->flags &= ~DM_FLAG_ACTIVATED;
 
-	dev->seq = -1;
+	uclass_set_dev_seq(dev, -1);
 	device_free(dev);
 
 	return ret;
@@ -804,7 +838,7 @@ int device_set_name(struct udevice *dev, const char *name)
 	name = strdup(name);
 	if (!name)
 		return -ENOMEM;
-	dev->name = name;
+	uclass_set_dev_name(dev, name);
 	device_set_name_alloced(dev);
 
 	return 0;
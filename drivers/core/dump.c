@@ -16,9 +16,16 @@ static void show_devices(struct udevice *dev, int depth, int last_flag)
 	struct udevice *child;
 
 	/* print the first 20 characters to not break the tree-format. */
-	printf(" %-10.10s  %2d  [ %c ]   %-20.20s  ", dev->uclass->uc_drv->name,
+	printf(" %-10.10s  %2d  [ %c ]   ", dev->uclass->uc_drv->name,
 	       dev_get_uclass_index(dev, NULL),
-	       dev->flags & DM_FLAG_ACTIVATED ? '+' : ' ', dev->driver->name);
+	       dev->flags & DM_FLAG_ACTIVATED ? '+' : ' ');
+#if CONFIG_IS_ENABLED(BOOTSTAGE_DM_PROBE)
+	if (dev->flags & DM_FLAG_ACTIVATED)
+		printf("%8u  ", dev->probe_time_us);
+	else
+		printf("%8s  ", "");
+#endif
+	printf("%-20.20s  ", dev->driver->name);
 
 	for (i = depth; i >= 0; i--) {
 		is_last = (last_flag >> i) & 1;
@@ -49,8 +56,13 @@ void dm_dump_all(void)
 
 	root = dm_root();
 	if (root) {
+#if CONFIG_IS_ENABLED(BOOTSTAGE_DM_PROBE)
+		printf(" Class     Index  Probed  Time(us)  Driver                Name\n");
+		printf("---------------------------------------------------------------------\n");
+#else
 		printf(" Class     Index  Probed  Driver                Name\n");
 		printf("-----------------------------------------------------------\n");
+#endif
 		show_devices(root, -1, 0);
 	}
 }
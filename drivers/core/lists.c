@@ -11,6 +11,7 @@
 #include <dm/device.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
+#include <dm/of_index.h>
 #include <dm/platdata.h>
 #include <dm/uclass.h>
 #include <dm/util.h>
@@ -163,13 +164,17 @@ int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp,
 		pr_debug("   - attempt to match compatible string '%s'\n",
 			 compat);
 
-		for (entry = driver; entry != driver + n_ents; entry++) {
-			ret = driver_check_compatible(entry->of_match, &id,
-						      compat);
-			if (!ret)
-				break;
+		ret = of_index_find_driver(compat, &entry, &id);
+		if (ret == -ENOSYS) {
+			for (entry = driver; entry != driver + n_ents;
+			     entry++) {
+				ret = driver_check_compatible(entry->of_match,
+							      &id, compat);
+				if (!ret)
+					break;
+			}
 		}
-		if (entry == driver + n_ents)
+		if (ret)
 			continue;
 
 		if (pre_reloc_only) {
@@ -22,6 +22,7 @@
 #include <common.h>
 #include <linux/libfdt.h>
 #include <dm/of_access.h>
+#include <dm/of_index.h>
 #include <linux/ctype.h>
 #include <linux/err.h>
 #include <linux/ioport.h>
@@ -366,6 +367,16 @@ struct device_node *of_find_compatible_node(struct device_node *from,
 		const char *type, const char *compatible)
 {
 	struct device_node *np;
+	ofnode node;
+	int ret;
+
+	if (!type && compatible && *compatible) {
+		ret = of_index_find_compatible(np_to_ofnode(from), compatible,
+					       &node);
+		if (ret != -ENOSYS)
+			return ret ? NULL : (struct device_node *)
+					    ofnode_to_np(node);
+	}
 
 	for_each_of_allnodes_from(from, np)
 		if (of_device_is_compatible(np, compatible, type, NULL) &&
@@ -406,10 +417,16 @@ struct device_node *of_find_node_by_prop_value(struct device_node *from,
 struct device_node *of_find_node_by_phandle(phandle handle)
 {
 	struct device_node *np;
+	ofnode node;
+	int ret;
 
 	if (!handle)
 		return NULL;
 
+	ret = of_index_find_phandle(handle, &node);
+	if (ret != -ENOSYS)
+		return ret ? NULL : (struct device_node *)ofnode_to_np(node);
+
 	for_each_of_allnodes(np)
 		if (np->phandle == handle)
 			break;
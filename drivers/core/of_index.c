@@ -0,0 +1,486 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Indexes of the device tree and of driver compatible strings
+ *
+ * Finding a node by phandle or compatible string, or a driver by compatible
+ * string, otherwise means scanning the whole tree or driver list, and
+ * binding does that for every node. The indexes here are sorted arrays,
+ * built on first use and searched by bisection.
+ *
+ * The tree indexes cover the live tree if active, else the flat tree at
+ * gd->fdt_blob. They are rebuilt if that tree moves or changes size. Flat
+ * tree offsets found in the index are checked before they are returned, to
+ * catch changes made in place.
+ *
+ * Before relocation in U-Boot proper, only the driver index is built, since
+ * its size is fixed by the driver list. It is dropped on relocation.
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <malloc.h>
+#include <linux/libfdt.h>
+#include <dm/of_access.h>
+#include <dm/of_index.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+struct of_index_phandle {
+	uint phandle;
+	ofnode node;
+};
+
+struct of_index_compat {
+	const char *compat;
+	ofnode node;
+};
+
+/* Positions in the driver list and in the driver's of_match table */
+struct of_index_driver {
+	u16 drv;
+	u16 id;
+};
+
+/**
+ * struct of_index - Device tree and driver indexes
+ *
+ * @root:		Live tree root or flat tree which the tree indexes cover
+ * @struct_size:	Size of the flat tree's structure block
+ * @strings_size:	Size of the flat tree's strings block
+ * @tree_built:		true if the tree indexes have been built for @root
+ * @tree_failed:	true if the tree indexes could not be built
+ * @phandles:		Nodes with a phandle, sorted by phandle
+ * @phandle_count:	Number of entries in @phandles
+ * @compats:		One entry for each string in each node's compatible
+ *			list, sorted by string then by tree order
+ * @compat_count:	Number of entries in @compats
+ * @drivers_built:	true if the driver index has been built
+ * @driver_list:	Start of the driver linker list
+ * @drivers:		One entry for each driver's of_match entry, sorted by
+ *			string then by position in the driver list
+ * @driver_count:	Number of entries in @drivers, -1 if it could not be
+ *			built
+ */
+struct of_index {
+	const void *root;
+	int struct_size;
+	int strings_size;
+	bool tree_built;
+	bool tree_failed;
+	struct of_index_phandle *phandles;
+	int phandle_count;
+	struct of_index_compat *compats;
+	int compat_count;
+	bool drivers_built;
+	struct driver *driver_list;
+	struct of_index_driver *drivers;
+	int driver_count;
+};
+
+/* Position of a node in tree order, valid for a tree built by of_live */
+static ulong of_index_pos(ofnode node)
+{
+	if (ofnode_is_np(node))
+		return (ulong)ofnode_to_np(node);
+
+	return ofnode_to_offset(node);
+}
+
+/* Compatible strings are not case-sensitive in the live tree */
+static int of_index_strcmp(const char *s1, const char *s2)
+{
+	if (of_live_active())
+		return of_compat_cmp(s1, s2, 0);
+
+	return strcmp(s1, s2);
+}
+
+static int of_index_cmp_pos(ofnode node1, ofnode node2)
+{
+	ulong pos1 = of_index_pos(node1), pos2 = of_index_pos(node2);
+
+	return pos1 < pos2 ? -1 : pos1 > pos2;
+}
+
+static int of_index_cmp_phandle(const void *a, const void *b)
+{
+	const struct of_index_phandle *ent1 = a, *ent2 = b;
+
+	if (ent1->phandle != ent2->phandle)
+		return ent1->phandle < ent2->phandle ? -1 : 1;
+
+	return of_index_cmp_pos(ent1->node, ent2->node);
+}
+
+static int of_index_cmp_compat(const void *a, const void *b)
+{
+	const struct of_index_compat *ent1 = a, *ent2 = b;
+	int ret;
+
+	ret = of_index_strcmp(ent1->compat, ent2->compat);
+	if (ret)
+		return ret;
+
+	return of_index_cmp_pos(ent1->node, ent2->node);
+}
+
+static struct driver *of_index_driver(const struct of_index_driver *ent)
+{
+	struct of_index *idx = gd->of_index;
+
+	return idx->driver_list + ent->drv;
+}
+
+static const char *of_index_driver_compat(const struct of_index_driver *ent)
+{
+	return of_index_driver(ent)->of_match[ent->id].compatible;
+}
+
+static int of_index_cmp_driver(const void *a, const void *b)
+{
+	const struct of_index_driver *ent1 = a, *ent2 = b;
+	int ret;
+
+	ret = strcmp(of_index_driver_compat(ent1),
+		     of_index_driver_compat(ent2));
+	if (ret)
+		return ret;
+	if (ent1->drv != ent2->drv)
+		return ent1->drv < ent2->drv ? -1 : 1;
+
+	return ent1->id < ent2->id ? -1 : ent1->id > ent2->id;
+}
+
+/* Return the node after @node in tree order, starting at the root */
+static ofnode of_index_next_node(ofnode node)
+{
+	int offset;
+
+	if (of_live_active()) {
+		return np_to_ofnode(of_find_all_nodes(
+				(struct device_node *)ofnode_to_np(node)));
+	}
+	if (!ofnode_valid(node))
+		return offset_to_ofnode(0);
+	offset = fdt_next_node(gd->fdt_blob, ofnode_to_offset(node), NULL);
+
+	return offset_to_ofnode(offset < 0 ? -1 : offset);
+}
+
+static uint of_index_node_phandle(ofnode node)
+{
+	if (ofnode_is_np(node))
+		return ofnode_to_np(node)->phandle;
+
+	return fdt_get_phandle(gd->fdt_blob, ofnode_to_offset(node));
+}
+
+/*
+ * Add the tree's nodes to the indexes, or just count them if the arrays
+ * are NULL
+ */
+static int of_index_scan_tree(struct of_index *idx)
+{
+	ofnode node, prev = ofnode_null();
+	const char *compat;
+	int len, i;
+
+	idx->phandle_count = 0;
+	idx->compat_count = 0;
+	for (node = of_index_next_node(prev); ofnode_valid(node);
+	     prev = node, node = of_index_next_node(node)) {
+		/* Lookups rely on the tree order matching of_index_pos() */
+		if (ofnode_valid(prev) && of_index_cmp_pos(prev, node) >= 0)
+			return -EINVAL;
+		if (of_index_node_phandle(node)) {
+			if (idx->phandles) {
+				idx->phandles[idx->phandle_count].phandle =
+					of_index_node_phandle(node);
+				idx->phandles[idx->phandle_count].node = node;
+			}
+			idx->phandle_count++;
+		}
+
+		compat = ofnode_get_property(node, "compatible", &len);
+		for (i = 0; compat && i < len; i += strlen(compat + i) + 1) {
+			if (idx->compats) {
+				idx->compats[idx->compat_count].compat =
+					compat + i;
+				idx->compats[idx->compat_count].node = node;
+			}
+			idx->compat_count++;
+		}
+	}
+
+	return 0;
+}
+
+static void of_index_free_tree(struct of_index *idx)
+{
+	free(idx->phandles);
+	free(idx->compats);
+	idx->phandles = NULL;
+	idx->compats = NULL;
+	idx->tree_built = false;
+	idx->tree_failed = false;
+}
+
+static int of_index_build_tree(struct of_index *idx)
+{
+	int ret;
+
+	ret = of_index_scan_tree(idx);
+	if (ret)
+		return ret;
+	idx->phandles = malloc(max(idx->phandle_count, 1) *
+			       sizeof(*idx->phandles));
+	idx->compats = malloc(max(idx->compat_count, 1) *
+			      sizeof(*idx->compats));
+	if (!idx->phandles || !idx->compats)
+		return -ENOMEM;
+	ret = of_index_scan_tree(idx);
+	if (ret)
+		return ret;
+	qsort(idx->phandles, idx->phandle_count, sizeof(*idx->phandles),
+	      of_index_cmp_phandle);
+	qsort(idx->compats, idx->compat_count, sizeof(*idx->compats),
+	      of_index_cmp_compat);
+	debug("%s: %d phandles, %d compatible strings\n", __func__,
+	      idx->phandle_count, idx->compat_count);
+
+	return 0;
+}
+
+/* Check for the small pre-relocation malloc() area of U-Boot proper */
+static bool of_index_early(void)
+{
+	return !IS_ENABLED(CONFIG_SPL_BUILD) &&
+	       !(gd->flags & GD_FLG_FULL_MALLOC_INIT);
+}
+
+/*
+ * Check whether @size bytes can be used in the pre-relocation malloc()
+ * area. At most half of what is left is taken, so that the devices bound
+ * before relocation still fit.
+ */
+static bool of_index_early_fits(size_t size)
+{
+#if CONFIG_VAL(SYS_MALLOC_F_LEN)
+	return size <= (gd->malloc_limit - gd->malloc_ptr) / 2;
+#else
+	return false;
+#endif
+}
+
+static struct of_index *of_index_get(void)
+{
+	if (!gd->of_index)
+		gd->of_index = calloc(1, sizeof(struct of_index));
+
+	return gd->of_index;
+}
+
+/* Get the tree indexes, building them if needed */
+static struct of_index *of_index_get_tree(void)
+{
+	struct of_index *idx;
+	const void *root;
+	int struct_size = 0, strings_size = 0;
+
+	/* These grow with the tree, so leave them until after relocation */
+	if (of_index_early())
+		return NULL;
+	idx = of_index_get();
+	if (!idx)
+		return NULL;
+	if (of_live_active()) {
+		root = gd->of_root;
+	} else {
+		root = gd->fdt_blob;
+		if (!root)
+			return NULL;
+		struct_size = fdt_size_dt_struct(root);
+		strings_size = fdt_size_dt_strings(root);
+	}
+	if (idx->tree_built && (idx->root != root ||
+				idx->struct_size != struct_size ||
+				idx->strings_size != strings_size))
+		of_index_free_tree(idx);
+
+	if (!idx->tree_built) {
+		int ret;
+
+		idx->root = root;
+		idx->struct_size = struct_size;
+		idx->strings_size = strings_size;
+		idx->tree_built = true;
+		ret = of_index_build_tree(idx);
+		if (ret) {
+			debug("%s: Cannot build index (err=%d)\n", __func__,
+			      ret);
+			of_index_free_tree(idx);
+			idx->tree_built = true;
+			idx->tree_failed = true;
+		}
+	}
+
+	return idx->tree_failed ? NULL : idx;
+}
+
+int of_index_find_phandle(uint phandle, ofnode *nodep)
+{
+	struct of_index *idx = of_index_get_tree();
+	struct of_index_phandle *ent;
+	int lo, hi, mid;
+
+	if (!idx)
+		return -ENOSYS;
+	for (lo = 0, hi = idx->phandle_count; lo < hi;) {
+		mid = (lo + hi) / 2;
+		if (idx->phandles[mid].phandle < phandle)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == idx->phandle_count || idx->phandles[lo].phandle != phandle)
+		return -ENOENT;
+	ent = &idx->phandles[lo];
+	if (!ofnode_is_np(ent->node) &&
+	    fdt_get_phandle(gd->fdt_blob, ofnode_to_offset(ent->node)) !=
+	    phandle) {
+		of_index_invalidate();
+		return -ENOSYS;
+	}
+	*nodep = ent->node;
+
+	return 0;
+}
+
+int of_index_find_compatible(ofnode from, const char *compat, ofnode *nodep)
+{
+	struct of_index *idx = of_index_get_tree();
+	struct of_index_compat *ent;
+	int lo, hi, mid, ret;
+
+	if (!idx)
+		return -ENOSYS;
+	/* Find the first entry for @compat which comes after @from */
+	for (lo = 0, hi = idx->compat_count; lo < hi;) {
+		mid = (lo + hi) / 2;
+		ent = &idx->compats[mid];
+		ret = of_index_strcmp(ent->compat, compat);
+		if (ret < 0 || (!ret && ofnode_valid(from) &&
+				of_index_cmp_pos(ent->node, from) <= 0))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == idx->compat_count ||
+	    of_index_strcmp(idx->compats[lo].compat, compat))
+		return -ENOENT;
+	ent = &idx->compats[lo];
+	if (!ofnode_is_np(ent->node) &&
+	    fdt_node_check_compatible(gd->fdt_blob,
+				      ofnode_to_offset(ent->node), compat)) {
+		of_index_invalidate();
+		return -ENOSYS;
+	}
+	*nodep = ent->node;
+
+	return 0;
+}
+
+/* Add each driver's of_match entries, or just count them if not allocated */
+static int of_index_scan_drivers(struct of_index *idx)
+{
+	const int n_ents = ll_entry_count(struct driver, driver);
+	struct of_index_driver *ent;
+	struct driver *drv;
+	int i, j;
+
+	idx->driver_count = 0;
+	for (i = 0; i < n_ents; i++) {
+		drv = idx->driver_list + i;
+		for (j = 0; drv->of_match && drv->of_match[j].compatible; j++) {
+			if (i > U16_MAX || j > U16_MAX)
+				return -E2BIG;
+			if (idx->drivers) {
+				ent = &idx->drivers[idx->driver_count];
+				ent->drv = i;
+				ent->id = j;
+			}
+			idx->driver_count++;
+		}
+	}
+
+	return 0;
+}
+
+static int of_index_build_drivers(struct of_index *idx)
+{
+	size_t size;
+	int ret;
+
+	idx->driver_list = ll_entry_start(struct driver, driver);
+	ret = of_index_scan_drivers(idx);
+	if (ret)
+		return ret;
+	size = max(idx->driver_count, 1) * sizeof(*idx->drivers);
+	if (of_index_early() && !of_index_early_fits(size))
+		return -ENOSPC;
+	idx->drivers = malloc(size);
+	if (!idx->drivers)
+		return -ENOMEM;
+	of_index_scan_drivers(idx);
+	qsort(idx->drivers, idx->driver_count, sizeof(*idx->drivers),
+	      of_index_cmp_driver);
+	debug("%s: %d driver compatible strings\n", __func__,
+	      idx->driver_count);
+
+	return 0;
+}
+
+int of_index_find_driver(const char *compat, struct driver **drvp,
+			 const struct udevice_id **idp)
+{
+	struct of_index *idx = of_index_get();
+	struct of_index_driver *ent;
+	int lo, hi, mid, ret;
+
+	if (!idx)
+		return -ENOSYS;
+	if (!idx->drivers_built) {
+		idx->drivers_built = true;
+		ret = of_index_build_drivers(idx);
+		if (ret) {
+			debug("%s: Cannot build index (err=%d)\n", __func__,
+			      ret);
+			idx->driver_count = -1;
+		}
+	}
+	if (idx->driver_count < 0)
+		return -ENOSYS;
+
+	for (lo = 0, hi = idx->driver_count; lo < hi;) {
+		mid = (lo + hi) / 2;
+		if (strcmp(of_index_driver_compat(&idx->drivers[mid]),
+			   compat) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == idx->driver_count ||
+	    strcmp(of_index_driver_compat(&idx->drivers[lo]), compat))
+		return -ENOENT;
+	ent = &idx->drivers[lo];
+	*drvp = of_index_driver(ent);
+	*idp = &of_index_driver(ent)->of_match[ent->id];
+
+	return 0;
+}
+
+void of_index_invalidate(void)
+{
+	if (gd->of_index)
+		of_index_free_tree(gd->of_index);
+}
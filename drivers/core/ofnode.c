@@ -11,6 +11,7 @@
 #include <linux/libfdt.h>
 #include <dm/of_access.h>
 #include <dm/of_addr.h>
+#include <dm/of_index.h>
 #include <dm/ofnode.h>
 #include <linux/err.h>
 #include <linux/ioport.h>
@@ -222,12 +223,18 @@ const char *ofnode_get_name(ofnode node)
 ofnode ofnode_get_by_phandle(uint phandle)
 {
 	ofnode node;
+	int ret;
 
-	if (of_live_active())
+	if (of_live_active()) {
 		node = np_to_ofnode(of_find_node_by_phandle(phandle));
-	else
-		node.of_offset = fdt_node_offset_by_phandle(gd->fdt_blob,
-							    phandle);
+	} else {
+		ret = of_index_find_phandle(phandle, &node);
+		if (ret == -ENOSYS)
+			node.of_offset = fdt_node_offset_by_phandle(
+						gd->fdt_blob, phandle);
+		else if (ret)
+			node.of_offset = -FDT_ERR_NOTFOUND;
+	}
 
 	return node;
 }
@@ -782,6 +789,13 @@ ofnode ofnode_by_compatible(ofnode from, const char *compat)
 			(struct device_node *)ofnode_to_np(from), NULL,
 			compat));
 	} else {
+		ofnode node;
+		int ret;
+
+		ret = of_index_find_compatible(from, compat, &node);
+		if (ret != -ENOSYS)
+			return ret ? ofnode_null() : node;
+
 		return offset_to_ofnode(fdt_node_offset_by_compatible(
 				gd->fdt_blob, ofnode_to_offset(from), compat));
 	}
@@ -815,6 +829,9 @@ int ofnode_write_prop(ofnode node, const char *propname, int len,
 	if (!np)
 		return -EINVAL;
 
+	/* This may change a compatible string or phandle */
+	of_index_invalidate();
+
 	for (pp = np->properties; pp; pp = pp->next) {
 		if (strcmp(pp->name, propname) == 0) {
 			/* Property exists -> change value */
@@ -19,6 +19,199 @@
 
 DECLARE_GLOBAL_DATA_PTR;
 
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+/**
+ * struct uclass_index - Tables to look up the devices in a uclass
+ *
+ * If anything goes wrong, such as running out of memory, the tables are
+ * dropped and lookups go back to walking the list of devices.
+ *
+ * @devs:	Devices in list order
+ * @names:	Devices sorted by name
+ * @count:	Number of entries in @devs and @names
+ * @size:	Number of entries allocated in @devs and @names
+ * @seqs:	Devices by sequence number, NULL for numbers not in use
+ * @seq_size:	Number of entries allocated in @seqs
+ */
+struct uclass_index {
+	struct udevice **devs;
+	struct udevice **names;
+	int count;
+	int size;
+	struct udevice **seqs;
+	int seq_size;
+};
+
+static void uclass_index_drop(struct uclass *uc)
+{
+	struct uclass_index *idx = uc->index;
+
+	if (!idx)
+		return;
+	free(idx->devs);
+	free(idx->names);
+	free(idx->seqs);
+	free(idx);
+	uc->index = NULL;
+}
+
+/* Return the position of the first of @count names not before @name */
+static int uclass_index_find_name(struct uclass_index *idx, const char *name,
+				  int count)
+{
+	int lo, hi, mid;
+
+	for (lo = 0, hi = count; lo < hi;) {
+		mid = (lo + hi) / 2;
+		if (strcmp(idx->names[mid]->name, name) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+/* Add @dev to the @count entries in @names, which must have space for it */
+static void uclass_index_add_name(struct uclass_index *idx,
+				  struct udevice *dev, int count)
+{
+	int pos = uclass_index_find_name(idx, dev->name, count);
+
+	memmove(&idx->names[pos + 1], &idx->names[pos],
+		(count - pos) * sizeof(*idx->names));
+	idx->names[pos] = dev;
+}
+
+/* Remove @dev from @names, returning false if it is not there */
+static bool uclass_index_remove_name(struct uclass_index *idx,
+				     struct udevice *dev)
+{
+	int pos;
+
+	for (pos = uclass_index_find_name(idx, dev->name, idx->count);
+	     pos < idx->count && idx->names[pos] != dev; pos++)
+		;
+	if (pos == idx->count)
+		return false;
+	memmove(&idx->names[pos], &idx->names[pos + 1],
+		(idx->count - pos - 1) * sizeof(*idx->names));
+
+	return true;
+}
+
+static void uclass_index_bind(struct uclass *uc, struct udevice *dev)
+{
+	struct uclass_index *idx = uc->index;
+	struct udevice **devs, **names;
+	int size;
+
+	if (!idx)
+		return;
+	if (idx->count == idx->size) {
+		size = max(idx->size * 2, 8);
+		devs = realloc(idx->devs, size * sizeof(*devs));
+		if (devs)
+			idx->devs = devs;
+		names = realloc(idx->names, size * sizeof(*names));
+		if (names)
+			idx->names = names;
+		if (!devs || !names) {
+			uclass_index_drop(uc);
+			return;
+		}
+		idx->size = size;
+	}
+	idx->devs[idx->count] = dev;
+	uclass_index_add_name(idx, dev, idx->count);
+	idx->count++;
+}
+
+static void uclass_index_unbind(struct uclass *uc, struct udevice *dev)
+{
+	struct uclass_index *idx = uc->index;
+	int pos;
+
+	if (!idx)
+		return;
+	for (pos = idx->count - 1; pos >= 0 && idx->devs[pos] != dev; pos--)
+		;
+	if (pos < 0 || !uclass_index_remove_name(idx, dev)) {
+		uclass_index_drop(uc);
+		return;
+	}
+	memmove(&idx->devs[pos], &idx->devs[pos + 1],
+		(idx->count - pos - 1) * sizeof(*idx->devs));
+	idx->count--;
+	if (dev->seq >= 0 && dev->seq < idx->seq_size &&
+	    idx->seqs[dev->seq] == dev)
+		idx->seqs[dev->seq] = NULL;
+}
+
+static void uclass_index_init(struct uclass *uc)
+{
+	/* Don't use up the small pre-relocation malloc() area */
+	if (gd->flags & GD_FLG_FULL_MALLOC_INIT)
+		uc->index = calloc(1, sizeof(struct uclass_index));
+}
+#else
+static inline void uclass_index_init(struct uclass *uc) {}
+static inline void uclass_index_drop(struct uclass *uc) {}
+static inline void uclass_index_bind(struct uclass *uc,
+				     struct udevice *dev) {}
+static inline void uclass_index_unbind(struct uclass *uc,
+				       struct udevice *dev) {}
+#endif
+
+void uclass_set_dev_seq(struct udevice *dev, int seq)
+{
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	struct uclass *uc = dev->uclass;
+	struct uclass_index *idx = uc->index;
+	struct udevice **seqs;
+	int size;
+
+	if (idx && dev->seq >= 0 && dev->seq < idx->seq_size &&
+	    idx->seqs[dev->seq] == dev)
+		idx->seqs[dev->seq] = NULL;
+	if (idx && seq >= idx->seq_size) {
+		size = max(seq + 1, max(idx->seq_size * 2, 8));
+		seqs = realloc(idx->seqs, size * sizeof(*seqs));
+		if (seqs) {
+			memset(&seqs[idx->seq_size], '\0',
+			       (size - idx->seq_size) * sizeof(*seqs));
+			idx->seqs = seqs;
+			idx->seq_size = size;
+		} else {
+			uclass_index_drop(uc);
+			idx = NULL;
+		}
+	}
+	if (idx && seq >= 0) {
+		/* Sequence numbers are unique, so this should not happen */
+		if (idx->seqs[seq])
+			uclass_index_drop(uc);
+		else
+			idx->seqs[seq] = dev;
+	}
+#endif
+	dev->seq = seq;
+}
+
+void uclass_set_dev_name(struct udevice *dev, const char *name)
+{
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	struct uclass_index *idx = dev->uclass ? dev->uclass->index : NULL;
+
+	if (idx && uclass_index_remove_name(idx, dev)) {
+		dev->name = name;
+		uclass_index_add_name(idx, dev, idx->count - 1);
+		return;
+	}
+#endif
+	dev->name = name;
+}
+
 struct uclass *uclass_find(enum uclass_id key)
 {
 	struct uclass *uc;
@@ -78,6 +271,7 @@ static int uclass_add(enum uclass_id id, struct uclass **ucp)
 	uc->uc_drv = uc_drv;
 	INIT_LIST_HEAD(&uc->sibling_node);
 	INIT_LIST_HEAD(&uc->dev_head);
+	uclass_index_init(uc);
 	list_add(&uc->sibling_node, &DM_UCLASS_ROOT_NON_CONST);
 
 	if (uc_drv->init) {
@@ -94,6 +288,7 @@ fail:
 		free(uc->priv);
 		uc->priv = NULL;
 	}
+	uclass_index_drop(uc);
 	list_del(&uc->sibling_node);
 fail_mem:
 	free(uc);
@@ -130,6 +325,7 @@ int uclass_destroy(struct uclass *uc)
 	list_del(&uc->sibling_node);
 	if (uc_drv->priv_auto_alloc_size)
 		free(uc->priv);
+	uclass_index_drop(uc);
 	free(uc);
 
 	return 0;
@@ -205,6 +401,15 @@ int uclass_find_device(enum uclass_id id, int index, struct udevice **devp)
 	if (list_empty(&uc->dev_head))
 		return -ENODEV;
 
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	if (uc->index) {
+		if (index < 0 || index >= uc->index->count)
+			return -ENODEV;
+		*devp = uc->index->devs[index];
+
+		return 0;
+	}
+#endif
 	uclass_foreach_dev(dev, uc) {
 		if (!index--) {
 			*devp = dev;
@@ -259,6 +464,27 @@ int uclass_find_device_by_name(enum uclass_id id, const char *name,
 	if (ret)
 		return ret;
 
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	/*
+	 * Names are matched by prefix. If more than one device matches, the
+	 * first in the list is wanted, which the index does not record.
+	 */
+	if (uc->index) {
+		struct uclass_index *idx = uc->index;
+		int len = strlen(name);
+		int pos;
+
+		pos = uclass_index_find_name(idx, name, idx->count);
+		if (pos == idx->count ||
+		    strncmp(idx->names[pos]->name, name, len))
+			return -ENODEV;
+		if (pos + 1 == idx->count ||
+		    strncmp(idx->names[pos + 1]->name, name, len)) {
+			*devp = idx->names[pos];
+			return 0;
+		}
+	}
+#endif
 	uclass_foreach_dev(dev, uc) {
 		if (!strncmp(dev->name, name, strlen(name))) {
 			*devp = dev;
@@ -308,6 +534,18 @@ int uclass_find_device_by_seq(enum uclass_id id, int seq_or_req_seq,
 	if (ret)
 		return ret;
 
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	if (uc->index && !find_req_seq) {
+		struct uclass_index *idx = uc->index;
+
+		if (seq_or_req_seq < 0 || seq_or_req_seq >= idx->seq_size ||
+		    !idx->seqs[seq_or_req_seq])
+			return -ENODEV;
+		*devp = idx->seqs[seq_or_req_seq];
+
+		return 0;
+	}
+#endif
 	uclass_foreach_dev(dev, uc) {
 		debug("   - %d %d '%s'\n", dev->req_seq, dev->seq, dev->name);
 		if ((find_req_seq ? dev->req_seq : dev->seq) ==
@@ -394,6 +632,22 @@ int uclass_find_device_by_phandle(enum uclass_id id, struct udevice *parent,
 	if (ret)
 		return ret;
 
+	/* With an index, finding the node is quicker than reading phandles */
+	if (CONFIG_IS_ENABLED(OF_INDEX)) {
+		ofnode node = ofnode_get_by_phandle(find_phandle);
+
+		if (!ofnode_valid(node))
+			return -ENODEV;
+		uclass_foreach_dev(dev, uc) {
+			if (ofnode_equal(dev_ofnode(dev), node)) {
+				*devp = dev;
+				return 0;
+			}
+		}
+
+		return -ENODEV;
+	}
+
 	uclass_foreach_dev(dev, uc) {
 		uint phandle;
 
@@ -597,6 +851,22 @@ int uclass_next_device_err(struct udevice **devp)
 	return 0;
 }
 
+/* Skip devices whose probe is deferred, then probe the device found */
+static int uclass_check_device_tail(struct udevice **devp)
+{
+	int ret;
+
+	while (*devp && device_is_deferred(*devp)) {
+		ret = uclass_find_next_device(devp);
+		if (ret)
+			return ret;
+	}
+	if (!*devp)
+		return 0;
+
+	return device_probe(*devp);
+}
+
 int uclass_first_device_check(enum uclass_id id, struct udevice **devp)
 {
 	int ret;
@@ -605,10 +875,8 @@ int uclass_first_device_check(enum uclass_id id, struct udevice **devp)
 	ret = uclass_find_first_device(id, devp);
 	if (ret)
 		return ret;
-	if (!*devp)
-		return 0;
 
-	return device_probe(*devp);
+	return uclass_check_device_tail(devp);
 }
 
 int uclass_next_device_check(struct udevice **devp)
@@ -618,10 +886,8 @@ int uclass_next_device_check(struct udevice **devp)
 	ret = uclass_find_next_device(devp);
 	if (ret)
 		return ret;
-	if (!*devp)
-		return 0;
 
-	return device_probe(*devp);
+	return uclass_check_device_tail(devp);
 }
 
 int uclass_bind_device(struct udevice *dev)
@@ -631,6 +897,7 @@ int uclass_bind_device(struct udevice *dev)
 
 	uc = dev->uclass;
 	list_add_tail(&dev->uclass_node, &uc->dev_head);
+	uclass_index_bind(uc, dev);
 
 	if (dev->parent) {
 		struct uclass_driver *uc_drv = dev->parent->uclass->uc_drv;
@@ -645,6 +912,7 @@ int uclass_bind_device(struct udevice *dev)
 	return 0;
 err:
 	/* There is no need to undo the parent's post_bind call */
+	uclass_index_unbind(uc, dev);
 	list_del(&dev->uclass_node);
 
 	return ret;
@@ -663,6 +931,7 @@ int uclass_unbind_device(struct udevice *dev)
 			return ret;
 	}
 
+	uclass_index_unbind(uc, dev);
 	list_del(&dev->uclass_node);
 	return 0;
 }
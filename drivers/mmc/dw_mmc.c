@@ -13,6 +13,7 @@
 #include <mmc.h>
 #include <dwmmc.h>
 #include <wait_bit.h>
+#include <linux/log2.h>
 
 #define PAGE_SIZE 4096
 
@@ -39,7 +40,33 @@ static void dwmci_set_idma_desc(struct dwmci_idmac *idmac,
 	desc->flags = desc0;
 	desc->cnt = desc1;
 	desc->addr = desc2;
-	desc->next_addr = (ulong)desc + sizeof(struct dwmci_idmac);
+}
+
+/*
+ * Get a chain of at least @count descriptors. The chain is kept for later
+ * transfers, so it is only allocated and linked when a larger one is needed.
+ */
+static struct dwmci_idmac *dwmci_get_idmac(struct dwmci_host *host,
+					   unsigned int count)
+{
+	struct dwmci_idmac *idmac;
+	unsigned int i;
+
+	if (count <= host->idmac_count)
+		return host->idmac;
+
+	count = __roundup_pow_of_two(count);
+	idmac = memalign(ARCH_DMA_MINALIGN, count * sizeof(*idmac));
+	if (!idmac)
+		return NULL;
+	for (i = 0; i < count; i++)
+		idmac[i].next_addr = (ulong)&idmac[i + 1];
+
+	free(host->idmac);
+	host->idmac = idmac;
+	host->idmac_count = count;
+
+	return idmac;
 }
 
 static void dwmci_prepare_data(struct dwmci_host *host,
@@ -226,14 +253,16 @@ static int dwmci_send_cmd(struct mmc *mmc, struct mmc_cmd *cmd,
 {
 #endif
 	struct dwmci_host *host = mmc->priv;
-	ALLOC_CACHE_ALIGN_BUFFER(struct dwmci_idmac, cur_idmac,
-				 data ? DIV_ROUND_UP(data->blocks, 8) : 0);
+	struct dwmci_idmac *cur_idmac;
 	int ret = 0, flags = 0, i;
 	unsigned int timeout = 500;
 	u32 retry = 100000;
 	u32 mask, ctrl;
 	ulong start = get_timer(0);
 	struct bounce_buffer bbstate;
+	bool direct = false;
+	void *buf;
+	ulong len = 0;
 
 	while (dwmci_readl(host, DWMCI_STATUS) & DWMCI_BUSY) {
 		if (get_timer(start) > timeout) {
@@ -251,17 +280,33 @@ static int dwmci_send_cmd(struct mmc *mmc, struct mmc_cmd *cmd,
 				     data->blocksize * data->blocks);
 			dwmci_wait_reset(host, DWMCI_CTRL_FIFO_RESET);
 		} else {
-			if (data->flags == MMC_DATA_READ) {
+			cur_idmac = dwmci_get_idmac(host,
+					DIV_ROUND_UP(data->blocks, 8));
+			if (!cur_idmac)
+				return -ENOMEM;
+
+			len = data->blocksize * data->blocks;
+			if (data->flags == MMC_DATA_READ &&
+			    IS_ALIGNED((ulong)data->dest, ARCH_DMA_MINALIGN) &&
+			    IS_ALIGNED(len, ARCH_DMA_MINALIGN)) {
+				/*
+				 * DMA overwrites the whole buffer, so there is
+				 * no need to write back the cache first
+				 */
+				direct = true;
+				buf = data->dest;
+				invalidate_dcache_range((ulong)buf,
+							(ulong)buf + len);
+			} else if (data->flags == MMC_DATA_READ) {
 				bounce_buffer_start(&bbstate, (void*)data->dest,
-						data->blocksize *
-						data->blocks, GEN_BB_WRITE);
+						len, GEN_BB_WRITE);
+				buf = bbstate.bounce_buffer;
 			} else {
 				bounce_buffer_start(&bbstate, (void*)data->src,
-						data->blocksize *
-						data->blocks, GEN_BB_READ);
+						len, GEN_BB_READ);
+				buf = bbstate.bounce_buffer;
 			}
-			dwmci_prepare_data(host, data, cur_idmac,
-					   bbstate.bounce_buffer);
+			dwmci_prepare_data(host, data, cur_idmac, buf);
 		}
 	}
 
@@ -359,7 +404,12 @@ static int dwmci_send_cmd(struct mmc *mmc, struct mmc_cmd *cmd,
 			ctrl = dwmci_readl(host, DWMCI_CTRL);
 			ctrl &= ~(DWMCI_DMA_EN);
 			dwmci_writel(host, DWMCI_CTRL, ctrl);
-			bounce_buffer_stop(&bbstate);
+			if (direct)
+				invalidate_dcache_range((ulong)data->dest,
+							(ulong)data->dest +
+							len);
+			else
+				bounce_buffer_stop(&bbstate);
 		}
 	}
 
@@ -524,9 +574,38 @@ int dwmci_probe(struct udevice *dev)
 	return dwmci_init(mmc);
 }
 
+int dwmci_remove(struct udevice *dev)
+{
+	struct mmc *mmc = mmc_get_mmc_dev(dev);
+	struct dwmci_host *host = mmc->priv;
+
+	/* Free the descriptor chain kept by dwmci_get_idmac() */
+	free(host->idmac);
+	host->idmac = NULL;
+	host->idmac_count = 0;
+
+	return 0;
+}
+
+#ifdef MMC_SUPPORTS_TUNING
+static int dwmci_execute_tuning(struct udevice *dev, uint opcode)
+{
+	struct mmc *mmc = mmc_get_mmc_dev(dev);
+	struct dwmci_host *host = mmc->priv;
+
+	if (!host->execute_tuning)
+		return -ENOSYS;
+
+	return host->execute_tuning(host, opcode);
+}
+#endif
+
 const struct dm_mmc_ops dm_dwmci_ops = {
 	.send_cmd	= dwmci_send_cmd,
 	.set_ios	= dwmci_set_ios,
+#ifdef MMC_SUPPORTS_TUNING
+	.execute_tuning	= dwmci_execute_tuning,
+#endif
 };
 
 #else
@@ -562,7 +641,7 @@ void dwmci_setup_cfg(struct mmc_config *cfg, struct dwmci_host *host,
 	if (host->quirks & DWMCI_QUIRK_MMC_8BIT_CAP)
 		cfg->host_caps |= MMC_MODE_8BIT;
 
-	cfg->host_caps |= MMC_MODE_HS | MMC_MODE_HS_52MHz;
+	cfg->host_caps |= MMC_MODE_HS | MMC_MODE_HS_52MHz | MMC_CAP_CMD23;
 
 	cfg->b_max = CONFIG_SYS_MMC_MAX_BLK_COUNT;
 }
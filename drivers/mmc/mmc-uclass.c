@@ -243,10 +243,11 @@ void mmc_do_preinit(void)
 
 		if (!m)
 			continue;
-#ifdef CONFIG_FSL_ESDHC_ADAPTER_IDENT
+#if defined(CONFIG_FSL_ESDHC_ADAPTER_IDENT) || \
+	CONFIG_IS_ENABLED(MMC_ASYNC_INIT)
 		mmc_set_preinit(m, 1);
 #endif
-		if (m->preinit)
+		if (m->preinit && !m->init_in_progress && !m->has_init)
 			mmc_start_init(m);
 	}
 }
@@ -255,19 +256,27 @@ void mmc_do_preinit(void)
 void print_mmc_devices(char separator)
 {
 	struct udevice *dev;
+	struct uclass *uc;
 	char *mmc_type;
 	bool first = true;
+	struct mmc *m;
 
-	for (uclass_first_device(UCLASS_MMC, &dev);
-	     dev;
-	     uclass_next_device(&dev), first = false) {
-		struct mmc *m = mmc_get_mmc_dev(dev);
-
+	if (uclass_get(UCLASS_MMC, &uc))
+		return;
+	uclass_foreach_dev(dev, uc) {
+		if (!device_is_deferred(dev) && device_probe(dev))
+			continue;
 		if (!first) {
 			printf("%c", separator);
 			if (separator != '\n')
 				puts(" ");
 		}
+		first = false;
+		if (device_is_deferred(dev)) {
+			printf("%s (deferred)", dev->name);
+			continue;
+		}
+		m = mmc_get_mmc_dev(dev);
 		if (m->has_init)
 			mmc_type = IS_SD(m) ? "SD" : "eMMC";
 		else
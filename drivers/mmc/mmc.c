@@ -11,6 +11,7 @@
 #include <command.h>
 #include <dm.h>
 #include <dm/device-internal.h>
+#include <dm/uclass-internal.h>
 #include <errno.h>
 #include <mmc.h>
 #include <part.h>
@@ -27,6 +28,36 @@ static int mmc_power_cycle(struct mmc *mmc);
 static int mmc_select_mode_and_width(struct mmc *mmc, uint card_caps);
 #endif
 
+/* Check whether the registers cached by the last init can be reused */
+static bool mmc_init_cached(struct mmc *mmc)
+{
+#if CONFIG_IS_ENABLED(MMC_INIT_CACHE)
+	return mmc->init_cached;
+#else
+	return false;
+#endif
+}
+
+static void mmc_init_cache_drop(struct mmc *mmc)
+{
+#if CONFIG_IS_ENABLED(MMC_INIT_CACHE)
+	mmc->init_cached = false;
+#endif
+}
+
+/*
+ * Check whether the mode being selected is the one which worked for this card
+ * last time, so that reading back EXT_CSD to check it can be skipped
+ */
+static inline bool mmc_reusing_mode(struct mmc *mmc)
+{
+#if CONFIG_IS_ENABLED(MMC_INIT_CACHE)
+	return mmc->reusing_mode;
+#else
+	return false;
+#endif
+}
+
 #if !CONFIG_IS_ENABLED(DM_MMC)
 
 #if CONFIG_IS_ENABLED(MMC_UHS_SUPPORT)
@@ -358,6 +389,21 @@ static int mmc_read_blocks(struct mmc *mmc, void *dst, lbaint_t start,
 {
 	struct mmc_cmd cmd;
 	struct mmc_data data;
+	bool sbc;
+
+	/*
+	 * With SET_BLOCK_COUNT the card stops by itself at the end of the
+	 * transfer, saving the STOP_TRANSMISSION command
+	 */
+	sbc = blkcnt > 1 && blkcnt <= 0xffff &&
+	      (mmc->card_caps & mmc->host_caps & MMC_CAP_CMD23);
+	if (sbc) {
+		cmd.cmdidx = MMC_CMD_SET_BLOCK_COUNT;
+		cmd.cmdarg = blkcnt;
+		cmd.resp_type = MMC_RSP_R1;
+		if (mmc_send_cmd(mmc, &cmd, NULL))
+			return 0;
+	}
 
 	if (blkcnt > 1)
 		cmd.cmdidx = MMC_CMD_READ_MULTIPLE_BLOCK;
@@ -379,7 +425,7 @@ static int mmc_read_blocks(struct mmc *mmc, void *dst, lbaint_t start,
 	if (mmc_send_cmd(mmc, &cmd, &data))
 		return 0;
 
-	if (blkcnt > 1) {
+	if (blkcnt > 1 && !sbc) {
 		cmd.cmdidx = MMC_CMD_STOP_TRANSMISSION;
 		cmd.cmdarg = 0;
 		cmd.resp_type = MMC_RSP_R1b;
@@ -534,57 +580,65 @@ static int mmc_switch_voltage(struct mmc *mmc, int signal_voltage)
 }
 #endif
 
-static int sd_send_op_cond(struct mmc *mmc, bool uhs_en)
+static int sd_send_op_cond_iter(struct mmc *mmc, bool uhs_en)
 {
-	int timeout = 1000;
-	int err;
 	struct mmc_cmd cmd;
+	int err;
 
-	while (1) {
-		cmd.cmdidx = MMC_CMD_APP_CMD;
-		cmd.resp_type = MMC_RSP_R1;
-		cmd.cmdarg = 0;
+	cmd.cmdidx = MMC_CMD_APP_CMD;
+	cmd.resp_type = MMC_RSP_R1;
+	cmd.cmdarg = 0;
 
-		err = mmc_send_cmd(mmc, &cmd, NULL);
+	err = mmc_send_cmd(mmc, &cmd, NULL);
 
-		if (err)
-			return err;
+	if (err)
+		return err;
 
-		cmd.cmdidx = SD_CMD_APP_SEND_OP_COND;
-		cmd.resp_type = MMC_RSP_R3;
+	cmd.cmdidx = SD_CMD_APP_SEND_OP_COND;
+	cmd.resp_type = MMC_RSP_R3;
 
-		/*
-		 * Most cards do not answer if some reserved bits
-		 * in the ocr are set. However, Some controller
-		 * can set bit 7 (reserved for low voltages), but
-		 * how to manage low voltages SD card is not yet
-		 * specified.
-		 */
-		cmd.cmdarg = mmc_host_is_spi(mmc) ? 0 :
-			(mmc->cfg->voltages & 0xff8000);
+	/*
+	 * Most cards do not answer if some reserved bits
+	 * in the ocr are set. However, Some controller
+	 * can set bit 7 (reserved for low voltages), but
+	 * how to manage low voltages SD card is not yet
+	 * specified.
+	 */
+	cmd.cmdarg = mmc_host_is_spi(mmc) ? 0 :
+		(mmc->cfg->voltages & 0xff8000);
 
-		if (mmc->version == SD_VERSION_2)
-			cmd.cmdarg |= OCR_HCS;
+	if (mmc->version == SD_VERSION_2)
+		cmd.cmdarg |= OCR_HCS;
 
-		if (uhs_en)
-			cmd.cmdarg |= OCR_S18R;
+	if (uhs_en)
+		cmd.cmdarg |= OCR_S18R;
 
-		err = mmc_send_cmd(mmc, &cmd, NULL);
+	err = mmc_send_cmd(mmc, &cmd, NULL);
 
-		if (err)
-			return err;
+	if (err)
+		return err;
 
-		if (cmd.response[0] & OCR_BUSY)
-			break;
+	mmc->ocr = cmd.response[0];
+	return 0;
+}
+
+static int sd_complete_op_cond(struct mmc *mmc, bool uhs_en)
+{
+	int timeout = 1000;
+	int err;
+	struct mmc_cmd cmd;
 
+	mmc->op_cond_pending = 0;
+	while (!(mmc->ocr & OCR_BUSY)) {
 		if (timeout-- <= 0)
 			return -EOPNOTSUPP;
 
 		udelay(1000);
-	}
 
-	if (mmc->version != SD_VERSION_2)
-		mmc->version = SD_VERSION_1_0;
+		err = sd_send_op_cond_iter(mmc, uhs_en);
+		if (err)
+			return err;
+	}
 
 	if (mmc_host_is_spi(mmc)) { /* read OCR for spi */
 		cmd.cmdidx = MMC_CMD_SPI_READ_OCR;
@@ -595,12 +649,12 @@ static int sd_send_op_cond(struct mmc *mmc, bool uhs_en)
 
 		if (err)
 			return err;
-	}
 
-	mmc->ocr = cmd.response[0];
+		mmc->ocr = cmd.response[0];
+	}
 
 #if CONFIG_IS_ENABLED(MMC_UHS_SUPPORT)
-	if (uhs_en && !(mmc_host_is_spi(mmc)) && (cmd.response[0] & 0x41000000)
+	if (uhs_en && !(mmc_host_is_spi(mmc)) && (mmc->ocr & 0x41000000)
 	    == 0x41000000) {
 		err = mmc_switch_voltage(mmc, MMC_SIGNAL_VOLTAGE_180);
 		if (err)
@@ -614,6 +668,31 @@ static int sd_send_op_cond(struct mmc *mmc, bool uhs_en)
 	return 0;
 }
 
+static int sd_send_op_cond(struct mmc *mmc, bool uhs_en)
+{
+	int err;
+
+	err = sd_send_op_cond_iter(mmc, uhs_en);
+	if (err)
+		return err;
+
+	if (mmc->version != SD_VERSION_2)
+		mmc->version = SD_VERSION_1_0;
+
+	/*
+	 * With MMC_ASYNC_INIT, let the card power up while other things are
+	 * done, as for MMC. The voltage switch must follow straight on, so
+	 * not with UHS. Otherwise wait for the card here, as before.
+	 */
+	if (CONFIG_IS_ENABLED(MMC_ASYNC_INIT) && !(mmc->ocr & OCR_BUSY) &&
+	    !uhs_en) {
+		mmc->op_cond_pending = 1;
+		return 0;
+	}
+
+	return sd_complete_op_cond(mmc, uhs_en);
+}
+
 static int mmc_send_op_cond_iter(struct mmc *mmc, int use_arg)
 {
 	struct mmc_cmd cmd;
@@ -652,6 +731,7 @@ static int mmc_send_op_cond(struct mmc *mmc)
 		if (mmc->ocr & OCR_BUSY)
 			break;
 	}
+	mmc->version = MMC_VERSION_UNKNOWN;
 	mmc->op_cond_pending = 1;
 	return 0;
 }
@@ -746,6 +826,11 @@ static int __mmc_switch(struct mmc *mmc, u8 set, u8 index, u8 value,
 			continue;
 		}
 
+#if CONFIG_IS_ENABLED(MMC_INIT_CACHE)
+		/* Keep the cached copy in step with the card */
+		if (mmc->ext_csd)
+			mmc->ext_csd[index] = value;
+#endif
 		if (!send_status) {
 			mdelay(50);
 			return 0;
@@ -815,7 +900,7 @@ static int mmc_set_card_speed(struct mmc *mmc, enum bus_mode mode,
 	}
 #endif
 
-	if ((mode == MMC_HS) || (mode == MMC_HS_52)) {
+	if ((mode == MMC_HS || mode == MMC_HS_52) && !mmc_reusing_mode(mmc)) {
 		/* Now check to see that it worked */
 		err = mmc_send_ext_csd(mmc, test_csd);
 		if (err)
@@ -839,6 +924,9 @@ static int mmc_get_capabilities(struct mmc *mmc)
 	if (mmc_host_is_spi(mmc))
 		return 0;
 
+	if (mmc->version >= MMC_VERSION_3)
+		mmc->card_caps |= MMC_CAP_CMD23;
+
 	/* Only version 4 supports high-speed */
 	if (mmc->version < MMC_VERSION_4)
 		return 0;
@@ -1153,6 +1241,9 @@ int mmc_hwpart_config(struct mmc *mmc,
 	if (err)
 		return err;
 
+	/* The card reports the new partitions after the power cycle */
+	mmc_init_cache_drop(mmc);
+
 	return 0;
 }
 #endif
@@ -1266,6 +1357,8 @@ retry_scr:
 
 	if (mmc->scr[0] & SD_DATA_4BIT)
 		mmc->card_caps |= MMC_MODE_4BIT;
+	if (mmc->scr[0] & SD_CMD23_SUPPORT)
+		mmc->card_caps |= MMC_CAP_CMD23;
 
 	/* Version 1.0 doesn't support switching */
 	if (mmc->version == SD_VERSION_1_0)
@@ -1748,7 +1841,7 @@ static int mmc_read_and_compare_ext_csd(struct mmc *mmc)
 	const u8 *ext_csd = mmc->ext_csd;
 	ALLOC_CACHE_ALIGN_BUFFER(u8, test_csd, MMC_MAX_BLOCK_LEN);
 
-	if (mmc->version < MMC_VERSION_4)
+	if (mmc->version < MMC_VERSION_4 || mmc_reusing_mode(mmc))
 		return 0;
 
 	err = mmc_send_ext_csd(mmc, test_csd);
@@ -2045,6 +2138,41 @@ error:
 
 	return -ENOTSUPP;
 }
+
+/* Select the mode and bus width used when this card was last initialised */
+static int mmc_select_cached_mode(struct mmc *mmc)
+{
+#if CONFIG_IS_ENABLED(MMC_INIT_CACHE)
+	uint caps = MMC_CAP(mmc->cached_mode);
+	int ret;
+
+	switch (mmc->cached_bus_width) {
+	case 8:
+		caps |= MMC_MODE_8BIT;
+		break;
+	case 4:
+		caps |= MMC_MODE_4BIT;
+		break;
+	default:
+		caps |= MMC_MODE_1BIT;
+		break;
+	}
+
+	if (IS_SD(mmc)) {
+		/* This is set from the SCR, which is not read again */
+		mmc->version = mmc->cached_version;
+		return sd_select_mode_and_width(mmc, caps);
+	}
+
+	mmc->reusing_mode = true;
+	ret = mmc_select_mode_and_width(mmc, caps);
+	mmc->reusing_mode = false;
+
+	return ret;
+#else
+	return -ENOSYS;
+#endif
+}
 #endif
 
 #if CONFIG_IS_ENABLED(MMC_TINY)
@@ -2092,16 +2220,25 @@ static int mmc_startup_v4(struct mmc *mmc)
 		return 0;
 
 	/* check  ext_csd version and capacity */
-	err = mmc_send_ext_csd(mmc, ext_csd);
-	if (err)
-		goto error;
+	if (mmc_init_cached(mmc) && mmc->ext_csd) {
+		/* The card was reset, which put these back to their defaults */
+		mmc->ext_csd[EXT_CSD_ERASE_GROUP_DEF] = 0;
+		mmc->ext_csd[EXT_CSD_PART_CONF] &= ~PART_ACCESS_MASK;
+		mmc->ext_csd[EXT_CSD_BUS_WIDTH] = EXT_CSD_BUS_WIDTH_1;
+		mmc->ext_csd[EXT_CSD_HS_TIMING] = EXT_CSD_TIMING_LEGACY;
+		memcpy(ext_csd, mmc->ext_csd, MMC_MAX_BLOCK_LEN);
+	} else {
+		err = mmc_send_ext_csd(mmc, ext_csd);
+		if (err)
+			goto error;
 
-	/* store the ext csd for future reference */
-	if (!mmc->ext_csd)
-		mmc->ext_csd = malloc(MMC_MAX_BLOCK_LEN);
-	if (!mmc->ext_csd)
-		return -ENOMEM;
-	memcpy(mmc->ext_csd, ext_csd, MMC_MAX_BLOCK_LEN);
+		/* store the ext csd for future reference */
+		if (!mmc->ext_csd)
+			mmc->ext_csd = malloc(MMC_MAX_BLOCK_LEN);
+		if (!mmc->ext_csd)
+			return -ENOMEM;
+		memcpy(mmc->ext_csd, ext_csd, MMC_MAX_BLOCK_LEN);
+	}
 #endif
 	if (ext_csd[EXT_CSD_REV] >= ARRAY_SIZE(mmc_versions))
 		return -EINVAL;
@@ -2294,6 +2431,9 @@ static int mmc_startup(struct mmc *mmc)
 	if (err)
 		return err;
 
+	/* The cached registers are only any use for the same card */
+	if (memcmp(mmc->cid, cmd.response, 16))
+		mmc_init_cache_drop(mmc);
 	memcpy(mmc->cid, cmd.response, 16);
 
 	/*
@@ -2316,22 +2456,24 @@ static int mmc_startup(struct mmc *mmc)
 	}
 
 	/* Get the Card-Specific Data */
-	cmd.cmdidx = MMC_CMD_SEND_CSD;
-	cmd.resp_type = MMC_RSP_R2;
-	cmd.cmdarg = mmc->rca << 16;
+	if (!mmc_init_cached(mmc)) {
+		cmd.cmdidx = MMC_CMD_SEND_CSD;
+		cmd.resp_type = MMC_RSP_R2;
+		cmd.cmdarg = mmc->rca << 16;
 
-	err = mmc_send_cmd(mmc, &cmd, NULL);
+		err = mmc_send_cmd(mmc, &cmd, NULL);
 
-	if (err)
-		return err;
+		if (err)
+			return err;
 
-	mmc->csd[0] = cmd.response[0];
-	mmc->csd[1] = cmd.response[1];
-	mmc->csd[2] = cmd.response[2];
-	mmc->csd[3] = cmd.response[3];
+		mmc->csd[0] = cmd.response[0];
+		mmc->csd[1] = cmd.response[1];
+		mmc->csd[2] = cmd.response[2];
+		mmc->csd[3] = cmd.response[3];
+	}
 
 	if (mmc->version == MMC_VERSION_UNKNOWN) {
-		int version = (cmd.response[0] >> 26) & 0xf;
+		int version = (mmc->csd[0] >> 26) & 0xf;
 
 		switch (version) {
 		case 0:
@@ -2356,20 +2498,20 @@ static int mmc_startup(struct mmc *mmc)
 	}
 
 	/* divide frequency by 10, since the mults are 10x bigger */
-	freq = fbase[(cmd.response[0] & 0x7)];
-	mult = multipliers[((cmd.response[0] >> 3) & 0xf)];
+	freq = fbase[(mmc->csd[0] & 0x7)];
+	mult = multipliers[((mmc->csd[0] >> 3) & 0xf)];
 
 	mmc->legacy_speed = freq * mult;
 	mmc_select_mode(mmc, MMC_LEGACY);
 
-	mmc->dsr_imp = ((cmd.response[1] >> 12) & 0x1);
-	mmc->read_bl_len = 1 << ((cmd.response[1] >> 16) & 0xf);
+	mmc->dsr_imp = ((mmc->csd[1] >> 12) & 0x1);
+	mmc->read_bl_len = 1 << ((mmc->csd[1] >> 16) & 0xf);
 #if CONFIG_IS_ENABLED(MMC_WRITE)
 
 	if (IS_SD(mmc))
 		mmc->write_bl_len = mmc->read_bl_len;
 	else
-		mmc->write_bl_len = 1 << ((cmd.response[3] >> 22) & 0xf);
+		mmc->write_bl_len = 1 << ((mmc->csd[3] >> 22) & 0xf);
 #endif
 
 	if (mmc->high_capacity) {
@@ -2437,7 +2579,10 @@ static int mmc_startup(struct mmc *mmc)
 	mmc_select_mode(mmc, IS_SD(mmc) ? SD_LEGACY : MMC_LEGACY);
 	mmc_set_bus_width(mmc, 1);
 #else
-	if (IS_SD(mmc)) {
+	if (mmc_init_cached(mmc) && !mmc_select_cached_mode(mmc)) {
+		pr_debug("%s: reusing mode %s width %d\n", __func__,
+			 mmc_mode_name(mmc->selected_mode), mmc->bus_width);
+	} else if (IS_SD(mmc)) {
 		err = sd_get_capabilities(mmc);
 		if (err)
 			return err;
@@ -2453,6 +2598,12 @@ static int mmc_startup(struct mmc *mmc)
 		return err;
 
 	mmc->best_mode = mmc->selected_mode;
+#if CONFIG_IS_ENABLED(MMC_INIT_CACHE)
+	mmc->cached_mode = mmc->selected_mode;
+	mmc->cached_bus_width = mmc->bus_width;
+	mmc->cached_version = mmc->version;
+	mmc->init_cached = true;
+#endif
 
 	/* Fix the block length for DDR mode */
 	if (mmc->ddr_mode) {
@@ -2744,15 +2895,21 @@ static int mmc_complete_init(struct mmc *mmc)
 	int err = 0;
 
 	mmc->init_in_progress = 0;
-	if (mmc->op_cond_pending)
-		err = mmc_complete_op_cond(mmc);
+	if (mmc->op_cond_pending) {
+		if (IS_SD(mmc))
+			err = sd_complete_op_cond(mmc, false);
+		else
+			err = mmc_complete_op_cond(mmc);
+	}
 
 	if (!err)
 		err = mmc_startup(mmc);
-	if (err)
+	if (err) {
 		mmc->has_init = 0;
-	else
+		mmc_init_cache_drop(mmc);
+	} else {
 		mmc->has_init = 1;
+	}
 	return err;
 }
 
@@ -2845,13 +3002,22 @@ static int mmc_probe(bd_t *bis)
 	 * Try to add them in sequence order. Really with driver model we
 	 * should allow holes, but the current MMC list does not allow that.
 	 * So if we request 0, 1, 3 we will get 0, 1, 2.
+	 *
+	 * Devices marked for deferred probe are left until first used.
 	 */
 	for (i = 0; ; i++) {
-		ret = uclass_get_device_by_seq(UCLASS_MMC, i, &dev);
+		ret = uclass_find_device_by_seq(UCLASS_MMC, i, false, &dev);
+		if (ret == -ENODEV)
+			ret = uclass_find_device_by_seq(UCLASS_MMC, i, true,
+							&dev);
 		if (ret == -ENODEV)
 			break;
+		if (!ret && !device_is_deferred(dev))
+			device_probe(dev);
 	}
 	uclass_foreach_dev(dev, uc) {
+		if (device_is_deferred(dev))
+			continue;
 		ret = device_probe(dev);
 		if (ret)
 			pr_err("%s - probe failed: %d\n", dev->name, ret);
@@ -2869,20 +3035,45 @@ static int mmc_probe(bd_t *bis)
 }
 #endif
 
-int mmc_initialize(bd_t *bis)
+static int mmc_probe_once(bd_t *bis)
 {
-	static int initialized = 0;
-	int ret;
-	if (initialized)	/* Avoid initializing mmc multiple times */
+	static int probed;
+
+	if (probed)
 		return 0;
-	initialized = 1;
+	probed = 1;
 
 #if !CONFIG_IS_ENABLED(BLK)
 #if !CONFIG_IS_ENABLED(MMC_TINY)
 	mmc_list_init();
 #endif
 #endif
-	ret = mmc_probe(bis);
+	return mmc_probe(bis);
+}
+
+#if CONFIG_IS_ENABLED(MMC_ASYNC_INIT)
+int mmc_start_async_init(bd_t *bis)
+{
+	int ret;
+
+	ret = mmc_probe_once(bis);
+	if (ret)
+		return ret;
+
+	mmc_do_preinit();
+	return 0;
+}
+#endif
+
+int mmc_initialize(bd_t *bis)
+{
+	static int initialized = 0;
+	int ret;
+	if (initialized)	/* Avoid initializing mmc multiple times */
+		return 0;
+	initialized = 1;
+
+	ret = mmc_probe_once(bis);
 	if (ret)
 		return ret;
 
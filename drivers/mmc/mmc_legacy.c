@@ -22,10 +22,11 @@ struct mmc *find_mmc_device(int dev_num)
 void mmc_do_preinit(void)
 {
 	struct mmc *m = &mmc_static;
-#ifdef CONFIG_FSL_ESDHC_ADAPTER_IDENT
+#if defined(CONFIG_FSL_ESDHC_ADAPTER_IDENT) || \
+	CONFIG_IS_ENABLED(MMC_ASYNC_INIT)
 	mmc_set_preinit(m, 1);
 #endif
-	if (m->preinit)
+	if (m->preinit && !m->init_in_progress && !m->has_init)
 		mmc_start_init(m);
 }
 
@@ -76,10 +77,11 @@ void mmc_do_preinit(void)
 	list_for_each(entry, &mmc_devices) {
 		m = list_entry(entry, struct mmc, link);
 
-#ifdef CONFIG_FSL_ESDHC_ADAPTER_IDENT
+#if defined(CONFIG_FSL_ESDHC_ADAPTER_IDENT) || \
+	CONFIG_IS_ENABLED(MMC_ASYNC_INIT)
 		mmc_set_preinit(m, 1);
 #endif
-		if (m->preinit)
+		if (m->preinit && !m->init_in_progress && !m->has_init)
 			mmc_start_init(m);
 	}
 }
@@ -9,30 +9,70 @@
 #include <errno.h>
 #include <fdtdec.h>
 #include <mmc.h>
+#include <linux/sizes.h>
 #include <asm/test.h>
+#include <asm/unaligned.h>
+
+/* Number of ACMD41/CMD1 commands after CMD0 before the card is powered up */
+#define SANDBOX_MMC_POWERUP_CMDS	3
+
+/* Number of command indexes, as counted by sandbox_mmc_get_cmd_count() */
+#define SANDBOX_MMC_CMDS		64
 
 struct sandbox_mmc_plat {
 	struct mmc_config cfg;
 	struct mmc mmc;
+	int op_cond_count;	/* Number of ACMD41/CMD1 commands since CMD0 */
+	bool emmc;		/* Emulate an eMMC device instead of an SD card */
+	u8 ext_csd[MMC_MAX_BLOCK_LEN];	/* eMMC EXT_CSD register */
+	int cmd_count[SANDBOX_MMC_CMDS];	/* Number of each command sent */
 };
 
 /**
- * sandbox_mmc_send_cmd() - Emulate SD commands
+ * sandbox_mmc_send_cmd() - Emulate SD/MMC commands
  *
- * This emulate an SD card version 2. Single-block reads result in zero data.
- * Multiple-block reads return a test string.
+ * This emulate an SD card version 2 or, with the sandbox,emmc property, an
+ * eMMC device version 5.1. Single-block reads result in zero data.
+ * Multiple-block reads return a test string. Like a real card, it takes a
+ * few ACMD41 (or CMD1) commands to power up.
  */
 static int sandbox_mmc_send_cmd(struct udevice *dev, struct mmc_cmd *cmd,
 				struct mmc_data *data)
 {
+	struct sandbox_mmc_plat *plat = dev_get_platdata(dev);
+
+	if (cmd->cmdidx < SANDBOX_MMC_CMDS)
+		plat->cmd_count[cmd->cmdidx]++;
+
 	switch (cmd->cmdidx) {
 	case MMC_CMD_ALL_SEND_CID:
+		memset(cmd->response, '\0', sizeof(cmd->response));
 		break;
 	case SD_CMD_SEND_RELATIVE_ADDR:
 		cmd->response[0] = 0 << 16; /* mmc->rca */
+		break;
 	case MMC_CMD_GO_IDLE_STATE:
+		plat->op_cond_count = 0;
+		/* These go back to their power-on values */
+		plat->ext_csd[EXT_CSD_ERASE_GROUP_DEF] = 0;
+		plat->ext_csd[EXT_CSD_PART_CONF] &= ~PART_ACCESS_MASK;
+		plat->ext_csd[EXT_CSD_BUS_WIDTH] = EXT_CSD_BUS_WIDTH_1;
+		plat->ext_csd[EXT_CSD_HS_TIMING] = EXT_CSD_TIMING_LEGACY;
+		break;
+	case MMC_CMD_SEND_OP_COND:
+		if (!plat->emmc)
+			return -ETIMEDOUT;
+		cmd->response[0] = OCR_HCS;
+		if (++plat->op_cond_count >= SANDBOX_MMC_POWERUP_CMDS)
+			cmd->response[0] |= OCR_BUSY;
 		break;
-	case SD_CMD_SEND_IF_COND:
+	case SD_CMD_SEND_IF_COND:	/* or MMC_CMD_SEND_EXT_CSD */
+		if (plat->emmc) {
+			if (!data)
+				return -ETIMEDOUT;
+			memcpy(data->dest, plat->ext_csd, MMC_MAX_BLOCK_LEN);
+			break;
+		}
 		cmd->response[0] = 0xaa;
 		break;
 	case MMC_CMD_SEND_STATUS:
@@ -41,10 +81,16 @@ static int sandbox_mmc_send_cmd(struct udevice *dev, struct mmc_cmd *cmd,
 	case MMC_CMD_SELECT_CARD:
 		break;
 	case MMC_CMD_SEND_CSD:
-		cmd->response[0] = 0;
+		/* eMMC devices have version 4 of the spec, for EXT_CSD */
+		cmd->response[0] = plat->emmc ? 4 << 26 : 0;
 		cmd->response[1] = 10 << 16;	/* 1 << block_len */
 		break;
-	case SD_CMD_SWITCH_FUNC: {
+	case SD_CMD_SWITCH_FUNC: {	/* or MMC_CMD_SWITCH */
+		if (plat->emmc) {
+			plat->ext_csd[(cmd->cmdarg >> 16) & 0xff] =
+				(cmd->cmdarg >> 8) & 0xff;
+			break;
+		}
 		if (!data)
 			break;
 		u32 *resp = (u32 *)data->dest;
@@ -60,13 +106,18 @@ static int sandbox_mmc_send_cmd(struct udevice *dev, struct mmc_cmd *cmd,
 		strcpy(data->dest, "this is a test");
 		break;
 	case MMC_CMD_STOP_TRANSMISSION:
+	case MMC_CMD_SET_BLOCK_COUNT:
 		break;
 	case SD_CMD_APP_SEND_OP_COND:
-		cmd->response[0] = OCR_BUSY | OCR_HCS;
+		cmd->response[0] = OCR_HCS;
+		if (++plat->op_cond_count >= SANDBOX_MMC_POWERUP_CMDS)
+			cmd->response[0] |= OCR_BUSY;
 		cmd->response[1] = 0;
 		cmd->response[2] = 0;
 		break;
 	case MMC_CMD_APP_CMD:
+		if (plat->emmc)
+			return -ETIMEDOUT;
 		break;
 	case MMC_CMD_SET_BLOCKLEN:
 		debug("block len %d\n", cmd->cmdarg);
@@ -101,6 +152,13 @@ static const struct dm_mmc_ops sandbox_mmc_ops = {
 	.get_cd = sandbox_mmc_get_cd,
 };
 
+int sandbox_mmc_get_cmd_count(struct udevice *dev, uint cmdidx)
+{
+	struct sandbox_mmc_plat *plat = dev_get_platdata(dev);
+
+	return cmdidx < SANDBOX_MMC_CMDS ? plat->cmd_count[cmdidx] : 0;
+}
+
 int sandbox_mmc_probe(struct udevice *dev)
 {
 	struct sandbox_mmc_plat *plat = dev_get_platdata(dev);
@@ -114,12 +172,25 @@ int sandbox_mmc_bind(struct udevice *dev)
 	struct mmc_config *cfg = &plat->cfg;
 
 	cfg->name = dev->name;
-	cfg->host_caps = MMC_MODE_HS_52MHz | MMC_MODE_HS | MMC_MODE_8BIT;
+	cfg->host_caps = MMC_MODE_HS_52MHz | MMC_MODE_HS | MMC_MODE_8BIT |
+			 MMC_CAP_CMD23;
 	cfg->voltages = MMC_VDD_165_195 | MMC_VDD_32_33 | MMC_VDD_33_34;
 	cfg->f_min = 1000000;
 	cfg->f_max = 52000000;
 	cfg->b_max = U32_MAX;
 
+	plat->emmc = dev_read_bool(dev, "sandbox,emmc");
+	if (plat->emmc) {
+		u8 *ext_csd = plat->ext_csd;
+		u32 sectors = SZ_4G / MMC_MAX_BLOCK_LEN;
+
+		ext_csd[EXT_CSD_REV] = 8;	/* v5.1 */
+		ext_csd[EXT_CSD_BOOT_MULT] = 1;	/* 128KiB boot partitions */
+		ext_csd[EXT_CSD_CARD_TYPE] = EXT_CSD_CARD_TYPE_26 |
+					     EXT_CSD_CARD_TYPE_52;
+		put_unaligned_le32(sectors, &ext_csd[EXT_CSD_SEC_CNT]);
+	}
+
 	return mmc_bind(dev, &plat->mmc, cfg);
 }
 
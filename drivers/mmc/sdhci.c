@@ -19,6 +19,107 @@ void *aligned_buffer = (void *)CONFIG_FIXED_SDHCI_ALIGNED_BUFFER;
 void *aligned_buffer;
 #endif
 
+#if CONFIG_IS_ENABLED(MMC_SDHCI_ADMA)
+/* ADMA2 descriptor attributes */
+#define ADMA_DESC_ATTR_VALID	BIT(0)
+#define ADMA_DESC_ATTR_END	BIT(1)
+#define ADMA_DESC_TRANSFER_DATA	BIT(5)
+
+#define ADMA_DESC32_LEN		8
+#define ADMA_DESC64_LEN		12
+
+/* Largest length of one descriptor, keeping the next address aligned */
+#define ADMA_MAX_LEN		65532
+
+struct sdhci_adma_desc {
+	u8 attr;
+	u8 reserved;
+	__le16 len;
+	__le32 addr_lo;
+	__le32 addr_hi;		/* 64-bit descriptors only */
+} __packed;
+
+static int sdhci_adma_init(struct mmc *mmc, struct sdhci_host *host)
+{
+	u32 caps = sdhci_readl(host, SDHCI_CAPABILITIES);
+	uint count, size;
+
+	if (host->adma_desc || !(caps & SDHCI_CAN_DO_ADMA2) ||
+	    (host->quirks & SDHCI_QUIRK_BROKEN_ADMA))
+		return 0;
+
+	host->adma64 = IS_ENABLED(CONFIG_DMA_ADDR_T_64BIT) &&
+		       (caps & SDHCI_CAN_64BIT);
+
+	/* Enough descriptors for the largest transfer the core will send */
+	count = DIV_ROUND_UP(mmc->cfg->b_max * 512, ADMA_MAX_LEN);
+	size = count * (host->adma64 ? ADMA_DESC64_LEN : ADMA_DESC32_LEN);
+	host->adma_desc = memalign(ARCH_DMA_MINALIGN,
+				   ALIGN(size, ARCH_DMA_MINALIGN));
+	if (!host->adma_desc) {
+		printf("%s: ADMA descriptor alloc failed!!!\n", __func__);
+		return -ENOMEM;
+	}
+	host->adma_max_len = count * ADMA_MAX_LEN;
+
+	return 0;
+}
+
+/*
+ * Describe the transfer of @len bytes at @addr in the descriptor table and
+ * point the controller at it. This returns false if ADMA cannot be used, in
+ * which case the caller falls back to SDMA or PIO.
+ */
+static bool sdhci_prepare_adma(struct sdhci_host *host, ulong addr, uint len)
+{
+	struct sdhci_adma_desc *desc;
+	void *next = host->adma_desc;
+	uint trans;
+
+	/*
+	 * The buffer is cleaned and invalidated by cache line, so it must
+	 * not share a line with anything else
+	 */
+	if (!next || len > host->adma_max_len ||
+	    !IS_ALIGNED(addr, ARCH_DMA_MINALIGN))
+		return false;
+	if (!host->adma64 && upper_32_bits((u64)addr + len - 1))
+		return false;
+
+	do {
+		trans = min(len, (uint)ADMA_MAX_LEN);
+		len -= trans;
+
+		desc = next;
+		desc->attr = ADMA_DESC_ATTR_VALID | ADMA_DESC_TRANSFER_DATA;
+		if (!len)
+			desc->attr |= ADMA_DESC_ATTR_END;
+		desc->reserved = 0;
+		desc->len = cpu_to_le16(trans);
+		desc->addr_lo = cpu_to_le32(lower_32_bits((u64)addr));
+		if (host->adma64)
+			desc->addr_hi = cpu_to_le32(upper_32_bits((u64)addr));
+		next += host->adma64 ? ADMA_DESC64_LEN : ADMA_DESC32_LEN;
+		addr += trans;
+	} while (len);
+
+	flush_cache((ulong)host->adma_desc,
+		    ALIGN(next - host->adma_desc, ARCH_DMA_MINALIGN));
+	sdhci_writel(host, lower_32_bits((u64)(ulong)host->adma_desc),
+		     SDHCI_ADMA_ADDRESS);
+	if (host->adma64)
+		sdhci_writel(host, upper_32_bits((u64)(ulong)host->adma_desc),
+			     SDHCI_ADMA_ADDRESS_HI);
+
+	return true;
+}
+#else
+static int sdhci_adma_init(struct mmc *mmc, struct sdhci_host *host)
+{
+	return 0;
+}
+#endif
+
 static void sdhci_reset(struct sdhci_host *host, u8 mask)
 {
 	unsigned long timeout;
@@ -72,12 +173,6 @@ static int sdhci_transfer_data(struct sdhci_host *host, struct mmc_data *data,
 {
 	unsigned int stat, rdy, mask, timeout, block = 0;
 	bool transfer_done = false;
-#ifdef CONFIG_MMC_SDHCI_SDMA
-	unsigned char ctrl;
-	ctrl = sdhci_readb(host, SDHCI_HOST_CONTROL);
-	ctrl &= ~SDHCI_CTRL_DMA_MASK;
-	sdhci_writeb(host, ctrl, SDHCI_HOST_CONTROL);
-#endif
 
 	timeout = 1000000;
 	rdy = SDHCI_INT_SPACE_AVAIL | SDHCI_INT_DATA_AVAIL;
@@ -149,7 +244,10 @@ static int sdhci_send_command(struct mmc *mmc, struct mmc_cmd *cmd,
 	int ret = 0;
 	int trans_bytes = 0, is_aligned = 1;
 	u32 mask, flags, mode;
-	unsigned int time = 0, start_addr = 0;
+	unsigned int time = 0;
+	ulong start_addr = 0;
+	u8 dma_sel = SDHCI_CTRL_SDMA;
+	bool dma = false;
 	int mmc_dev = mmc_get_blk_desc(mmc)->devnum;
 	ulong start = get_timer(0);
 
@@ -218,33 +316,53 @@ static int sdhci_send_command(struct mmc *mmc, struct mmc_cmd *cmd,
 		if (data->flags == MMC_DATA_READ)
 			mode |= SDHCI_TRNS_READ;
 
-#ifdef CONFIG_MMC_SDHCI_SDMA
 		if (data->flags == MMC_DATA_READ)
 			start_addr = (unsigned long)data->dest;
 		else
 			start_addr = (unsigned long)data->src;
-		if ((host->quirks & SDHCI_QUIRK_32BIT_DMA_ADDR) &&
-				(start_addr & 0x7) != 0x0) {
+
+#if CONFIG_IS_ENABLED(MMC_SDHCI_ADMA) && \
+	!defined(CONFIG_FIXED_SDHCI_ALIGNED_BUFFER)
+		/* ADMA2 covers the whole transfer with one descriptor table */
+		if (sdhci_prepare_adma(host, start_addr, trans_bytes)) {
+			dma_sel = host->adma64 ? SDHCI_CTRL_ADMA64 :
+						 SDHCI_CTRL_ADMA32;
+			dma = true;
+		}
+#endif
+#ifdef CONFIG_MMC_SDHCI_SDMA
+		if (!dma) {
+			if ((host->quirks & SDHCI_QUIRK_32BIT_DMA_ADDR) &&
+			    (start_addr & 0x7) != 0x0) {
+				is_aligned = 0;
+				start_addr = (unsigned long)aligned_buffer;
+				if (data->flags != MMC_DATA_READ)
+					memcpy(aligned_buffer, data->src,
+					       trans_bytes);
+			}
+
+#if defined(CONFIG_FIXED_SDHCI_ALIGNED_BUFFER)
+			/*
+			 * Always use this bounce-buffer when
+			 * CONFIG_FIXED_SDHCI_ALIGNED_BUFFER is defined
+			 */
 			is_aligned = 0;
 			start_addr = (unsigned long)aligned_buffer;
 			if (data->flags != MMC_DATA_READ)
 				memcpy(aligned_buffer, data->src, trans_bytes);
-		}
-
-#if defined(CONFIG_FIXED_SDHCI_ALIGNED_BUFFER)
-		/*
-		 * Always use this bounce-buffer when
-		 * CONFIG_FIXED_SDHCI_ALIGNED_BUFFER is defined
-		 */
-		is_aligned = 0;
-		start_addr = (unsigned long)aligned_buffer;
-		if (data->flags != MMC_DATA_READ)
-			memcpy(aligned_buffer, data->src, trans_bytes);
 #endif
 
-		sdhci_writel(host, start_addr, SDHCI_DMA_ADDRESS);
-		mode |= SDHCI_TRNS_DMA;
+			sdhci_writel(host, start_addr, SDHCI_DMA_ADDRESS);
+			dma = true;
+		}
 #endif
+		if (dma) {
+			u8 ctrl = sdhci_readb(host, SDHCI_HOST_CONTROL);
+
+			ctrl &= ~SDHCI_CTRL_DMA_MASK;
+			sdhci_writeb(host, ctrl | dma_sel, SDHCI_HOST_CONTROL);
+			mode |= SDHCI_TRNS_DMA;
+		}
 		sdhci_writew(host, SDHCI_MAKE_BLKSZ(SDHCI_DEFAULT_BOUNDARY_ARG,
 				data->blocksize),
 				SDHCI_BLOCK_SIZE);
@@ -255,12 +373,10 @@ static int sdhci_send_command(struct mmc *mmc, struct mmc_cmd *cmd,
 	}
 
 	sdhci_writel(host, cmd->cmdarg, SDHCI_ARGUMENT);
-#ifdef CONFIG_MMC_SDHCI_SDMA
-	if (data) {
+	if (dma) {
 		trans_bytes = ALIGN(trans_bytes, CONFIG_SYS_CACHELINE_SIZE);
 		flush_cache(start_addr, trans_bytes);
 	}
-#endif
 	sdhci_writew(host, SDHCI_MAKE_CMD(cmd->cmdidx, flags), SDHCI_COMMAND);
 	start = get_timer(0);
 	do {
@@ -294,6 +410,10 @@ static int sdhci_send_command(struct mmc *mmc, struct mmc_cmd *cmd,
 	stat = sdhci_readl(host, SDHCI_INT_STATUS);
 	sdhci_writel(host, SDHCI_INT_ALL_MASK, SDHCI_INT_STATUS);
 	if (!ret) {
+		/* Drop any lines fetched speculatively during the transfer */
+		if (dma_sel != SDHCI_CTRL_SDMA && data->flags == MMC_DATA_READ)
+			invalidate_dcache_range(start_addr,
+						start_addr + trans_bytes);
 		if ((host->quirks & SDHCI_QUIRK_32BIT_DMA_ADDR) &&
 				!is_aligned && (data->flags == MMC_DATA_READ))
 			memcpy(data->dest, aligned_buffer, trans_bytes);
@@ -508,6 +628,7 @@ static int sdhci_set_ios(struct mmc *mmc)
 static int sdhci_init(struct mmc *mmc)
 {
 	struct sdhci_host *host = mmc->priv;
+	int ret;
 
 	sdhci_reset(host, SDHCI_RESET_ALL);
 
@@ -520,6 +641,10 @@ static int sdhci_init(struct mmc *mmc)
 		}
 	}
 
+	ret = sdhci_adma_init(mmc, host);
+	if (ret)
+		return ret;
+
 	sdhci_set_power(host, fls(mmc->cfg->voltages) - 1);
 
 	if (host->ops && host->ops->get_cd)
@@ -6,14 +6,17 @@
 #include <common.h>
 #include <asm/arch/clock_manager.h>
 #include <asm/arch/system_manager.h>
+#include <bloblist.h>
 #include <clk.h>
 #include <dm.h>
+#include <dt-structs.h>
 #include <dwmmc.h>
 #include <errno.h>
 #include <fdtdec.h>
 #include <linux/libfdt.h>
 #include <linux/err.h>
 #include <malloc.h>
+#include <mapmem.h>
 #include <reset.h>
 
 DECLARE_GLOBAL_DATA_PTR;
@@ -23,7 +26,13 @@ static const struct socfpga_clock_manager *clock_manager_base =
 static const struct socfpga_system_manager *system_manager_base =
 		(void *)SOCFPGA_SYSMGR_ADDRESS;
 
+/* Number of sample phases selectable in the system manager */
+#define SOCFPGA_SMPLSEL_PHASES	8
+
 struct socfpga_dwmci_plat {
+#if CONFIG_IS_ENABLED(OF_PLATDATA)
+	struct dtd_altr_socfpga_dw_mshc dtplat;
+#endif
 	struct mmc_config cfg;
 	struct mmc mmc;
 };
@@ -33,11 +42,64 @@ struct dwmci_socfpga_priv_data {
 	struct dwmci_host	host;
 	unsigned int		drvsel;
 	unsigned int		smplsel;
+	int			tuned_smplsel;	/* -1 if not tuned */
 	unsigned int		mmc_8bit_cap;
 };
 
+#if CONFIG_IS_ENABLED(BLOBLIST) && defined(MMC_SUPPORTS_TUNING)
+/**
+ * struct socfpga_dwmci_tuning - Sample phase passed on to the next phase
+ *
+ * @regbase:	Address of the controller which was tuned
+ * @smplsel:	Sample phase found by tuning
+ */
+struct socfpga_dwmci_tuning {
+	u32 regbase;
+	u32 smplsel;
+};
+
+static void socfpga_dwmci_save_tuning(struct dwmci_host *host)
+{
+	struct dwmci_socfpga_priv_data *priv = host->priv;
+	struct socfpga_dwmci_tuning *tuning;
+
+	tuning = bloblist_ensure(BLOBLISTT_SOCFPGA_DWMMC, sizeof(*tuning));
+	if (!tuning)
+		return;
+	tuning->regbase = (ulong)host->ioaddr;
+	tuning->smplsel = priv->tuned_smplsel;
+}
+
+/*
+ * Start from the sample phase found by the previous phase, if any. It is
+ * still checked with a tuning command before use.
+ */
+static void socfpga_dwmci_load_tuning(struct dwmci_host *host)
+{
+	struct dwmci_socfpga_priv_data *priv = host->priv;
+	struct socfpga_dwmci_tuning *tuning;
+
+	tuning = bloblist_find(BLOBLISTT_SOCFPGA_DWMMC, sizeof(*tuning));
+	if (tuning && tuning->regbase == (ulong)host->ioaddr &&
+	    tuning->smplsel < SOCFPGA_SMPLSEL_PHASES)
+		priv->tuned_smplsel = tuning->smplsel;
+}
+#else
+static inline void socfpga_dwmci_save_tuning(struct dwmci_host *host) {}
+static inline void socfpga_dwmci_load_tuning(struct dwmci_host *host) {}
+#endif
+
+/* Check whether the mode uses the tuned sample phase */
+static bool socfpga_dwmci_tuned_mode(struct mmc *mmc)
+{
+	return mmc && (mmc->selected_mode == MMC_HS_200 ||
+		       mmc->selected_mode == UHS_SDR104 ||
+		       mmc->selected_mode == UHS_SDR50);
+}
+
 static void socfpga_dwmci_reset(struct udevice *dev)
 {
+#if !CONFIG_IS_ENABLED(OF_PLATDATA)
 	struct reset_ctl_bulk reset_bulk;
 	int ret;
 
@@ -48,20 +110,26 @@ static void socfpga_dwmci_reset(struct udevice *dev)
 	}
 
 	reset_deassert_bulk(&reset_bulk);
+#endif
 }
 
 static void socfpga_dwmci_clksel(struct dwmci_host *host)
 {
 	struct dwmci_socfpga_priv_data *priv = host->priv;
-	u32 sdmmc_mask = ((priv->smplsel & 0x7) << SYSMGR_SDMMC_SMPLSEL_SHIFT) |
-			 ((priv->drvsel & 0x7) << SYSMGR_SDMMC_DRVSEL_SHIFT);
+	unsigned int smplsel = priv->smplsel;
+	u32 sdmmc_mask;
+
+	if (priv->tuned_smplsel >= 0 && socfpga_dwmci_tuned_mode(host->mmc))
+		smplsel = priv->tuned_smplsel;
+	sdmmc_mask = ((smplsel & 0x7) << SYSMGR_SDMMC_SMPLSEL_SHIFT) |
+		     ((priv->drvsel & 0x7) << SYSMGR_SDMMC_DRVSEL_SHIFT);
 
 	/* Disable SDMMC clock. */
 	clrbits_le32(&clock_manager_base->per_pll.en,
 		CLKMGR_PERPLLGRP_EN_SDMMCCLK_MASK);
 
 	debug("%s: drvsel %d smplsel %d\n", __func__,
-	      priv->drvsel, priv->smplsel);
+	      priv->drvsel, smplsel);
 	writel(sdmmc_mask, &system_manager_base->sdmmcgrp_ctrl);
 
 	debug("%s: SYSMGR_SDMMCGRP_CTRL_REG = 0x%x\n", __func__,
@@ -72,11 +140,61 @@ static void socfpga_dwmci_clksel(struct dwmci_host *host)
 		CLKMGR_PERPLLGRP_EN_SDMMCCLK_MASK);
 }
 
+#ifdef MMC_SUPPORTS_TUNING
+/*
+ * Read the tuning block at each sample phase and use the middle of the
+ * longest run of phases that work. The phase found is kept, so when the card
+ * is initialised again it is tried first and the sweep is usually skipped.
+ */
+static int socfpga_dwmci_execute_tuning(struct dwmci_host *host, u32 opcode)
+{
+	struct dwmci_socfpga_priv_data *priv = host->priv;
+	struct mmc *mmc = host->mmc;
+	int start = 0, len = 0, best_start = 0, best_len = 0;
+	int phase;
+
+	if (priv->tuned_smplsel >= 0) {
+		socfpga_dwmci_clksel(host);
+		if (!mmc_send_tuning(mmc, opcode, NULL))
+			return 0;
+	}
+
+	for (phase = 0; phase < SOCFPGA_SMPLSEL_PHASES; phase++) {
+		priv->tuned_smplsel = phase;
+		socfpga_dwmci_clksel(host);
+		if (mmc_send_tuning(mmc, opcode, NULL)) {
+			len = 0;
+			continue;
+		}
+		if (!len++)
+			start = phase;
+		if (len > best_len) {
+			best_start = start;
+			best_len = len;
+		}
+	}
+
+	if (!best_len) {
+		priv->tuned_smplsel = -1;
+		socfpga_dwmci_clksel(host);
+		return -EIO;
+	}
+
+	priv->tuned_smplsel = best_start + (best_len - 1) / 2;
+	debug("%s: smplsel %d to %d pass, using %d\n", __func__, best_start,
+	      best_start + best_len - 1, priv->tuned_smplsel);
+	socfpga_dwmci_clksel(host);
+	socfpga_dwmci_save_tuning(host);
+
+	return 0;
+}
+#endif
+
 static int socfpga_dwmmc_get_clk_rate(struct udevice *dev)
 {
 	struct dwmci_socfpga_priv_data *priv = dev_get_priv(dev);
 	struct dwmci_host *host = &priv->host;
-#if CONFIG_IS_ENABLED(CLK)
+#if CONFIG_IS_ENABLED(CLK) && !CONFIG_IS_ENABLED(OF_PLATDATA)
 	struct clk clk;
 	int ret;
 
@@ -99,23 +217,16 @@ static int socfpga_dwmmc_get_clk_rate(struct udevice *dev)
 	return 0;
 }
 
-static int socfpga_dwmmc_ofdata_to_platdata(struct udevice *dev)
+/* Set up the host from the properties common to both sources of platdata */
+static void socfpga_dwmmc_setup_host(struct udevice *dev, void *ioaddr,
+				     int buswidth, int fifo_depth)
 {
 	struct dwmci_socfpga_priv_data *priv = dev_get_priv(dev);
 	struct dwmci_host *host = &priv->host;
-	int fifo_depth;
-
-	fifo_depth = fdtdec_get_int(gd->fdt_blob, dev_of_offset(dev),
-				    "fifo-depth", 0);
-	if (fifo_depth < 0) {
-		printf("DWMMC: Can't get FIFO depth\n");
-		return -EINVAL;
-	}
 
 	host->name = dev->name;
-	host->ioaddr = (void *)devfdt_get_addr(dev);
-	host->buswidth = fdtdec_get_int(gd->fdt_blob, dev_of_offset(dev),
-					"bus-width", 4);
+	host->ioaddr = ioaddr;
+	host->buswidth = buswidth;
 	host->clksel = socfpga_dwmci_clksel;
 
 	/*
@@ -125,17 +236,68 @@ static int socfpga_dwmmc_ofdata_to_platdata(struct udevice *dev)
 	host->dev_index = 0;
 	host->fifoth_val = MSIZE(0x2) |
 		RX_WMARK(fifo_depth / 2 - 1) | TX_WMARK(fifo_depth / 2);
+	priv->tuned_smplsel = -1;
+	host->priv = priv;
+#ifdef MMC_SUPPORTS_TUNING
+	host->execute_tuning = socfpga_dwmci_execute_tuning;
+#endif
+}
+
+#if CONFIG_IS_ENABLED(OF_PLATDATA)
+/*
+ * Only the properties which every socfpga device tree has can be used here,
+ * so drvsel and smplsel take their defaults. An 8-bit bus is given by
+ * bus-width rather than mmc_8bit_cap.
+ */
+static void socfpga_dwmmc_conv_of_platdata(struct udevice *dev)
+{
+	struct socfpga_dwmci_plat *plat = dev_get_platdata(dev);
+	struct dtd_altr_socfpga_dw_mshc *dtplat = &plat->dtplat;
+	struct dwmci_socfpga_priv_data *priv = dev_get_priv(dev);
+	void *ioaddr = map_sysmem(dtplat->reg[0], dtplat->reg[1]);
+
+	socfpga_dwmmc_setup_host(dev, ioaddr, dtplat->bus_width,
+				 dtplat->fifo_depth);
+	priv->drvsel = 3;
+	priv->smplsel = 0;
+	priv->mmc_8bit_cap = 0;
+}
+#endif
+
+static int socfpga_dwmmc_ofdata_to_platdata(struct udevice *dev)
+{
+#if !CONFIG_IS_ENABLED(OF_PLATDATA)
+	struct dwmci_socfpga_priv_data *priv = dev_get_priv(dev);
+	int fifo_depth, buswidth;
+
+	fifo_depth = fdtdec_get_int(gd->fdt_blob, dev_of_offset(dev),
+				    "fifo-depth", 0);
+	if (fifo_depth < 0) {
+		printf("DWMMC: Can't get FIFO depth\n");
+		return -EINVAL;
+	}
+	buswidth = fdtdec_get_int(gd->fdt_blob, dev_of_offset(dev),
+				  "bus-width", 4);
+
+	socfpga_dwmmc_setup_host(dev, (void *)devfdt_get_addr(dev), buswidth,
+				 fifo_depth);
 	priv->drvsel = fdtdec_get_uint(gd->fdt_blob, dev_of_offset(dev),
 				       "drvsel", 3);
 	priv->smplsel = fdtdec_get_uint(gd->fdt_blob, dev_of_offset(dev),
 					"smplsel", 0);
-	host->priv = priv;
+
+#if CONFIG_IS_ENABLED(MMC_HS200_SUPPORT)
+	if (dev_read_bool(dev, "mmc-hs200-1_8v") ||
+	    dev_read_bool(dev, "mmc-hs200-1_2v"))
+		priv->host.caps |= MMC_CAP(MMC_HS_200);
+#endif
 
 	if (fdt_get_property(gd->fdt_blob, dev_of_offset(dev),
 				"mmc_8bit_cap", NULL))
 		priv->mmc_8bit_cap = 1;
 	else
 		priv->mmc_8bit_cap = 0;
+#endif
 
 	return 0;
 }
@@ -150,11 +312,15 @@ static int socfpga_dwmmc_probe(struct udevice *dev)
 	struct dwmci_host *host = &priv->host;
 	int ret;
 
+#if CONFIG_IS_ENABLED(OF_PLATDATA)
+	socfpga_dwmmc_conv_of_platdata(dev);
+#endif
 	ret = socfpga_dwmmc_get_clk_rate(dev);
 	if (ret)
 		return ret;
 
 	socfpga_dwmci_reset(dev);
+	socfpga_dwmci_load_tuning(host);
 
 	if (priv->mmc_8bit_cap)
 		host->quirks |= DWMCI_QUIRK_MMC_8BIT_CAP;
@@ -195,13 +361,18 @@ static const struct udevice_id socfpga_dwmmc_ids[] = {
 };
 
 U_BOOT_DRIVER(socfpga_dwmmc_drv) = {
+#if CONFIG_IS_ENABLED(OF_PLATDATA)
+	.name		= "altr_socfpga_dw_mshc",
+#else
 	.name		= "socfpga_dwmmc",
+#endif
 	.id		= UCLASS_MMC,
 	.of_match	= socfpga_dwmmc_ids,
 	.ofdata_to_platdata = socfpga_dwmmc_ofdata_to_platdata,
 	.ops		= &dm_dwmci_ops,
 	.bind		= socfpga_dwmmc_bind,
 	.probe		= socfpga_dwmmc_probe,
+	.remove		= dwmci_remove,
 	.priv_auto_alloc_size = sizeof(struct dwmci_socfpga_priv_data),
 	.platdata_auto_alloc_size = sizeof(struct socfpga_dwmci_plat),
 };
@@ -36,6 +36,9 @@
 #include <asm/atomic.h>
 #endif
 #include "crc32defs.h"
+#ifdef __UBOOT__
+#include <u-boot/crc.h>
+#else
 #define CRC_LE_BITS 8
 
 #if CRC_LE_BITS == 8
@@ -46,6 +49,7 @@
 #define tobe(x) (x)
 #endif
 #include "crc32table.h"
+#endif
 #ifndef __UBOOT__
 MODULE_AUTHOR("Matt Domsch <Matt_Domsch@dell.com>");
 MODULE_DESCRIPTION("Ethernet CRC32 calculations");
@@ -60,7 +64,16 @@ MODULE_LICENSE("GPL");
  */
 u32  crc32_le(u32 crc, unsigned char const *p, size_t len);
 
-#if CRC_LE_BITS == 1
+#ifdef __UBOOT__
+/*
+ * This is the same CRC as crc32_no_comp() in lib/crc32.c, so use that
+ * rather than a second table, to share its faster implementations.
+ */
+u32 crc32_le(u32 crc, unsigned char const *p, size_t len)
+{
+	return crc32_no_comp(crc, p, len);
+}
+#elif CRC_LE_BITS == 1
 /*
  * In fact, the table-based code will work in this case, but it can be
  * simplified by inlining the table in ?: form.
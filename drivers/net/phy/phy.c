@@ -142,6 +142,46 @@ static int genphy_setup_forced(struct phy_device *phydev)
 	return err;
 }
 
+#ifdef CONFIG_PHY_AUTONEG_BACKGROUND
+static void phy_aneg_started(struct phy_device *phydev)
+{
+	phydev->aneg_state = PHY_ANEG_RUNNING;
+	phydev->aneg_start = get_timer(0);
+}
+
+/*
+ * Return how long genphy_update_link() should consider it has already
+ * waited, i.e. the time since autonegotiation was started in the
+ * background. This is only counted once, so later waits take the full time.
+ * If the timeout has passed in the meantime, e.g. because the cable was
+ * plugged in late, autonegotiation is restarted and waited for in full.
+ */
+static int phy_aneg_waited(struct phy_device *phydev)
+{
+	ulong elapsed;
+
+	if (phydev->aneg_state != PHY_ANEG_RUNNING)
+		return 0;
+
+	elapsed = get_timer(phydev->aneg_start);
+	phydev->aneg_state = PHY_ANEG_IDLE;
+	if (elapsed < PHY_ANEG_TIMEOUT)
+		return elapsed;
+
+	genphy_restart_aneg(phydev);
+	phydev->aneg_state = PHY_ANEG_IDLE;
+
+	return 0;
+}
+#else
+static inline void phy_aneg_started(struct phy_device *phydev) {}
+
+static inline int phy_aneg_waited(struct phy_device *phydev)
+{
+	return 0;
+}
+#endif
+
 /**
  * genphy_restart_aneg - Enable and Restart Autonegotiation
  * @phydev: target phy_device struct
@@ -161,6 +201,8 @@ int genphy_restart_aneg(struct phy_device *phydev)
 	ctl &= ~(BMCR_ISOLATE);
 
 	ctl = phy_write(phydev, MDIO_DEVAD_NONE, MII_BMCR, ctl);
+	if (!ctl)
+		phy_aneg_started(phydev);
 
 	return ctl;
 }
@@ -236,7 +278,7 @@ int genphy_update_link(struct phy_device *phydev)
 
 	if ((phydev->autoneg == AUTONEG_ENABLE) &&
 	    !(mii_reg & BMSR_ANEGCOMPLETE)) {
-		int i = 0;
+		int i = phy_aneg_waited(phydev);
 
 		printf("%s Waiting for PHY auto negotiation to complete",
 		       phydev->dev->name);
@@ -831,6 +873,9 @@ int phy_reset(struct phy_device *phydev)
 		puts("PHY reset timed out\n");
 		return -1;
 	}
+	/* The PHY restarts autonegotiation when it comes out of reset */
+	if (devad == MDIO_DEVAD_NONE && (reg & BMCR_ANENABLE))
+		phy_aneg_started(phydev);
 
 	return 0;
 }
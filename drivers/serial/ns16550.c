@@ -8,10 +8,13 @@
 #include <clk.h>
 #include <dm.h>
 #include <errno.h>
+#include <malloc.h>
 #include <ns16550.h>
 #include <reset.h>
 #include <serial.h>
 #include <watchdog.h>
+#include <linux/bug.h>
+#include <linux/log2.h>
 #include <linux/types.h>
 #include <asm/io.h>
 
@@ -302,13 +305,98 @@ DEBUG_UART_FUNCS
 #endif
 
 #ifdef CONFIG_DM_SERIAL
+#if CONFIG_IS_ENABLED(NS16550_TX_BUFFER)
+#define TX_BUF_MASK	(CONFIG_NS16550_TX_BUFFER_SIZE - 1)
+
+static uint ns16550_tx_count(struct NS16550 *com_port)
+{
+	return (com_port->tx_head - com_port->tx_tail) & TX_BUF_MASK;
+}
+
+/* Refill the TX FIFO from the buffer if it is empty, without waiting */
+static void ns16550_tx_drain(struct NS16550 *com_port)
+{
+	uint n;
+
+	if (com_port->tx_head == com_port->tx_tail ||
+	    !(serial_in(&com_port->lsr) & UART_LSR_THRE))
+		return;
+
+	for (n = 0; n < CONFIG_NS16550_TX_FIFO_DEPTH &&
+	     com_port->tx_tail != com_port->tx_head; n++) {
+		serial_out(com_port->tx_buf[com_port->tx_tail],
+			   &com_port->thr);
+		com_port->tx_tail = (com_port->tx_tail + 1) & TX_BUF_MASK;
+	}
+}
+
+/*
+ * Queue a character, waiting only if the buffer is full. Returns -ENOSPC
+ * if there is no buffer, so that the character is sent directly.
+ */
+static int ns16550_tx_queue(struct NS16550 *com_port, const char ch)
+{
+	if (!com_port->tx_buf)
+		return -ENOSPC;
+
+	while (ns16550_tx_count(com_port) == TX_BUF_MASK)
+		ns16550_tx_drain(com_port);
+
+	com_port->tx_buf[com_port->tx_head] = ch;
+	com_port->tx_head = (com_port->tx_head + 1) & TX_BUF_MASK;
+	ns16550_tx_drain(com_port);
+
+	return 0;
+}
+
+/* The buffer is in the malloc() area, so only use it after relocation */
+static void ns16550_tx_init(struct NS16550 *com_port)
+{
+	/* TX_BUF_MASK only works for a power-of-two buffer size */
+	BUILD_BUG_ON(!is_power_of_2(CONFIG_NS16550_TX_BUFFER_SIZE));
+
+	com_port->tx_head = 0;
+	com_port->tx_tail = 0;
+	com_port->tx_buf = NULL;
+	if (gd->flags & GD_FLG_RELOC)
+		com_port->tx_buf = malloc(CONFIG_NS16550_TX_BUFFER_SIZE);
+}
+
+/* Send whatever is left in the buffer, then free it */
+static void ns16550_tx_free(struct NS16550 *com_port)
+{
+	while (ns16550_tx_count(com_port))
+		ns16550_tx_drain(com_port);
+	free(com_port->tx_buf);
+	com_port->tx_buf = NULL;
+}
+#else
+static inline uint ns16550_tx_count(struct NS16550 *com_port)
+{
+	return 0;
+}
+
+static inline void ns16550_tx_drain(struct NS16550 *com_port) {}
+
+static inline int ns16550_tx_queue(struct NS16550 *com_port, const char ch)
+{
+	return -ENOSPC;
+}
+
+static inline void ns16550_tx_init(struct NS16550 *com_port) {}
+
+static inline void ns16550_tx_free(struct NS16550 *com_port) {}
+#endif /* NS16550_TX_BUFFER */
+
 static int ns16550_serial_putc(struct udevice *dev, const char ch)
 {
 	struct NS16550 *const com_port = dev_get_priv(dev);
 
-	if (!(serial_in(&com_port->lsr) & UART_LSR_THRE))
-		return -EAGAIN;
-	serial_out(ch, &com_port->thr);
+	if (ns16550_tx_queue(com_port, ch)) {
+		if (!(serial_in(&com_port->lsr) & UART_LSR_THRE))
+			return -EAGAIN;
+		serial_out(ch, &com_port->thr);
+	}
 
 	/*
 	 * Call watchdog_reset() upon newline. This is done here in putc
@@ -326,10 +414,14 @@ static int ns16550_serial_pending(struct udevice *dev, bool input)
 {
 	struct NS16550 *const com_port = dev_get_priv(dev);
 
+	/* Polling for input is a good time to send buffered output */
+	ns16550_tx_drain(com_port);
+
 	if (input)
 		return (serial_in(&com_port->lsr) & UART_LSR_DR) ? 1 : 0;
 	else
-		return (serial_in(&com_port->lsr) & UART_LSR_THRE) ? 0 : 1;
+		return ns16550_tx_count(com_port) +
+		       ((serial_in(&com_port->lsr) & UART_LSR_THRE) ? 0 : 1);
 }
 
 static int ns16550_serial_getc(struct udevice *dev)
@@ -410,15 +502,28 @@ static int ns16550_serial_getinfo(struct udevice *dev,
 int ns16550_serial_probe(struct udevice *dev)
 {
 	struct NS16550 *const com_port = dev_get_priv(dev);
+#if !CONFIG_IS_ENABLED(OF_PLATDATA)
 	struct reset_ctl_bulk reset_bulk;
 	int ret;
 
+	/* Reset phandles cannot be resolved without the device tree */
 	ret = reset_get_bulk(dev, &reset_bulk);
 	if (!ret)
 		reset_deassert_bulk(&reset_bulk);
+#endif
 
 	com_port->plat = dev_get_platdata(dev);
 	NS16550_init(com_port, -1);
+	ns16550_tx_init(com_port);
+
+	return 0;
+}
+
+int ns16550_serial_remove(struct udevice *dev)
+{
+	struct NS16550 *const com_port = dev_get_priv(dev);
+
+	ns16550_tx_free(com_port);
 
 	return 0;
 }
@@ -548,6 +653,7 @@ U_BOOT_DRIVER(ns16550_serial) = {
 #endif
 	.priv_auto_alloc_size = sizeof(struct NS16550),
 	.probe = ns16550_serial_probe,
+	.remove	= ns16550_serial_remove,
 	.ops	= &ns16550_serial_ops,
 #if !CONFIG_IS_ENABLED(OF_CONTROL)
 	.flags	= DM_FLAG_PRE_RELOC,
@@ -19,6 +19,7 @@
 #include <video.h>
 #include <linux/compiler.h>
 #include <asm/state.h>
+#include <asm/test.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -43,6 +44,7 @@ struct sandbox_serial_platdata {
 
 struct sandbox_serial_priv {
 	bool start_of_line;
+	int tx_pending;		/* Characters the 'transmitter' has yet to send */
 };
 
 /**
@@ -110,14 +112,23 @@ static unsigned int increment_buffer_index(unsigned int index)
 	return (index + 1) % ARRAY_SIZE(serial_buf);
 }
 
+void sandbox_serial_set_tx_pending(struct udevice *dev, int count)
+{
+	struct sandbox_serial_priv *priv = dev_get_priv(dev);
+
+	priv->tx_pending = count;
+}
+
 static int sandbox_serial_pending(struct udevice *dev, bool input)
 {
+	struct sandbox_serial_priv *priv = dev_get_priv(dev);
 	const unsigned int next_index =
 		increment_buffer_index(serial_buf_write);
 	ssize_t count;
 
+	/* Send one pending character each time we are polled */
 	if (!input)
-		return 0;
+		return priv->tx_pending ? priv->tx_pending-- : 0;
 
 	os_usleep(100);
 #ifndef CONFIG_SPL_BUILD
@@ -282,6 +282,21 @@ int serial_tstc(void)
 	return _serial_tstc(gd->cur_serial_dev);
 }
 
+void serial_flush(void)
+{
+	struct dm_serial_ops *ops;
+
+	if (!gd->cur_serial_dev)
+		return;
+
+	ops = serial_get_ops(gd->cur_serial_dev);
+	if (!ops->pending)
+		return;
+
+	while (ops->pending(gd->cur_serial_dev, false) > 0)
+		WATCHDOG_RESET();
+}
+
 void serial_setbrg(void)
 {
 	struct dm_serial_ops *ops;
@@ -63,5 +63,6 @@ U_BOOT_DRIVER(serial_intel_mid) = {
 	.platdata_auto_alloc_size = sizeof(struct ns16550_platdata),
 	.priv_auto_alloc_size = sizeof(struct NS16550),
 	.probe	= mid_serial_probe,
+	.remove	= ns16550_serial_remove,
 	.ops	= &ns16550_serial_ops,
 };
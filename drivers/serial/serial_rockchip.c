@@ -45,6 +45,7 @@ U_BOOT_DRIVER(rockchip_rk3188_uart) = {
 	.priv_auto_alloc_size = sizeof(struct NS16550),
 	.platdata_auto_alloc_size = sizeof(struct rockchip_uart_platdata),
 	.probe	= rockchip_serial_probe,
+	.remove	= ns16550_serial_remove,
 	.ops	= &ns16550_serial_ops,
 	.flags	= DM_FLAG_PRE_RELOC,
 };
@@ -55,6 +56,7 @@ U_BOOT_DRIVER(rockchip_rk3288_uart) = {
 	.priv_auto_alloc_size = sizeof(struct NS16550),
 	.platdata_auto_alloc_size = sizeof(struct rockchip_uart_platdata),
 	.probe	= rockchip_serial_probe,
+	.remove	= ns16550_serial_remove,
 	.ops	= &ns16550_serial_ops,
 	.flags	= DM_FLAG_PRE_RELOC,
 };
@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * SoCFPGA UART support for SPL with of-platdata
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <dt-structs.h>
+#include <ns16550.h>
+#include <serial.h>
+#include <asm/arch/clock_manager.h>
+
+struct socfpga_uart_platdata {
+	struct dtd_snps_dw_apb_uart dtplat;
+	struct ns16550_platdata plat;
+};
+
+static int socfpga_serial_probe(struct udevice *dev)
+{
+	struct socfpga_uart_platdata *plat = dev_get_platdata(dev);
+
+	/*
+	 * Create some new platform data for the standard driver. The UART
+	 * clock is taken from the clock manager, since clock-frequency is
+	 * not given for every board.
+	 */
+	plat->plat.base = plat->dtplat.reg[0];
+	plat->plat.reg_shift = plat->dtplat.reg_shift;
+	plat->plat.reg_width = plat->dtplat.reg_io_width;
+	plat->plat.clock = cm_get_l4_sp_clk_hz();
+	plat->plat.fcr = UART_FCR_DEFVAL;
+	dev->platdata = &plat->plat;
+
+	return ns16550_serial_probe(dev);
+}
+
+U_BOOT_DRIVER(snps_dw_apb_uart) = {
+	.name	= "snps_dw_apb_uart",
+	.id	= UCLASS_SERIAL,
+	.priv_auto_alloc_size = sizeof(struct NS16550),
+	.platdata_auto_alloc_size = sizeof(struct socfpga_uart_platdata),
+	.probe	= socfpga_serial_probe,
+	.remove	= ns16550_serial_remove,
+	.ops	= &ns16550_serial_ops,
+	.flags	= DM_FLAG_PRE_RELOC,
+};
@@ -5,10 +5,13 @@
  */
 
 #include <common.h>
+#include <bloblist.h>
 #include <dm.h>
 #include <fdtdec.h>
 #include <malloc.h>
+#include <mapmem.h>
 #include <spi.h>
+#include <spi_flash.h>
 #include <linux/errno.h>
 #include "cadence_qspi.h"
 
@@ -35,6 +38,67 @@ static int cadence_spi_write_speed(struct udevice *bus, uint hz)
 	return 0;
 }
 
+/**
+ * struct cadence_spi_calibration - Calibration passed on to the next phase
+ *
+ * This lets U-Boot proper reuse the calibration done by SPL, rather than
+ * running it again.
+ *
+ * @regbase:	Address of the controller which was calibrated
+ * @hz:		SCLK rate it was calibrated at
+ * @cs:		Chip select it was calibrated with
+ * @delay:	Read data capture delay found
+ */
+struct cadence_spi_calibration {
+	u32 regbase;
+	u32 hz;
+	u32 cs;
+	u32 delay;
+};
+
+static void cadence_spi_save_calibration(struct udevice *bus, uint hz,
+					 uint delay)
+{
+#if CONFIG_IS_ENABLED(BLOBLIST)
+	struct cadence_spi_priv *priv = dev_get_priv(bus);
+	struct cadence_spi_calibration *cal;
+
+	cal = bloblist_ensure(BLOBLISTT_CADENCE_QSPI, sizeof(*cal));
+	if (!cal)
+		return;
+	cal->regbase = (ulong)priv->regbase;
+	cal->hz = hz;
+	cal->cs = spi_chip_select(bus);
+	cal->delay = delay;
+#endif
+}
+
+/* Use the calibration from the previous phase, if it was for this setup */
+static int cadence_spi_load_calibration(struct udevice *bus, uint hz)
+{
+#if CONFIG_IS_ENABLED(BLOBLIST)
+	struct cadence_spi_priv *priv = dev_get_priv(bus);
+	struct cadence_spi_calibration *cal;
+
+	cal = bloblist_find(BLOBLISTT_CADENCE_QSPI, sizeof(*cal));
+	if (!cal || cal->regbase != (ulong)priv->regbase || cal->hz != hz ||
+	    cal->cs != spi_chip_select(bus))
+		return -ENOENT;
+
+	cadence_spi_write_speed(bus, hz);
+	cadence_qspi_apb_readdata_capture(priv->regbase, 1, cal->delay);
+	debug("SF: Read data capture delay %u from previous phase\n",
+	      cal->delay);
+
+	priv->qspi_calibrated_hz = hz;
+	priv->qspi_calibrated_cs = cal->cs;
+
+	return 0;
+#else
+	return -ENOSYS;
+#endif
+}
+
 /* Calibration sequence to determine the read data capture delay register */
 static int spi_calibration(struct udevice *bus, uint hz)
 {
@@ -111,6 +175,7 @@ static int spi_calibration(struct udevice *bus, uint hz)
 	/* just to ensure we do once only when speed or chip select change */
 	priv->qspi_calibrated_hz = hz;
 	priv->qspi_calibrated_cs = spi_chip_select(bus);
+	cadence_spi_save_calibration(bus, hz, (range_hi + range_lo) / 2);
 
 	return 0;
 }
@@ -134,9 +199,11 @@ static int cadence_spi_set_speed(struct udevice *bus, uint hz)
 	if (priv->previous_hz != hz ||
 	    priv->qspi_calibrated_hz != hz ||
 	    priv->qspi_calibrated_cs != spi_chip_select(bus)) {
-		err = spi_calibration(bus, hz);
-		if (err)
-			return err;
+		if (cadence_spi_load_calibration(bus, hz)) {
+			err = spi_calibration(bus, hz);
+			if (err)
+				return err;
+		}
 
 		/* prevent calibration run when same as previous request */
 		priv->previous_hz = hz;
@@ -150,11 +217,42 @@ static int cadence_spi_set_speed(struct udevice *bus, uint hz)
 	return 0;
 }
 
+#if CONFIG_IS_ENABLED(OF_PLATDATA)
+/*
+ * The flash parameters are in a child node, which is not available here, so
+ * use the same defaults as when they are missing from the device tree. The
+ * flash is limited to the rate SPL probes it at.
+ */
+static void cadence_spi_conv_of_platdata(struct udevice *bus)
+{
+	struct cadence_spi_platdata *plat = bus->platdata;
+	struct dtd_cdns_qspi_nor *dtplat = &plat->dtplat;
+
+	plat->regbase = map_sysmem(dtplat->reg[0], dtplat->reg[1]);
+	plat->ahbbase = map_sysmem(dtplat->reg[2], dtplat->reg[3]);
+	plat->is_decoded_cs = false;
+	plat->fifo_depth = dtplat->cdns_fifo_depth;
+	plat->fifo_width = dtplat->cdns_fifo_width;
+	plat->trigger_address = dtplat->cdns_trigger_address;
+
+	plat->max_hz = CONFIG_SF_DEFAULT_SPEED;
+	plat->page_size = 256;
+	plat->block_size = 16;
+	plat->tshsl_ns = 200;
+	plat->tsd2d_ns = 255;
+	plat->tchsh_ns = 20;
+	plat->tslch_ns = 20;
+}
+#endif
+
 static int cadence_spi_probe(struct udevice *bus)
 {
 	struct cadence_spi_platdata *plat = bus->platdata;
 	struct cadence_spi_priv *priv = dev_get_priv(bus);
 
+#if CONFIG_IS_ENABLED(OF_PLATDATA)
+	cadence_spi_conv_of_platdata(bus);
+#endif
 	priv->regbase = plat->regbase;
 	priv->ahbbase = plat->ahbbase;
 
@@ -281,6 +379,7 @@ static int cadence_spi_xfer(struct udevice *dev, unsigned int bitlen,
 
 static int cadence_spi_ofdata_to_platdata(struct udevice *bus)
 {
+#if !CONFIG_IS_ENABLED(OF_PLATDATA)
 	struct cadence_spi_platdata *plat = bus->platdata;
 	const void *blob = gd->fdt_blob;
 	int node = dev_of_offset(bus);
@@ -316,6 +415,7 @@ static int cadence_spi_ofdata_to_platdata(struct udevice *bus)
 	debug("%s: regbase=%p ahbbase=%p max-frequency=%d page-size=%d\n",
 	      __func__, plat->regbase, plat->ahbbase, plat->max_hz,
 	      plat->page_size);
+#endif
 
 	return 0;
 }
@@ -336,7 +436,11 @@ static const struct udevice_id cadence_spi_ids[] = {
 };
 
 U_BOOT_DRIVER(cadence_spi) = {
+#if CONFIG_IS_ENABLED(OF_PLATDATA)
+	.name = "cdns_qspi_nor",
+#else
 	.name = "cadence_spi",
+#endif
 	.id = UCLASS_SPI,
 	.of_match = cadence_spi_ids,
 	.ops = &cadence_spi_ops,
@@ -13,8 +13,10 @@
 #include <common.h>
 #include <clk.h>
 #include <dm.h>
+#include <dt-structs.h>
 #include <errno.h>
 #include <malloc.h>
+#include <mapmem.h>
 #include <spi.h>
 #include <fdtdec.h>
 #include <reset.h>
@@ -88,6 +90,9 @@ DECLARE_GLOBAL_DATA_PTR;
 #define RX_TIMEOUT			1000		/* timeout in ms */
 
 struct dw_spi_platdata {
+#if CONFIG_IS_ENABLED(OF_PLATDATA)
+	struct dtd_snps_dw_apb_ssi dtplat;
+#endif
 	s32 frequency;		/* Default clock frequency, -1 for none */
 	void __iomem *regs;
 };
@@ -152,8 +157,22 @@ static int request_gpio_cs(struct udevice *bus)
 	return 0;
 }
 
+#if CONFIG_IS_ENABLED(OF_PLATDATA)
+static void dw_spi_conv_of_platdata(struct udevice *bus)
+{
+	struct dw_spi_platdata *plat = bus->platdata;
+	struct dtd_snps_dw_apb_ssi *dtplat = &plat->dtplat;
+
+	plat->regs = map_sysmem(dtplat->reg[0], dtplat->reg[1]);
+
+	/* Use 500KHz as a suitable default */
+	plat->frequency = 500000;
+}
+#endif
+
 static int dw_spi_ofdata_to_platdata(struct udevice *bus)
 {
+#if !CONFIG_IS_ENABLED(OF_PLATDATA)
 	struct dw_spi_platdata *plat = bus->platdata;
 	const void *blob = gd->fdt_blob;
 	int node = dev_of_offset(bus);
@@ -165,6 +184,7 @@ static int dw_spi_ofdata_to_platdata(struct udevice *bus)
 					500000);
 	debug("%s: regs=%p max-frequency=%d\n", __func__, plat->regs,
 	      plat->frequency);
+#endif
 
 	return request_gpio_cs(bus);
 }
@@ -236,6 +256,7 @@ err_rate:
 
 static int dw_spi_reset(struct udevice *bus)
 {
+#if !CONFIG_IS_ENABLED(OF_PLATDATA)
 	int ret;
 	struct dw_spi_priv *priv = dev_get_priv(bus);
 
@@ -258,6 +279,7 @@ static int dw_spi_reset(struct udevice *bus)
 		dev_err(bus, "Failed to reset: %d\n", ret);
 		return ret;
 	}
+#endif
 
 	return 0;
 }
@@ -268,6 +290,9 @@ static int dw_spi_probe(struct udevice *bus)
 	struct dw_spi_priv *priv = dev_get_priv(bus);
 	int ret;
 
+#if CONFIG_IS_ENABLED(OF_PLATDATA)
+	dw_spi_conv_of_platdata(bus);
+#endif
 	priv->regs = plat->regs;
 	priv->freq = plat->frequency;
 
@@ -542,7 +567,11 @@ static const struct udevice_id dw_spi_ids[] = {
 };
 
 U_BOOT_DRIVER(dw_spi) = {
+#if CONFIG_IS_ENABLED(OF_PLATDATA)
+	.name = "snps_dw_apb_ssi",
+#else
 	.name = "dw_spi",
+#endif
 	.id = UCLASS_SPI,
 	.of_match = dw_spi_ids,
 	.ops = &dw_spi_ops,
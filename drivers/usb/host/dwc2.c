@@ -43,6 +43,9 @@ struct dwc2_priv {
 	u8 out_data_toggle[MAX_DEVICE][MAX_ENDPOINT];
 	struct dwc2_core_regs *regs;
 	int root_hub_devnum;
+	/* Largest transfer and packet count the host channels support */
+	u32 max_xfer_size;
+	u32 max_packet_count;
 	bool ext_vbus;
 	/*
 	 * The hnp/srp capability must be disabled if the platform
@@ -841,10 +844,24 @@ static int dwc2_eptype[] = {
 	DWC2_HCCHAR_EPTYPE_BULK,
 };
 
+/*
+ * The controller can DMA directly to or from the caller's buffer if it is
+ * cache-aligned. For IN transfers the length must be too, since the cache
+ * is invalidated over the whole buffer.
+ */
+static bool dwc2_can_dma_direct(void *buffer, int len, int in)
+{
+	if (!IS_ALIGNED((uintptr_t)buffer, ARCH_DMA_MINALIGN))
+		return false;
+
+	return !in || IS_ALIGNED(len, ARCH_DMA_MINALIGN);
+}
+
 static int transfer_chunk(struct dwc2_hc_regs *hc_regs, void *aligned_buffer,
 			  u8 *pid, int in, void *buffer, int num_packets,
 			  int xfer_len, int *actual_len, int odd_frame)
 {
+	bool direct = aligned_buffer == buffer;
 	int ret = 0;
 	uint32_t sub;
 
@@ -863,7 +880,8 @@ static int transfer_chunk(struct dwc2_hc_regs *hc_regs, void *aligned_buffer,
 					(uintptr_t)aligned_buffer +
 					roundup(xfer_len, ARCH_DMA_MINALIGN));
 		} else {
-			memcpy(aligned_buffer, buffer, xfer_len);
+			if (!direct)
+				memcpy(aligned_buffer, buffer, xfer_len);
 			flush_dcache_range(
 					(uintptr_t)aligned_buffer,
 					(uintptr_t)aligned_buffer +
@@ -895,7 +913,8 @@ static int transfer_chunk(struct dwc2_hc_regs *hc_regs, void *aligned_buffer,
 					(unsigned long)aligned_buffer +
 					roundup(xfer_len, ARCH_DMA_MINALIGN));
 
-		memcpy(buffer, aligned_buffer, xfer_len);
+		if (!direct)
+			memcpy(buffer, aligned_buffer, xfer_len);
 	}
 	*actual_len = xfer_len;
 
@@ -916,6 +935,7 @@ int chunk_msg(struct dwc2_priv *priv, struct usb_device *dev,
 	int ret = 0;
 	int do_split = 0;
 	int complete_split = 0;
+	bool direct;
 	uint32_t xfer_len;
 	uint32_t num_packets;
 	int stop_transfer = 0;
@@ -925,15 +945,22 @@ int chunk_msg(struct dwc2_priv *priv, struct usb_device *dev,
 	debug("%s: msg: pipe %lx pid %d in %d len %d\n", __func__, pipe, *pid,
 	      in, len);
 
-	max_xfer_len = CONFIG_DWC2_MAX_PACKET_COUNT * max;
-	if (max_xfer_len > CONFIG_DWC2_MAX_TRANSFER_SIZE)
-		max_xfer_len = CONFIG_DWC2_MAX_TRANSFER_SIZE;
-	if (max_xfer_len > DWC2_DATA_BUF_SIZE)
+	direct = dwc2_can_dma_direct(buffer, len, in);
+	max_xfer_len = priv->max_packet_count * max;
+	if (max_xfer_len > priv->max_xfer_size)
+		max_xfer_len = priv->max_xfer_size;
+	if (!direct && max_xfer_len > DWC2_DATA_BUF_SIZE)
 		max_xfer_len = DWC2_DATA_BUF_SIZE;
 
-	/* Make sure that max_xfer_len is a multiple of max packet size. */
+	/*
+	 * Make sure that max_xfer_len is a multiple of max packet size and,
+	 * when using the caller's buffer, that each chunk starts aligned.
+	 */
 	num_packets = max_xfer_len / max;
 	max_xfer_len = num_packets * max;
+	if (direct)
+		max_xfer_len = rounddown(max_xfer_len,
+					 max_t(int, max, ARCH_DMA_MINALIGN));
 
 	/* Initialize channel */
 	dwc_otg_hc_init(regs, DWC2_HC_CHANNEL, dev, devnum, ep, in,
@@ -951,6 +978,7 @@ int chunk_msg(struct dwc2_priv *priv, struct usb_device *dev,
 			dwc_otg_hc_init_split(hc_regs, hub_addr, hub_port);
 
 			do_split = 1;
+			direct = false;
 			num_packets = 1;
 			max_xfer_len = max;
 		}
@@ -964,7 +992,7 @@ int chunk_msg(struct dwc2_priv *priv, struct usb_device *dev,
 
 		if (xfer_len > max_xfer_len)
 			xfer_len = max_xfer_len;
-		else if (xfer_len > max)
+		if (xfer_len > max)
 			num_packets = (xfer_len + max - 1) / max;
 		else
 			num_packets = 1;
@@ -980,7 +1008,8 @@ int chunk_msg(struct dwc2_priv *priv, struct usb_device *dev,
 				odd_frame = 1;
 		}
 
-		ret = transfer_chunk(hc_regs, priv->aligned_buffer, pid,
+		ret = transfer_chunk(hc_regs, direct ? (u8 *)buffer + done :
+				     priv->aligned_buffer, pid,
 				     in, (char *)buffer + done, num_packets,
 				     xfer_len, &actual_len, odd_frame);
 
@@ -1157,8 +1186,8 @@ static int dwc2_reset(struct udevice *dev)
 static int dwc2_init_common(struct udevice *dev, struct dwc2_priv *priv)
 {
 	struct dwc2_core_regs *regs = priv->regs;
-	uint32_t snpsid;
-	int i, j;
+	uint32_t snpsid, hwcfg3;
+	int i, j, width;
 	int ret;
 
 	ret = dwc2_reset(dev);
@@ -1182,6 +1211,20 @@ static int dwc2_init_common(struct udevice *dev, struct dwc2_priv *priv)
 	priv->ext_vbus = 0;
 #endif
 
+	/* The transfer size and packet counters vary in width */
+	hwcfg3 = readl(&regs->ghwcfg3);
+	width = 11 + ((hwcfg3 & DWC2_HWCFG3_XFER_SIZE_CNTR_WIDTH_MASK) >>
+		      DWC2_HWCFG3_XFER_SIZE_CNTR_WIDTH_OFFSET);
+	priv->max_xfer_size = min((1U << width) - 1,
+				  (u32)DWC2_HCTSIZ_XFERSIZE_MASK);
+	width = 4 + ((hwcfg3 & DWC2_HWCFG3_PACKET_SIZE_CNTR_WIDTH_MASK) >>
+		     DWC2_HWCFG3_PACKET_SIZE_CNTR_WIDTH_OFFSET);
+	priv->max_packet_count = min((1U << width) - 1,
+				     (u32)(DWC2_HCTSIZ_PKTCNT_MASK >>
+					   DWC2_HCTSIZ_PKTCNT_OFFSET));
+	debug("%s: max transfer %u bytes, %u packets\n", __func__,
+	      priv->max_xfer_size, priv->max_packet_count);
+
 	dwc_otg_core_init(priv);
 	dwc_otg_core_host_init(dev, regs);
 
@@ -1343,10 +1386,19 @@ static int dwc2_usb_remove(struct udevice *dev)
 	return 0;
 }
 
+static int dwc2_get_max_xfer_size(struct udevice *dev, size_t *size)
+{
+	/* Transfers are split into chunks, so any length can be handled */
+	*size = SIZE_MAX;
+
+	return 0;
+}
+
 struct dm_usb_ops dwc2_usb_ops = {
 	.control = dwc2_submit_control_msg,
 	.bulk = dwc2_submit_bulk_msg,
 	.interrupt = dwc2_submit_int_msg,
+	.get_max_xfer_size = dwc2_get_max_xfer_size,
 };
 
 static const struct udevice_id dwc2_usb_ids[] = {
@@ -0,0 +1,387 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Log-structured environment in SPI flash
+ *
+ * The environment area at CONFIG_ENV_OFFSET is split into erase sectors of
+ * CONFIG_ENV_SECT_SIZE bytes. Each saveenv appends a record holding only
+ * the used part of the exported environment to the current sector, so
+ * that an erase is needed only when that sector is full. The next sector
+ * (in a ring) is then erased and written, so the previous record stays
+ * intact until the new one is complete.
+ *
+ * A record is a header protected by its own CRC, followed by the
+ * environment data protected by a second CRC. At load time, all sectors
+ * are scanned and the valid record with the highest sequence number is
+ * passed to env_import(). A record torn by a power failure fails its CRC
+ * check and is skipped; if even its header is damaged, the rest of that
+ * sector is left alone and the next save starts a new sector.
+ */
+#include <common.h>
+#include <dm.h>
+#include <environment.h>
+#include <malloc.h>
+#include <spi.h>
+#include <spi_flash.h>
+#include <errno.h>
+#include <u-boot/crc.h>
+
+#ifndef CONFIG_ENV_SPI_BUS
+# define CONFIG_ENV_SPI_BUS	CONFIG_SF_DEFAULT_BUS
+#endif
+#ifndef CONFIG_ENV_SPI_CS
+# define CONFIG_ENV_SPI_CS	CONFIG_SF_DEFAULT_CS
+#endif
+#ifndef CONFIG_ENV_SPI_MAX_HZ
+# define CONFIG_ENV_SPI_MAX_HZ	CONFIG_SF_DEFAULT_SPEED
+#endif
+#ifndef CONFIG_ENV_SPI_MODE
+# define CONFIG_ENV_SPI_MODE	CONFIG_SF_DEFAULT_MODE
+#endif
+
+#ifndef CONFIG_ENV_SECT_SIZE
+# error "CONFIG_ENV_SECT_SIZE must be defined for CONFIG_ENV_IS_IN_SPI_FLASH_LOG"
+#endif
+
+#if CONFIG_ENV_SF_LOG_SIZE < 2 * CONFIG_ENV_SECT_SIZE
+# error "CONFIG_ENV_SF_LOG_SIZE must cover at least two sectors"
+#endif
+
+#ifndef CONFIG_SPL_BUILD
+#define CMD_SAVEENV
+#endif
+
+#define ENV_LOG_MAGIC		0x4c564e45	/* "ENVL" */
+#define ENV_LOG_ALIGN		16
+#define ENV_LOG_SECTORS		(CONFIG_ENV_SF_LOG_SIZE / CONFIG_ENV_SECT_SIZE)
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/**
+ * struct env_log_hdr - header of an environment record
+ *
+ * @magic:	ENV_LOG_MAGIC
+ * @seq:	Sequence number, incremented on each save
+ * @len:	Number of environment data bytes following the header
+ * @data_crc:	CRC32 of the environment data
+ * @hdr_crc:	CRC32 of the fields above
+ */
+struct env_log_hdr {
+	u32 magic;
+	u32 seq;
+	u32 len;
+	u32 data_crc;
+	u32 hdr_crc;
+};
+
+/**
+ * struct env_log_state - where the newest record is and the next one goes
+ *
+ * @valid:	true once the log has been scanned
+ * @found:	true if a valid record was found
+ * @seq:	Sequence number of the newest valid record
+ * @sector:	Sector holding the newest valid record
+ * @free:	Offset of the first free byte in that sector
+ * @len:	Data length of the newest valid record
+ * @data_off:	Flash offset of the data of the newest valid record
+ * @crc:	CRC32 of the data of the newest valid record
+ */
+struct env_log_state {
+	bool valid;
+	bool found;
+	u32 seq;
+	uint sector;
+	u32 free;
+	u32 len;
+	u32 data_off;
+	u32 crc;
+};
+
+static struct spi_flash *env_flash;
+static struct env_log_state env_log;
+
+static int setup_flash_device(void)
+{
+#ifdef CONFIG_DM_SPI_FLASH
+	struct udevice *new;
+	int ret;
+
+	/* speed and mode will be read from DT */
+	ret = spi_flash_probe_bus_cs(CONFIG_ENV_SPI_BUS, CONFIG_ENV_SPI_CS,
+				     CONFIG_ENV_SPI_MAX_HZ, CONFIG_ENV_SPI_MODE,
+				     &new);
+	if (ret) {
+		set_default_env("spi_flash_probe_bus_cs() failed", 0);
+		return ret;
+	}
+
+	env_flash = dev_get_uclass_priv(new);
+#else
+	if (!env_flash) {
+		env_flash = spi_flash_probe(CONFIG_ENV_SPI_BUS,
+			CONFIG_ENV_SPI_CS,
+			CONFIG_ENV_SPI_MAX_HZ, CONFIG_ENV_SPI_MODE);
+		if (!env_flash) {
+			set_default_env("spi_flash_probe() failed", 0);
+			return -EIO;
+		}
+	}
+#endif
+	return 0;
+}
+
+static u32 env_log_sector_offset(uint sector)
+{
+	return CONFIG_ENV_OFFSET + sector * CONFIG_ENV_SECT_SIZE;
+}
+
+static u32 env_log_rec_size(u32 len)
+{
+	return ALIGN(sizeof(struct env_log_hdr) + len, ENV_LOG_ALIGN);
+}
+
+static bool env_log_hdr_erased(const struct env_log_hdr *hdr)
+{
+	const u32 *p = (const u32 *)hdr;
+	int i;
+
+	for (i = 0; i < sizeof(*hdr) / sizeof(u32); i++)
+		if (p[i] != 0xffffffff)
+			return false;
+
+	return true;
+}
+
+static bool env_log_hdr_ok(const struct env_log_hdr *hdr, u32 off)
+{
+	if (hdr->magic != ENV_LOG_MAGIC ||
+	    hdr->hdr_crc != crc32(0, (const uchar *)hdr,
+				  offsetof(struct env_log_hdr, hdr_crc)))
+		return false;
+
+	return hdr->len && hdr->len <= ENV_SIZE &&
+	       off + env_log_rec_size(hdr->len) <= CONFIG_ENV_SECT_SIZE;
+}
+
+/**
+ * env_log_scan() - find the newest valid record and the free space
+ *
+ * @buf:	Buffer of ENV_SIZE bytes, used to check the data CRCs
+ * @return 0 if OK (even if the log is empty), -ve on read error
+ */
+static int env_log_scan(char *buf)
+{
+	struct env_log_state st = { .valid = true };
+	struct env_log_hdr hdr;
+	uint sector;
+	u32 base, off;
+	int ret;
+
+	for (sector = 0; sector < ENV_LOG_SECTORS; sector++) {
+		base = env_log_sector_offset(sector);
+		off = 0;
+		while (off + sizeof(hdr) <= CONFIG_ENV_SECT_SIZE) {
+			ret = spi_flash_read(env_flash, base + off, sizeof(hdr),
+					     &hdr);
+			if (ret)
+				return ret;
+			if (env_log_hdr_erased(&hdr))
+				break;
+			if (!env_log_hdr_ok(&hdr, off)) {
+				/* Torn or foreign data: do not append here */
+				off = CONFIG_ENV_SECT_SIZE;
+				break;
+			}
+
+			/* Only newer records are worth reading in full */
+			if (!st.found || (s32)(hdr.seq - st.seq) > 0) {
+				ret = spi_flash_read(env_flash,
+						     base + off + sizeof(hdr),
+						     hdr.len, buf);
+				if (ret)
+					return ret;
+				if (crc32(0, (uchar *)buf, hdr.len) ==
+				    hdr.data_crc) {
+					st.found = true;
+					st.seq = hdr.seq;
+					st.sector = sector;
+					st.len = hdr.len;
+					st.data_off = base + off + sizeof(hdr);
+					st.crc = hdr.data_crc;
+				}
+			}
+			off += env_log_rec_size(hdr.len);
+		}
+		if (st.found && st.sector == sector)
+			st.free = off;
+	}
+
+	env_log = st;
+
+	return 0;
+}
+
+#ifdef CMD_SAVEENV
+static int env_sf_log_save(void)
+{
+	struct env_log_hdr hdr;
+	env_t *env_new;
+	uint sector;
+	u32 len, off;
+	int ret;
+
+	env_new = memalign(ARCH_DMA_MINALIGN, sizeof(env_t));
+	if (!env_new)
+		return -ENOMEM;
+
+	ret = setup_flash_device();
+	if (ret)
+		goto out;
+
+	if (!env_log.valid) {
+		ret = env_log_scan((char *)env_new->data);
+		if (ret)
+			goto out;
+	}
+
+	ret = env_export(env_new);
+	if (ret) {
+		ret = -EIO;
+		goto out;
+	}
+
+	/* Only store up to and including the terminating double '\0' */
+	for (len = 1; len < ENV_SIZE; len++)
+		if (!env_new->data[len - 1] && !env_new->data[len])
+			break;
+	len = min_t(u32, len + 1, ENV_SIZE);
+
+	if (env_log_rec_size(len) > CONFIG_ENV_SECT_SIZE) {
+		printf("Environment too large for a log sector\n");
+		ret = -ENOSPC;
+		goto out;
+	}
+
+	hdr.magic = ENV_LOG_MAGIC;
+	hdr.seq = env_log.found ? env_log.seq + 1 : 0;
+	hdr.len = len;
+	hdr.data_crc = crc32(0, env_new->data, len);
+	hdr.hdr_crc = crc32(0, (uchar *)&hdr,
+			    offsetof(struct env_log_hdr, hdr_crc));
+
+	sector = env_log.found ? env_log.sector : 0;
+	off = env_log.found ? env_log.free : CONFIG_ENV_SECT_SIZE;
+	if (off + env_log_rec_size(len) > CONFIG_ENV_SECT_SIZE) {
+		/* Start a new sector; an empty log starts at sector 0 */
+		if (env_log.found)
+			sector = (sector + 1) % ENV_LOG_SECTORS;
+		off = 0;
+		puts("Erasing SPI flash...");
+		ret = spi_flash_erase(env_flash, env_log_sector_offset(sector),
+				      CONFIG_ENV_SECT_SIZE);
+		if (ret)
+			goto err_write;
+	}
+
+	/*
+	 * The header goes first: if only part of it is written, the rest of
+	 * the sector is skipped; if the data is incomplete, its CRC fails but
+	 * the header still tells where the next record goes.
+	 */
+	puts("Writing to SPI flash...");
+	off += env_log_sector_offset(sector);
+	ret = spi_flash_write(env_flash, off, sizeof(hdr), &hdr);
+	if (ret)
+		goto err_write;
+	ret = spi_flash_write(env_flash, off + sizeof(hdr), len,
+			      env_new->data);
+	if (ret)
+		goto err_write;
+
+	env_log.found = true;
+	env_log.seq = hdr.seq;
+	env_log.sector = sector;
+	env_log.free = off - env_log_sector_offset(sector) +
+		       env_log_rec_size(len);
+	env_log.len = len;
+	env_log.data_off = off + sizeof(hdr);
+	env_log.crc = hdr.data_crc;
+
+	puts("done\n");
+	goto out;
+
+err_write:
+	/* Find out what actually made it to the flash on the next save */
+	env_log.valid = false;
+out:
+	free(env_new);
+
+	return ret;
+}
+#endif /* CMD_SAVEENV */
+
+static int env_sf_log_load(void)
+{
+	env_t *ep;
+	int ret;
+
+	ep = memalign(ARCH_DMA_MINALIGN, sizeof(env_t));
+	if (!ep) {
+		set_default_env("malloc() failed", 0);
+		return -EIO;
+	}
+
+	ret = setup_flash_device();
+	if (ret)
+		goto out;
+
+	ret = env_log_scan((char *)ep->data);
+	if (ret) {
+		set_default_env("spi_flash_read() failed", 0);
+		goto err_read;
+	}
+
+	if (!env_log.found) {
+		set_default_env("no valid environment record", 0);
+		ret = -ENOENT;
+		goto err_read;
+	}
+
+	memset(ep, '\0', sizeof(env_t));
+	ret = spi_flash_read(env_flash, env_log.data_off, env_log.len,
+			     ep->data);
+	if (ret) {
+		set_default_env("spi_flash_read() failed", 0);
+		goto err_read;
+	}
+
+	/*
+	 * The record CRC only covers the used bytes, so check it here rather
+	 * than letting env_import() check the CRC over all of ENV_SIZE
+	 */
+	if (crc32(0, ep->data, env_log.len) != env_log.crc) {
+		set_default_env("bad CRC", 0);
+		ret = -ENOMSG;
+		goto err_read;
+	}
+
+	ret = env_import((char *)ep, 0);
+	if (!ret)
+		gd->env_valid = ENV_VALID;
+
+err_read:
+	spi_flash_free(env_flash);
+	env_flash = NULL;
+out:
+	free(ep);
+
+	return ret;
+}
+
+U_BOOT_ENV_LOCATION(sf_log) = {
+	.location	= ENVL_SPI_FLASH_LOG,
+	ENV_NAME("SPI Flash (log)")
+	.load		= env_sf_log_load,
+#ifdef CMD_SAVEENV
+	.save		= env_save_ptr(env_sf_log_save),
+#endif
+};
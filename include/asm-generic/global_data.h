@@ -77,6 +77,9 @@ typedef struct global_data {
 #ifdef CONFIG_OF_LIVE
 	struct device_node *of_root;
 #endif
+#if CONFIG_IS_ENABLED(OF_INDEX)
+	struct of_index *of_index;	/* Device tree indexes, see of_index.h */
+#endif
 
 #if CONFIG_IS_ENABLED(MULTI_DTB_FIT)
 	const void *multi_dtb_fit;	/* uncompressed multi-dtb FIT image */
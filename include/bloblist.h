@@ -27,6 +27,8 @@ enum bloblist_tag_t {
 	BLOBLISTT_SPL_HANDOFF,		/* Hand-off info from SPL */
 	BLOBLISTT_VBOOT_CTX,		/* Chromium OS verified boot context */
 	BLOBLISTT_VBOOT_HANDOFF,	/* Chromium OS internal handoff info */
+	BLOBLISTT_CADENCE_QSPI,		/* Cadence QSPI read capture delay */
+	BLOBLISTT_SOCFPGA_DWMMC,	/* SoCFPGA DW MMC sample phase */
 };
 
 /**
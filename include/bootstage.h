@@ -15,6 +15,7 @@
 enum bootstage_flags {
 	BOOTSTAGEF_ERROR	= 1 << 0,	/* Error record */
 	BOOTSTAGEF_ALLOC	= 1 << 1,	/* Allocate an id */
+	BOOTSTAGEF_INITCALL	= 1 << 2,	/* Initcall, named from its address */
 };
 
 /* bootstate sub-IDs used for kernel and ramdisk ranges */
@@ -304,6 +305,36 @@ uint32_t bootstage_start(enum bootstage_id id, const char *name);
  */
 uint32_t bootstage_accum(enum bootstage_id id);
 
+/**
+ * bootstage_accum_name() - Add to the accumulated time of a named activity
+ *
+ * This is like bootstage_start()/bootstage_accum(), except that the record
+ * is found by its name, so callers need not allocate an id. A new record
+ * is created the first time a name is seen. This is used to time each
+ * initcall and each device probe.
+ *
+ * @param name		Name of the activity. This must stay valid until
+ *			bootstage_relocate() has been called.
+ * @param start_us	Start time, as returned by timer_get_boot_us()
+ * @return time spent in this iteration of the activity
+ */
+uint32_t bootstage_accum_name(const char *name, uint32_t start_us);
+
+/**
+ * bootstage_accum_initcall() - Add to the accumulated time of an initcall
+ *
+ * The record is named after the function if CONFIG_KALLSYMS is enabled,
+ * otherwise after its address. Only the address is stored; the name is
+ * looked up when the record is reported. The caller measures the time
+ * taken, so that none of this is counted against the initcall.
+ *
+ * @param addr		Address of the initcall function before relocation
+ * @param start_us	Start time, as returned by timer_get_boot_us()
+ * @param duration	Time spent in the initcall, in microseconds
+ */
+void bootstage_accum_initcall(ulong addr, uint32_t start_us,
+			      uint32_t duration);
+
 /* Print a report about boot time */
 void bootstage_report(void);
 
@@ -323,6 +354,27 @@ int bootstage_fdt_add_report(void);
  */
 int bootstage_stash(void *base, int size);
 
+/**
+ * bootstage_export_json() - Write all bootstage records as JSON
+ *
+ * This includes records unstashed from SPL. The output looks like this:
+ *
+ *	{"version":1,"records":[
+ *	{"id":1,"name":"reset","mark":0},
+ *	{"id":200,"name":"lcd","accum":33482}
+ *	]}
+ *
+ * with 'mark' giving the time of a record and 'accum' the accumulated time
+ * of an activity, both in microseconds.
+ *
+ * @param buf	Buffer to write into (may be NULL if size is 0)
+ * @param size	Size of buffer
+ * @return number of characters in the full output, excluding the
+ *	terminating '\0'. Like snprintf(), the output is truncated (and not
+ *	terminated) if this is not less than size.
+ */
+int bootstage_export_json(char *buf, int size);
+
 /**
  * Read bootstage data from memory
  *
@@ -403,6 +455,17 @@ static inline uint32_t bootstage_accum(enum bootstage_id id)
 	return 0;
 }
 
+static inline uint32_t bootstage_accum_name(const char *name,
+					    uint32_t start_us)
+{
+	return 0;
+}
+
+static inline void bootstage_accum_initcall(ulong addr, uint32_t start_us,
+					    uint32_t duration)
+{
+}
+
 static inline int bootstage_stash(void *base, int size)
 {
 	return 0;	/* Pretend to succeed */
@@ -413,6 +476,11 @@ static inline int bootstage_unstash(const void *base, int size)
 	return 0;	/* Pretend to succeed */
 }
 
+static inline int bootstage_export_json(char *buf, int size)
+{
+	return 0;
+}
+
 static inline int bootstage_get_size(void)
 {
 	return 0;
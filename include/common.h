@@ -260,6 +260,10 @@ void	jumptable_init(void);
 
 /* common/kallsysm.c */
 const char *symbol_lookup(unsigned long addr, unsigned long *caddr);
+const char *symbol_lookup_range(unsigned long addr, unsigned long *caddr,
+				unsigned long *naddr);
+const char *symbol_lookup_map(const char *map, unsigned long addr,
+			      unsigned long *caddr, unsigned long *naddr);
 
 /* common/memsize.c */
 long	get_ram_size  (long *, long);
@@ -476,6 +480,9 @@ int gzwrite(unsigned char *src, int len,
 /* lib/lz4_wrapper.c */
 int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn);
 
+/* lib/zstd/zstd_decompress.c */
+int zstd_decompress(const void *src, size_t srcn, void *dst, size_t *dstn);
+
 /* lib/qsort.c */
 void qsort(void *base, size_t nmemb, size_t size,
 	   int(*compar)(const void *, const void *));
@@ -39,6 +39,12 @@
 
 #define CONFIG_ENV_SIZE		8192
 
+/* Environment log in the emulated SPI flash (spi.bin), 64KB sectors */
+#ifdef CONFIG_ENV_IS_IN_SPI_FLASH_LOG
+#define CONFIG_ENV_OFFSET	0x100000
+#define CONFIG_ENV_SECT_SIZE	0x10000
+#endif
+
 /* SPI - enable all SPI flash types for testing purposes */
 
 #define CONFIG_I2C_EDID
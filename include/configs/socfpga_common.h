@@ -211,7 +211,8 @@ unsigned int cm_get_qspi_controller_clk_hz(void);
 #endif
 
 /* Environment for QSPI boot */
-#if defined(CONFIG_ENV_IS_IN_SPI_FLASH) && !defined(CONFIG_ENV_OFFSET)
+#if (defined(CONFIG_ENV_IS_IN_SPI_FLASH) || \
+     defined(CONFIG_ENV_IS_IN_SPI_FLASH_LOG)) && !defined(CONFIG_ENV_OFFSET)
 #define CONFIG_ENV_OFFSET		0x00100000
 #define CONFIG_ENV_SECT_SIZE		(64 * 1024)
 #endif
@@ -42,7 +42,13 @@
 #define QSPI_ENV_OFFSET			0x00800000  // Storage for Uboot Environment
 #define QSPI_ENV_SIZE			0x00040000  // size 256 KiB
 #define QSPI_DTB_OFFSET			0x00840000  // Storage for Linux Devicetree
+#ifndef CONFIG_SPL_OS_BOOT
 #define QSPI_DTB_SIZE			0x00040000  // size 256 KiB
+#else
+#define QSPI_DTB_SIZE			0x00020000  // size 128 KiB
+#define QSPI_FALCON_ARGS_OFFSET		0x00860000  // Storage for Falcon mode DT
+#define QSPI_FALCON_ARGS_SIZE		0x00020000  // size 128 KiB
+#endif
 #define QSPI_BOOTSCRIPT_OFFSET		0x00880000  // Storage for Uboot boot script
 #define QSPI_BOOTSCRIPT_SIZE		0x00040000  // size 256 KiB
 #define QSPI_LINUX_OFFSET		0x008C0000  // Storage for Linux Kernel
@@ -51,6 +57,33 @@
 #define QSPI_ROOTFS_SIZE		0x03000000  // size 48 MiB
 #define QSPI_RAMDISK_SIZE		0x03000000  // size 48 MiB
 #define CONFIG_SYS_MAX_FLASH_BANKS	1
+
+/*
+ * Falcon mode (CONFIG_SPL_OS_BOOT, not enabled by default): SPL boots the
+ * kernel from QSPI with the DT prepared by "spl export", see
+ * "falcon_setup_qspi" below. The DT is stored in the upper half of the
+ * Linux devicetree area, which then shrinks to 128 KiB. Until a DT has
+ * been stored there, SPL boots U-Boot as usual.
+ */
+#ifdef CONFIG_SPL_OS_BOOT
+#define CONFIG_SYS_SPL_ARGS_ADDR	0x02A00000
+#define CONFIG_SYS_SPI_KERNEL_OFFS	QSPI_LINUX_OFFSET
+#define CONFIG_SYS_SPI_ARGS_OFFS	QSPI_FALCON_ARGS_OFFSET
+#define CONFIG_SYS_SPI_ARGS_SIZE	QSPI_FALCON_ARGS_SIZE
+
+#define FALCON_ENV_SETTINGS \
+	"qspi_falcon_args_offset=" __stringify(QSPI_FALCON_ARGS_OFFSET) "\0"\
+	"falcon_setup_qspi=echo Preparing Falcon mode boot on QSPI ...; "\
+		"sf probe && "                          \
+		"sf read ${kernel_loadaddr} ${qspi_kernel_offset} ${kernel_size} && "\
+		"sf read ${devicetree_loadaddr} ${qspi_devicetree_offset} ${devicetree_size} && "\
+		"run qspiargs && "                      \
+		"spl export fdt ${kernel_loadaddr} - ${devicetree_loadaddr} && "\
+		"sf update ${fdtargsaddr} ${qspi_falcon_args_offset} ${fdtargslen}\0"
+#else
+#define FALCON_ENV_SETTINGS
+#endif
+
 /* Extra Environment */
 #define CONFIG_HOSTNAME		"socfpga_cyclone5"
 #define CONFIG_BOOTCOMMAND 	"run modeboot"
@@ -131,6 +164,8 @@
         "tftpboot ${bootscript_loadaddr} ${bootscript_image} && "\
         "source ${bootscript_loadaddr}\0"       \
                                                 \
+	FALCON_ENV_SETTINGS                         \
+                                                \
 	"modeboot=setexpr.l bootsel *0xFFD08014 \\\\& 0x7;" \
 		"if test ${bootsel} -eq 4 || test ${bootsel} -eq 5;"\
 		"then;echo Booting from MMC ...;"\
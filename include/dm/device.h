@@ -61,6 +61,9 @@ struct driver_info;
  */
 #define DM_FLAG_OS_PREPARE		(1 << 10)
 
+/* Only probe this device when it is used (see CONFIG_DM_DEFERRED_PROBE) */
+#define DM_FLAG_PROBE_DEFERRED		(1 << 11)
+
 /*
  * One or multiple of these flags are passed to device_remove() so that
  * a selective device removal as specified by the remove-stage and the
@@ -123,6 +126,8 @@ enum {
  *		When CONFIG_DEVRES is enabled, devm_kmalloc() and friends will
  *		add to this list. Memory so-allocated will be freed
  *		automatically when the device is removed / unbound
+ * @probe_time_us: Time taken by the last successful probe, excluding the
+ *		time spent probing the parents (CONFIG_BOOTSTAGE_DM_PROBE)
  */
 struct udevice {
 	const struct driver *driver;
@@ -146,6 +151,9 @@ struct udevice {
 #ifdef CONFIG_DEVRES
 	struct list_head devres_head;
 #endif
+#if CONFIG_IS_ENABLED(BOOTSTAGE_DM_PROBE)
+	uint32_t probe_time_us;
+#endif
 };
 
 /* Maximum sequence number supported */
@@ -157,6 +165,10 @@ struct udevice {
 /* Returns non-zero if the device is active (probed and not removed) */
 #define device_active(dev)	((dev)->flags & DM_FLAG_ACTIVATED)
 
+/* Returns true if probing the device is deferred and it is not active yet */
+#define device_is_deferred(dev)	(((dev)->flags & (DM_FLAG_PROBE_DEFERRED | \
+				  DM_FLAG_ACTIVATED)) == DM_FLAG_PROBE_DEFERRED)
+
 static inline int dev_of_offset(const struct udevice *dev)
 {
 	return ofnode_to_offset(dev->node);
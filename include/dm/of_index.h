@@ -0,0 +1,89 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Indexes of the device tree and of driver compatible strings
+ */
+
+#ifndef _DM_OF_INDEX_H
+#define _DM_OF_INDEX_H
+
+#include <dm/ofnode.h>
+#include <linux/errno.h>
+
+struct driver;
+struct udevice_id;
+
+#if CONFIG_IS_ENABLED(OF_INDEX)
+/**
+ * of_index_find_phandle() - Find a node by phandle using the index
+ *
+ * This looks in the live tree if active, else the flat tree at
+ * gd->fdt_blob.
+ *
+ * @phandle:	Phandle to look up
+ * @nodep:	Returns the node on success
+ * @return 0 if found, -ENOENT if there is no such node, -ENOSYS if the
+ *	index is not available, in which case the caller must scan the tree
+ */
+int of_index_find_phandle(uint phandle, ofnode *nodep);
+
+/**
+ * of_index_find_compatible() - Find a compatible node using the index
+ *
+ * This finds the next node after @from, in tree order, which has @compat in
+ * its compatible list, like ofnode_by_compatible().
+ *
+ * @from:	Node to start after, or ofnode_null() to start at the root
+ * @compat:	Compatible string to find
+ * @nodep:	Returns the node on success
+ * @return 0 if found, -ENOENT if there is no such node, -ENOSYS if the
+ *	index is not available, in which case the caller must scan the tree
+ */
+int of_index_find_compatible(ofnode from, const char *compat, ofnode *nodep);
+
+/**
+ * of_index_find_driver() - Find the driver for a compatible string
+ *
+ * This gives the same result as checking each driver's of_match table in
+ * turn: the first driver, and its first entry, which match @compat.
+ *
+ * @compat:	Compatible string to find
+ * @drvp:	Returns the driver on success
+ * @idp:	Returns the matching of_match entry on success
+ * @return 0 if found, -ENOENT if no driver matches, -ENOSYS if the index is
+ *	not available, in which case the caller must scan the driver list
+ */
+int of_index_find_driver(const char *compat, struct driver **drvp,
+			 const struct udevice_id **idp);
+
+/**
+ * of_index_invalidate() - Drop the device tree indexes
+ *
+ * This must be called when the tree is changed in a way that the index
+ * cannot detect: the live tree is checked for a new root and the flat tree
+ * for a new address or size, but nodes and properties of the live tree can
+ * be changed in place. The indexes are rebuilt on next use.
+ */
+void of_index_invalidate(void);
+#else
+static inline int of_index_find_phandle(uint phandle, ofnode *nodep)
+{
+	return -ENOSYS;
+}
+
+static inline int of_index_find_compatible(ofnode from, const char *compat,
+					   ofnode *nodep)
+{
+	return -ENOSYS;
+}
+
+static inline int of_index_find_driver(const char *compat,
+				       struct driver **drvp,
+				       const struct udevice_id **idp)
+{
+	return -ENOSYS;
+}
+
+static inline void of_index_invalidate(void) {}
+#endif
+
+#endif
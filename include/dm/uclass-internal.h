@@ -24,6 +24,28 @@
  */
 int uclass_find_next_free_req_seq(enum uclass_id id);
 
+/**
+ * uclass_set_dev_seq() - Set the sequence number of a device
+ *
+ * This must be used rather than setting dev->seq directly, so that the
+ * uclass can keep track of it.
+ *
+ * @dev:	Device to update
+ * @seq:	New sequence number, or -1 if none
+ */
+void uclass_set_dev_seq(struct udevice *dev, int seq);
+
+/**
+ * uclass_set_dev_name() - Set the name of a device
+ *
+ * This must be used rather than setting dev->name directly once the device
+ * is bound, so that the uclass can keep track of it.
+ *
+ * @dev:	Device to update
+ * @name:	New name, which must remain valid while the device is bound
+ */
+void uclass_set_dev_name(struct udevice *dev, const char *name);
+
 /**
  * uclass_get_device_tail() - handle the end of a get_device call
  *
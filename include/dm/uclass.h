@@ -30,12 +30,17 @@
  * @dev_head: List of devices in this uclass (devices are attached to their
  * uclass when their bind method is called)
  * @sibling_node: Next uclass in the linked list of uclasses
+ * @index: Tables to look up devices by position, name and sequence number,
+ * or NULL if not available (see CONFIG_DM_UCLASS_INDEX)
  */
 struct uclass {
 	void *priv;
 	struct uclass_driver *uc_drv;
 	struct list_head dev_head;
 	struct list_head sibling_node;
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	struct uclass_index *index;
+#endif
 };
 
 struct driver;
@@ -271,7 +276,8 @@ int uclass_get_device_by_driver(enum uclass_id id, const struct driver *drv,
  * The device returned is probed if necessary, and ready for use
  *
  * This function is useful to start iterating through a list of devices which
- * are functioning correctly and can be probed.
+ * are functioning correctly and can be probed. Devices whose probe is deferred
+ * (see CONFIG_DM_DEFERRED_PROBE) are probed like any other.
  *
  * @id: Uclass ID to look up
  * @devp: Returns pointer to the first device in that uclass if no error
@@ -325,7 +331,8 @@ int uclass_next_device_err(struct udevice **devp);
  * The device returned is probed if necessary, and ready for use
  *
  * This function is useful to start iterating through a list of devices which
- * are functioning correctly and can be probed.
+ * are functioning correctly and can be probed. Devices whose probe is deferred
+ * until first use (see CONFIG_DM_DEFERRED_PROBE) are skipped.
  *
  * @id: Uclass ID to look up
  * @devp: Returns pointer to the first device in that uclass, or NULL if there
@@ -341,7 +348,8 @@ int uclass_first_device_check(enum uclass_id id, struct udevice **devp);
  * The device returned is probed if necessary, and ready for use
  *
  * This function is useful to start iterating through a list of devices which
- * are functioning correctly and can be probed.
+ * are functioning correctly and can be probed. Devices whose probe is deferred
+ * until first use (see CONFIG_DM_DEFERRED_PROBE) are skipped.
  *
  * @devp: On entry, pointer to device to lookup. On exit, returns pointer
  * to the next device in the uclass if any
@@ -190,12 +190,28 @@ struct dwmci_host {
 	 * @freq:	Frequency the host is trying to achieve
 	 */
 	unsigned int (*get_mmc_clk)(struct dwmci_host *host, uint freq);
+
+	/**
+	 * Find the sample point for a mode which needs tuning
+	 *
+	 * This is called by the MMC core for HS200 and UHS SDR50/SDR104.
+	 * Set to NULL if tuning is not supported.
+	 *
+	 * @host:	DWMMC host
+	 * @opcode:	Command to read the tuning block with
+	 * @return 0 if OK, -ve on error
+	 */
+	int (*execute_tuning)(struct dwmci_host *host, u32 opcode);
 #ifndef CONFIG_BLK
 	struct mmc_config cfg;
 #endif
 
 	/* use fifo mode to read and write data */
 	bool fifo_mode;
+
+	/* IDMAC descriptor chain, kept from one transfer to the next */
+	struct dwmci_idmac *idmac;
+	unsigned int idmac_count;
 };
 
 struct dwmci_idmac {
@@ -304,6 +320,7 @@ int add_dwmci(struct dwmci_host *host, u32 max_clk, u32 min_clk);
 #ifdef CONFIG_DM_MMC
 /* Export the operations to drivers */
 int dwmci_probe(struct udevice *dev);
+int dwmci_remove(struct udevice *dev);
 extern const struct dm_mmc_ops dm_dwmci_ops;
 #endif
 
@@ -188,6 +188,7 @@ enum env_location {
 	ENVL_ONENAND,
 	ENVL_REMOTE,
 	ENVL_SPI_FLASH,
+	ENVL_SPI_FLASH_LOG,
 	ENVL_UBI,
 	ENVL_NOWHERE,
 
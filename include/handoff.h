@@ -31,6 +31,16 @@ struct spl_handoff {
 void handoff_save_dram(struct spl_handoff *ho);
 void handoff_load_dram_size(struct spl_handoff *ho);
 void handoff_load_dram_banks(struct spl_handoff *ho);
+
+/**
+ * handoff_save_arch() - Save architecture-specific hand-off information
+ *
+ * This is called by SPL just before it jumps to U-Boot proper, to fill in
+ * @ho->arch. The default implementation does nothing.
+ *
+ * @ho: Hand-off information to update
+ */
+void handoff_save_arch(struct spl_handoff *ho);
 #endif
 
 #endif
@@ -302,6 +302,7 @@ enum {
 	IH_COMP_LZMA,			/* lzma  Compression Used	*/
 	IH_COMP_LZO,			/* lzo   Compression Used	*/
 	IH_COMP_LZ4,			/* lz4   Compression Used	*/
+	IH_COMP_ZSTD,			/* zstd  Compression Used	*/
 
 	IH_COMP_COUNT,
 };
@@ -1060,6 +1061,34 @@ int fit_conf_get_node(const void *fit, const char *conf_uname);
  */
 int fit_conf_get_prop_node(const void *fit, int noffset,
 		const char *prop_name);
+int fit_conf_get_prop_node_count(const void *fit, int noffset,
+		const char *prop_name);
+int fit_conf_get_prop_node_index(const void *fit, int noffset,
+		const char *prop_name, int index);
+
+/**
+ * fit_dev_load() - Read a FIT image from a device on demand
+ *
+ * Reads the FIT structure from the device into memory at @addr, then reads
+ * the external data of only those subimages which are needed: either the
+ * single image @image_uname, or all images referenced by the configuration
+ * @conf_uname. Each subimage is placed at the position it has in the FIT,
+ * so that the resulting (sparse) copy at @addr can be used by bootm, fpga
+ * etc. like a fully loaded image. Embedded-data FITs are read completely.
+ * Nothing is written beyond the free memory at @addr.
+ *
+ * @ifname:	Interface name ("sf" for SPI flash, else a block interface
+ *		such as "mmc" or "usb")
+ * @dev_part_str: Device and partition (e.g. "0:1"), or bus:cs for "sf"
+ * @offset:	Byte offset of the FIT on the device or partition
+ * @addr:	Address to read the FIT to
+ * @conf_uname:	Configuration to load, NULL for the default one
+ * @image_uname: Single image to load instead of a configuration, or NULL
+ * @return 0 if OK, -ENOSPC if the FIT or a subimage does not fit in memory,
+ *	other -ve on error
+ */
+int fit_dev_load(const char *ifname, const char *dev_part_str, ulong offset,
+		 ulong addr, const char *conf_uname, const char *image_uname);
 
 int fit_check_ramdisk(const void *fit, int os_noffset,
 		uint8_t arch, int verify);
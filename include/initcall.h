@@ -20,6 +20,7 @@ static inline int initcall_run_list(const init_fnc_t init_sequence[])
 
 	for (init_fnc_ptr = init_sequence; *init_fnc_ptr; ++init_fnc_ptr) {
 		unsigned long reloc_ofs = 0;
+		__maybe_unused uint32_t start_us;
 		int ret;
 
 		if (gd->flags & GD_FLG_RELOC)
@@ -32,7 +33,15 @@ static inline int initcall_run_list(const init_fnc_t init_sequence[])
 			debug(" (relocated to %p)\n", (char *)*init_fnc_ptr);
 		else
 			debug("\n");
+#if CONFIG_IS_ENABLED(BOOTSTAGE_INITCALL)
+		start_us = timer_get_boot_us();
 		ret = (*init_fnc_ptr)();
+		bootstage_accum_initcall((ulong)*init_fnc_ptr - reloc_ofs,
+					 start_us,
+					 (uint32_t)timer_get_boot_us() - start_us);
+#else
+		ret = (*init_fnc_ptr)();
+#endif
 		if (ret) {
 			printf("initcall sequence %p failed at call %p (err=%d)\n",
 			       init_sequence,
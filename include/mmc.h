@@ -70,9 +70,11 @@
 #define MMC_MODE_4BIT		BIT(29)
 #define MMC_MODE_1BIT		BIT(28)
 #define MMC_MODE_SPI		BIT(27)
+#define MMC_CAP_CMD23		BIT(26)	/* SET_BLOCK_COUNT before reads */
 
 
 #define SD_DATA_4BIT	0x00040000
+#define SD_CMD23_SUPPORT	0x00000002
 
 #define IS_SD(x)	((x)->version & SD_VERSION_SD)
 #define IS_MMC(x)	((x)->version & MMC_VERSION_MMC)
@@ -622,6 +624,14 @@ struct mmc {
 	char init_in_progress;	/* 1 if we have done mmc_start_init() */
 	char preinit;		/* start init as early as possible */
 	int ddr_mode;
+#if CONFIG_IS_ENABLED(MMC_INIT_CACHE)
+	bool init_cached;	/* the fields below, csd and ext_csd are valid
+				 * for the card with this cid */
+	enum bus_mode cached_mode;	/* mode selected by the last init */
+	uint cached_bus_width;	/* bus width selected by the last init */
+	uint cached_version;	/* version found by the last init */
+	bool reusing_mode;	/* selecting cached_mode, which needs no check */
+#endif
 #if CONFIG_IS_ENABLED(DM_MMC)
 	struct udevice *dev;	/* Device for this MMC controller */
 #if CONFIG_IS_ENABLED(DM_REGULATOR)
@@ -687,6 +697,19 @@ void mmc_destroy(struct mmc *mmc);
  */
 int mmc_unbind(struct udevice *dev);
 int mmc_initialize(bd_t *bis);
+
+/**
+ * mmc_start_async_init() - Probe MMC devices and start card initialisation
+ *
+ * This probes the controllers and calls mmc_start_init() on each, without
+ * waiting for the cards to power up. mmc_initialize() can be called later
+ * to list the devices, and mmc_init() completes the initialisation of a
+ * card when it is first used.
+ *
+ * @bis:	Board information
+ * @return 0 if OK, -ve on error
+ */
+int mmc_start_async_init(bd_t *bis);
 int mmc_init(struct mmc *mmc);
 int mmc_send_tuning(struct mmc *mmc, u32 opcode, int *cmd_error);
 
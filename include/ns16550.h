@@ -94,6 +94,11 @@ struct NS16550 {
 #endif
 #ifdef CONFIG_DM_SERIAL
 	struct ns16550_platdata *plat;
+#if CONFIG_IS_ENABLED(NS16550_TX_BUFFER)
+	char *tx_buf;		/* TX ring buffer, NULL if not (yet) used */
+	uint tx_head;		/* Next free position in tx_buf */
+	uint tx_tail;		/* Next character to send from tx_buf */
+#endif
 #endif
 };
 
@@ -242,6 +247,14 @@ int ns16550_serial_ofdata_to_platdata(struct udevice *dev);
  */
 int ns16550_serial_probe(struct udevice *dev);
 
+/**
+ * ns16550_serial_remove() - remove a serial port
+ *
+ * This sends any buffered output and frees the output buffer
+ * @return 0, or -ve on error
+ */
+int ns16550_serial_remove(struct udevice *dev);
+
 /**
  * struct ns16550_serial_ops - ns16550 serial operations
  *
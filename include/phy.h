@@ -52,6 +52,12 @@
 
 struct phy_device;
 
+/* Progress of autonegotiation, see CONFIG_PHY_AUTONEG_BACKGROUND */
+enum phy_aneg_state {
+	PHY_ANEG_IDLE,		/* Not started, or already waited for */
+	PHY_ANEG_RUNNING,	/* Started at aneg_start */
+};
+
 #define MDIO_NAME_LEN 32
 
 struct mii_dev {
@@ -140,6 +146,11 @@ struct phy_device {
 	u32 phy_id;
 	bool is_c45;
 	u32 flags;
+#ifdef CONFIG_PHY_AUTONEG_BACKGROUND
+	/* State of autonegotiation and when it was (re)started */
+	enum phy_aneg_state aneg_state;
+	ulong aneg_start;
+#endif
 };
 
 struct fixed_link {
@@ -178,6 +189,7 @@ static inline int is_10g_interface(phy_interface_t interface)
 
 int phy_init(void);
 int phy_reset(struct phy_device *phydev);
+
 struct phy_device *phy_find_by_mask(struct mii_dev *bus, unsigned phy_mask,
 		phy_interface_t interface);
 #ifdef CONFIG_DM_ETH
@@ -0,0 +1,104 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Statistical sampling profiler
+ */
+
+#ifndef __PROFILE_H
+#define __PROFILE_H
+
+/* Size of the stack used by the profiler's timer interrupt */
+#define PROFILE_IRQ_STACK_SIZE	1024
+
+/**
+ * profile_start() - Start taking samples
+ *
+ * Any samples from a previous run are discarded.
+ *
+ * @rate:	Number of samples per second
+ * @return 0 if OK, -EBUSY if already running, -ENOMEM if the sample buffer
+ *	could not be allocated, or other -ve error from the timer
+ */
+int profile_start(uint rate);
+
+/**
+ * profile_stop() - Stop taking samples
+ *
+ * The samples taken so far are kept for profile_report(). This does nothing
+ * if the profiler is not running.
+ */
+void profile_stop(void);
+
+/**
+ * profile_running() - Check whether the profiler is taking samples
+ *
+ * @return true if profile_start() has set up the timer interrupt and
+ *	profile_stop() has not been called since
+ */
+bool profile_running(void);
+
+/**
+ * profile_sample() - Record a sample
+ *
+ * This is called from the timer interrupt. If the sample buffer is full,
+ * the oldest sample is overwritten.
+ *
+ * @pc:		Address of the interrupted instruction
+ * @lr:		Link register of the interrupted code
+ */
+void profile_sample(ulong pc, ulong lr);
+
+/**
+ * profile_report() - Print a flat profile
+ *
+ * Samples are grouped by function, using the builtin symbol table if
+ * CONFIG_KALLSYMS is enabled, otherwise by address.
+ *
+ * @count:	Maximum number of functions to show, 0 for all
+ * @return 0 if OK, -ENOENT if there are no samples, -ENOMEM if out of memory
+ */
+int profile_report(int count);
+
+/**
+ * profile_list_samples() - Dump the samples into a buffer
+ *
+ * The buffer holds a struct trace_output_hdr of type TRACE_CHUNK_SAMPLES
+ * followed by one struct trace_sample per sample, oldest first, which can
+ * be converted with tools/proftool.
+ *
+ * @buff:	Buffer in which to place data
+ * @buff_size:	Size of buffer
+ * @needed:	Returns number of bytes used / needed
+ * @return 0 if OK, -ENOSPC if the buffer is too small
+ */
+int profile_list_samples(void *buff, int buff_size, unsigned int *needed);
+
+/*
+ * The following are provided by the architecture, see
+ * CONFIG_HAVE_PROFILE_TIMER.
+ */
+
+/**
+ * profile_timer_start() - Start a periodic timer interrupt
+ *
+ * On each interrupt, the architecture's interrupt handler calls
+ * profile_timer_irq() and if that returns 1, profile_sample().
+ *
+ * @rate:	Number of interrupts per second
+ * @return 0 if OK, -ve on error
+ */
+int profile_timer_start(uint rate);
+
+/**
+ * profile_timer_stop() - Stop the periodic timer interrupt
+ */
+void profile_timer_stop(void);
+
+/**
+ * profile_timer_irq() - Acknowledge the pending interrupt
+ *
+ * @return 1 if it was the profiler's timer interrupt, 0 if it was spurious
+ *	and can be ignored, or -ve error if it was some other interrupt
+ */
+int profile_timer_irq(void);
+
+#endif
@@ -186,6 +186,7 @@
 /* 55-57 reserved */
 
 #define SDHCI_ADMA_ADDRESS	0x58
+#define SDHCI_ADMA_ADDRESS_HI	0x5c
 
 /* 60-FB reserved */
 
@@ -226,6 +227,8 @@
 #define SDHCI_QUIRK_WAIT_SEND_CMD	(1 << 6)
 #define SDHCI_QUIRK_USE_WIDE8		(1 << 8)
 #define SDHCI_QUIRK_NO_1_8_V		(1 << 9)
+/* Controller advertises ADMA2 but it does not work */
+#define SDHCI_QUIRK_BROKEN_ADMA		BIT(10)
 
 /* to make gcc happy */
 struct sdhci_host;
@@ -272,6 +275,11 @@ struct sdhci_host {
 	uint	voltages;
 
 	struct mmc_config cfg;
+#if CONFIG_IS_ENABLED(MMC_SDHCI_ADMA)
+	void *adma_desc;		/* ADMA2 descriptor table */
+	unsigned int adma_max_len;	/* Bytes the table can describe */
+	bool adma64;			/* Use 64-bit descriptors */
+#endif
 };
 
 #ifdef CONFIG_MMC_SDHCI_IO_ACCESSORS
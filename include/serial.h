@@ -280,6 +280,16 @@ struct serial_dev_priv {
 /* Access the serial operations for a device */
 #define serial_get_ops(dev)	((struct dm_serial_ops *)(dev)->driver->ops)
 
+/**
+ * serial_flush() - Wait until all console output has been sent
+ *
+ * Drivers may buffer output (see ns16550). This waits until the pending()
+ * method of the console device reports no more output characters. It is
+ * called before bootm starts an OS, on panic and, on ARM, by do_reset(), so
+ * that output is not lost at those points.
+ */
+void serial_flush(void);
+
 /**
  * serial_getconfig() - Get the uart configuration
  * (parity, 5/6/7/8 bits word length, stop bits)
@@ -28,6 +28,7 @@ enum {
 enum trace_chunk_type {
 	TRACE_CHUNK_FUNCS,
 	TRACE_CHUNK_CALLS,
+	TRACE_CHUNK_SAMPLES,
 };
 
 /* A trace record for a function, as written to the profile output file */
@@ -79,6 +80,15 @@ struct trace_call {
 
 int trace_list_calls(void *buff, int buff_size, unsigned int *needed);
 
+/*
+ * A sample taken by the sampling profiler (see include/profile.h). Both
+ * values are offsets from CONFIG_SYS_TEXT_BASE.
+ */
+struct trace_sample {
+	uint32_t pc;		/* Interrupted instruction */
+	uint32_t lr;		/* Link register, often within the caller */
+};
+
 /**
  * Turn function tracing on and off
  *
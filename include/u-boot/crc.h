@@ -41,6 +41,25 @@ uint32_t crc32_no_comp (uint32_t, const unsigned char *, uint);
 void crc32_wd_buf(const unsigned char *input, uint ilen,
 		    unsigned char *output, uint chunk_sz);
 
+/**
+ * crc32_no_comp_arch() - Architecture-specific CRC32 (no ones complement)
+ *
+ * Provided by the architecture when CONFIG_CRC32_ARCH is enabled.
+ *
+ * @crc:	CRC to update
+ * @buf:	Input buffer, no alignment requirement
+ * @len:	Input buffer length
+ * @return 1 if the CRC was updated, 0 if the CPU does not support the
+ *	required instructions and the generic code must be used instead
+ */
+int crc32_no_comp_arch(uint32_t *crc, const unsigned char *buf, uint len);
+
+/*
+ * Set to 0 to force the generic C code, e.g. for benchmarking. Defined
+ * next to crc32_no_comp_arch().
+ */
+extern int crc32_use_arch;
+
 /* lib/crc32c.c */
 void crc32c_init(uint32_t *, uint32_t);
 uint32_t crc32c_cal(uint32_t, const char *, int, uint32_t *);
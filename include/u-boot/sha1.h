@@ -81,6 +81,23 @@ void sha1_csum(const unsigned char *input, unsigned int ilen,
 void sha1_csum_wd(const unsigned char *input, unsigned int ilen,
 		unsigned char *output, unsigned int chunk_sz);
 
+/**
+ * \brief	   Architecture-specific SHA-1 block function, provided by the
+ *		   architecture when CONFIG_SHA1_ARCH is enabled
+ *
+ * \param state    intermediate digest state, updated in place
+ * \param data	   input data, blocks * 64 bytes, no alignment requirement
+ * \param blocks   number of 64-byte blocks to process (at least 1)
+ *
+ * \return	   1 if the blocks were processed, 0 if the CPU lacks the
+ *		   required instructions and the generic code must be used
+ */
+int sha1_blocks_arch(unsigned long state[5], const unsigned char *data,
+		     unsigned int blocks);
+
+/* Set to 0 to force the generic C code, e.g. for benchmarking */
+extern int sha1_use_arch;
+
 /**
  * \brief	   Output = HMAC-SHA-1( input buffer, hmac key )
  *
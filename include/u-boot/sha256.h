@@ -22,4 +22,21 @@ void sha256_finish(sha256_context * ctx, uint8_t digest[SHA256_SUM_LEN]);
 void sha256_csum_wd(const unsigned char *input, unsigned int ilen,
 		unsigned char *output, unsigned int chunk_sz);
 
+/**
+ * sha256_blocks_arch() - Architecture-specific SHA-256 block function
+ *
+ * Provided by the architecture when CONFIG_SHA256_ARCH is enabled.
+ *
+ * @state:	Intermediate digest state, updated in place
+ * @data:	Input data, @blocks * 64 bytes with no alignment requirement
+ * @blocks:	Number of 64-byte blocks to process (at least 1)
+ * @return 1 if the blocks were processed, 0 if the CPU does not support
+ *	the required instructions and the generic code must be used instead
+ */
+int sha256_blocks_arch(uint32_t state[8], const uint8_t *data,
+		       unsigned int blocks);
+
+/* Set to 0 to force the generic C code, e.g. for benchmarking */
+extern int sha256_use_arch;
+
 #endif /* _SHA256_H */
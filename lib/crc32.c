@@ -29,6 +29,12 @@
 
 #define tole(x) cpu_to_le32(x)
 
+#ifndef USE_HOSTCC
+#if CONFIG_IS_ENABLED(CRC32_SLICE8) && !defined(CONFIG_DYNAMIC_CRC_TABLE)
+#define CRC32_SLICE8
+#endif
+#endif
+
 #ifdef CONFIG_DYNAMIC_CRC_TABLE
 
 static int __efi_runtime_data crc_table_empty = 1;
@@ -82,6 +88,8 @@ static void __efi_runtime make_crc_table(void)
   }
   crc_table_empty = 0;
 }
+#elif defined(CRC32_SLICE8)
+#include "crc32_slice8.h"
 #else
 /* ========================================================================
  * Table of CRC-32's of all single-byte values (made by make_crc_table)
@@ -168,6 +176,38 @@ const uint32_t * ZEXPORT get_crc_table()
 }
 #endif
 
+#ifdef CRC32_SLICE8
+/*
+ * Slice-by-8: eight bytes are folded into the CRC per iteration, using one
+ * table per byte position, instead of a dependent table lookup per byte.
+ * The CRC is kept in CPU byte order.
+ */
+static uint32_t __efi_runtime crc32_no_comp_generic(uint32_t crc,
+						    const Bytef *buf, uInt len)
+{
+	const uint32_t (*t)[256] = crc_table8;
+	uint32_t one, two;
+
+	while (len && ((uintptr_t)buf & 3)) {
+		crc = t[0][(crc ^ *buf++) & 0xff] ^ (crc >> 8);
+		len--;
+	}
+
+	for (; len >= 8; len -= 8, buf += 8) {
+		one = le32_to_cpu(*(const uint32_t *)buf) ^ crc;
+		two = le32_to_cpu(*(const uint32_t *)(buf + 4));
+		crc = t[7][one & 0xff] ^ t[6][(one >> 8) & 0xff] ^
+		      t[5][(one >> 16) & 0xff] ^ t[4][one >> 24] ^
+		      t[3][two & 0xff] ^ t[2][(two >> 8) & 0xff] ^
+		      t[1][(two >> 16) & 0xff] ^ t[0][two >> 24];
+	}
+
+	while (len--)
+		crc = t[0][(crc ^ *buf++) & 0xff] ^ (crc >> 8);
+
+	return crc;
+}
+#else
 /* ========================================================================= */
 # if __BYTE_ORDER == __LITTLE_ENDIAN
 #  define DO_CRC(x) crc = tab[(crc ^ (x)) & 255] ^ (crc >> 8)
@@ -177,10 +217,8 @@ const uint32_t * ZEXPORT get_crc_table()
 
 /* ========================================================================= */
 
-/* No ones complement version. JFFS2 (and other things ?)
- * don't use ones compliment in their CRC calculations.
- */
-uint32_t __efi_runtime crc32_no_comp(uint32_t crc, const Bytef *buf, uInt len)
+static uint32_t __efi_runtime crc32_no_comp_generic(uint32_t crc,
+						    const Bytef *buf, uInt len)
 {
     const uint32_t *tab = crc_table;
     const uint32_t *b =(const uint32_t *)buf;
@@ -221,6 +259,20 @@ uint32_t __efi_runtime crc32_no_comp(uint32_t crc, const Bytef *buf, uInt len)
     return le32_to_cpu(crc);
 }
 #undef DO_CRC
+#endif /* CRC32_SLICE8 */
+
+/* No ones complement version. JFFS2 (and other things ?)
+ * don't use ones compliment in their CRC calculations.
+ */
+uint32_t __efi_runtime crc32_no_comp(uint32_t crc, const Bytef *buf, uInt len)
+{
+#if defined(CONFIG_CRC32_ARCH) && !defined(USE_HOSTCC)
+	if (crc32_use_arch && crc32_no_comp_arch(&crc, buf, len))
+		return crc;
+#endif
+
+	return crc32_no_comp_generic(crc, buf, len);
+}
 
 uint32_t __efi_runtime crc32(uint32_t crc, const Bytef *p, uInt len)
 {
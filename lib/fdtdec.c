@@ -8,6 +8,7 @@
 #include <boot_fit.h>
 #include <dm.h>
 #include <dm/of_extra.h>
+#include <dm/of_index.h>
 #include <errno.h>
 #include <fdtdec.h>
 #include <fdt_support.h>
@@ -633,6 +634,23 @@ int fdtdec_prepare_fdt(void)
 	return 0;
 }
 
+/* Look up a phandle, using the index if this is U-Boot's own flat tree */
+static int fdtdec_node_offset_by_phandle(const void *blob, uint32_t phandle)
+{
+	ofnode node;
+	int ret;
+
+	if (blob == gd->fdt_blob && !of_live_active()) {
+		ret = of_index_find_phandle(phandle, &node);
+		if (!ret)
+			return ofnode_to_offset(node);
+		else if (ret != -ENOSYS)
+			return -FDT_ERR_NOTFOUND;
+	}
+
+	return fdt_node_offset_by_phandle(blob, phandle);
+}
+
 int fdtdec_lookup_phandle(const void *blob, int node, const char *prop_name)
 {
 	const u32 *phandle;
@@ -643,7 +661,7 @@ int fdtdec_lookup_phandle(const void *blob, int node, const char *prop_name)
 	if (!phandle)
 		return -FDT_ERR_NOTFOUND;
 
-	lookup = fdt_node_offset_by_phandle(blob, fdt32_to_cpu(*phandle));
+	lookup = fdtdec_node_offset_by_phandle(blob, fdt32_to_cpu(*phandle));
 	return lookup;
 }
 
@@ -774,8 +792,8 @@ int fdtdec_parse_phandle_with_args(const void *blob, int src_node,
 			 * below.
 			 */
 			if (cells_name || cur_index == index) {
-				node = fdt_node_offset_by_phandle(blob,
-								  phandle);
+				node = fdtdec_node_offset_by_phandle(blob,
+								     phandle);
 				if (!node) {
 					debug("%s: could not find phandle\n",
 					      fdt_get_name(blob, src_node,
@@ -10,6 +10,7 @@
  */
 
 #include <common.h>
+#include <serial.h>
 #if !defined(CONFIG_PANIC_HANG)
 #include <command.h>
 #endif
@@ -19,6 +20,9 @@ static void panic_finish(void) __attribute__ ((noreturn));
 static void panic_finish(void)
 {
 	putc('\n');
+#if CONFIG_IS_ENABLED(DM_SERIAL)
+	serial_flush();
+#endif
 #if defined(CONFIG_PANIC_HANG)
 	hang();
 #else
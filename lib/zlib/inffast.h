@@ -8,4 +8,12 @@
    subject to change. Applications should only use zlib.h.
  */
 
+/* U-Boot: minimum input and output space for calling inflate_fast() */
+#ifdef CONFIG_ZLIB_INFFAST_WIDE
+#define INFLATE_FAST_MIN_HAVE 8
+#else
+#define INFLATE_FAST_MIN_HAVE 6
+#endif
+#define INFLATE_FAST_MIN_LEFT 258
+
 void inflate_fast OF((z_streamp strm, unsigned start));
@@ -0,0 +1,1132 @@
+// SPDX-License-Identifier: GPL-2.0+ OR BSD-3-Clause
+/*
+ * Zstandard decompression
+ *
+ * A compact single-pass decoder for the Zstandard format as specified in
+ * RFC 8878. Frames are decoded straight into the flat output buffer, which
+ * also serves as the history window, so no separate window buffer is
+ * needed. Dictionaries are not supported.
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <malloc.h>
+#include <asm/unaligned.h>
+#include <linux/bitops.h>
+
+#define ZSTD_MAGIC		0xfd2fb528
+#define ZSTD_SKIPPABLE_MAGIC	0x184d2a50
+#define ZSTD_SKIPPABLE_MASK	0xfffffff0
+
+#define ZSTD_BLOCK_SIZE_MAX	(128 * 1024)
+
+enum {
+	ZSTD_BLOCK_RAW,
+	ZSTD_BLOCK_RLE,
+	ZSTD_BLOCK_COMPRESSED,
+	ZSTD_BLOCK_RESERVED,
+};
+
+enum {
+	ZSTD_LIT_RAW,
+	ZSTD_LIT_RLE,
+	ZSTD_LIT_COMPRESSED,
+	ZSTD_LIT_TREELESS,
+};
+
+enum {
+	ZSTD_MODE_PREDEFINED,
+	ZSTD_MODE_RLE,
+	ZSTD_MODE_FSE,
+	ZSTD_MODE_REPEAT,
+};
+
+#define HUF_MAX_LOG		11
+#define HUF_MAX_SYMBOLS		256
+#define HUF_WEIGHTS_MAX_LOG	6
+
+#define LL_MAX_LOG		9
+#define ML_MAX_LOG		9
+#define OF_MAX_LOG		8
+#define LL_MAX_SYMBOL		35
+#define ML_MAX_SYMBOL		52
+#define OF_MAX_SYMBOL		31
+
+#define FSE_MAX_SYMBOLS		256
+
+/* FSE decoding table entry */
+struct fse_entry {
+	u16 base;		/* base of the next state */
+	u8 symbol;
+	u8 nbits;		/* bits to read for the next state */
+};
+
+/* Huffman decoding table entry */
+struct huf_entry {
+	u8 symbol;
+	u8 nbits;
+};
+
+/* A sequence decoding table, plus whether it may be repeated */
+struct zstd_seq_table {
+	struct fse_entry *table;
+	u8 log;
+	bool valid;
+};
+
+struct zstd_ctx {
+	struct fse_entry ll_fse[1 << LL_MAX_LOG];
+	struct fse_entry of_fse[1 << OF_MAX_LOG];
+	struct fse_entry ml_fse[1 << ML_MAX_LOG];
+	struct zstd_seq_table ll, of, ml;
+	struct huf_entry huf[1 << HUF_MAX_LOG];
+	u8 huf_log;		/* 0 if there is no Huffman table yet */
+	u32 rep[3];		/* repeated offsets */
+	u8 literals[ZSTD_BLOCK_SIZE_MAX];
+};
+
+/*
+ * Baselines and extra bits for literal length and match length codes, and
+ * the predefined distributions, all from RFC 8878 section 3.1.1.3.2.1
+ */
+static const u32 ll_base[LL_MAX_SYMBOL + 1] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+	16, 18, 20, 22, 24, 28, 32, 40, 48, 64, 0x80, 0x100, 0x200, 0x400,
+	0x800, 0x1000, 0x2000, 0x4000, 0x8000, 0x10000,
+};
+
+static const u8 ll_bits[LL_MAX_SYMBOL + 1] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	1, 1, 1, 1, 2, 2, 3, 3, 4, 6, 7, 8, 9, 10, 11, 12,
+	13, 14, 15, 16,
+};
+
+static const u32 ml_base[ML_MAX_SYMBOL + 1] = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+	19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34,
+	35, 37, 39, 41, 43, 47, 51, 59, 67, 83, 99, 0x83, 0x103, 0x203,
+	0x403, 0x803, 0x1003, 0x2003, 0x4003, 0x8003, 0x10003,
+};
+
+static const u8 ml_bits[ML_MAX_SYMBOL + 1] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	1, 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 7, 8, 9, 10, 11,
+	12, 13, 14, 15, 16,
+};
+
+static const s16 ll_default[LL_MAX_SYMBOL + 1] = {
+	4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1,
+	2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1,
+	-1, -1, -1, -1,
+};
+
+static const s16 ml_default[ML_MAX_SYMBOL + 1] = {
+	1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1,
+	-1, -1, -1, -1, -1,
+};
+
+static const s16 of_default[29] = {
+	1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1,
+};
+
+#define LL_DEFAULT_LOG		6
+#define ML_DEFAULT_LOG		6
+#define OF_DEFAULT_LOG		5
+
+/*
+ * Backward bit stream, as used for Huffman and FSE coded data. The stream
+ * is read from its last byte towards its first, the highest set bit of the
+ * last byte marking the start. Reading beyond the start gives zero bits,
+ * which the decoders rely on; bwd_left() goes negative in that case.
+ */
+struct bwd_bits {
+	const u8 *start;
+	const u8 *ptr;		/* location of the bit container in memory */
+	u64 bits;		/* bit container */
+	uint consumed;		/* bits consumed from the top of @bits */
+};
+
+static int bwd_init(struct bwd_bits *b, const u8 *src, size_t len)
+{
+	u8 last;
+	size_t i;
+
+	if (!len)
+		return -EINVAL;
+	last = src[len - 1];
+	if (!last)
+		return -EINVAL;
+
+	b->start = src;
+	if (len >= sizeof(b->bits)) {
+		b->ptr = src + len - sizeof(b->bits);
+		b->bits = get_unaligned_le64(b->ptr);
+		b->consumed = 0;
+	} else {
+		b->ptr = src;
+		b->bits = 0;
+		for (i = 0; i < len; i++)
+			b->bits |= (u64)src[i] << (8 * i);
+		b->consumed = (sizeof(b->bits) - len) * 8;
+	}
+	/* Skip the padding and the marker bit */
+	b->consumed += 9 - fls(last);
+
+	return 0;
+}
+
+static inline u64 bwd_peek(struct bwd_bits *b, uint nbits)
+{
+	if (b->consumed >= 64)
+		return 0;
+
+	return ((b->bits << b->consumed) >> 1) >> (63 - nbits);
+}
+
+static inline u64 bwd_read(struct bwd_bits *b, uint nbits)
+{
+	u64 val = bwd_peek(b, nbits);
+
+	b->consumed += nbits;
+
+	return val;
+}
+
+/* Refill the bit container; afterwards at least 57 bits can be read */
+static inline void bwd_reload(struct bwd_bits *b)
+{
+	size_t nbytes;
+
+	if (b->ptr == b->start || b->consumed > 64)
+		return;
+
+	nbytes = b->consumed >> 3;
+	if (nbytes > b->ptr - b->start)
+		nbytes = b->ptr - b->start;
+	b->ptr -= nbytes;
+	b->consumed -= nbytes * 8;
+	b->bits = get_unaligned_le64(b->ptr);
+}
+
+/* Number of bits left in the stream, negative after reading beyond it */
+static inline long bwd_left(struct bwd_bits *b)
+{
+	return (long)(b->ptr - b->start) * 8 + 64 - (long)b->consumed;
+}
+
+/* Read @nbits from a forward bit stream at *@pos, zeroes beyond @len */
+static u32 fwd_read(const u8 *src, size_t len, size_t *pos, uint nbits)
+{
+	u32 val = 0;
+	uint i;
+
+	for (i = 0; i < nbits; i++, (*pos)++) {
+		if (*pos >> 3 < len)
+			val |= ((src[*pos >> 3] >> (*pos & 7)) & 1) << i;
+	}
+
+	return val;
+}
+
+/**
+ * fse_read_counts() - read the normalised counts of an FSE table description
+ *
+ * @src:	FSE table description
+ * @len:	Bytes available at @src
+ * @norm:	Returns the normalised counts
+ * @nsym:	Returns the number of symbols
+ * @log:	Returns the accuracy log
+ * @max_sym:	Largest allowed symbol value
+ * @max_log:	Largest allowed accuracy log
+ * @return number of bytes used, or -ve on error
+ */
+static int fse_read_counts(const u8 *src, size_t len, s16 *norm, uint *nsym,
+			   uint *log, uint max_sym, uint max_log)
+{
+	size_t pos = 0;
+	int remaining;
+	uint sym = 0;
+
+	*log = fwd_read(src, len, &pos, 4) + 5;
+	if (*log > max_log)
+		return -EINVAL;
+
+	remaining = 1 << *log;
+	while (remaining > 0 && sym <= max_sym) {
+		uint nbits = fls(remaining + 1);
+		u32 lower = (1 << (nbits - 1)) - 1;
+		u32 threshold = (1 << nbits) - 1 - (remaining + 1);
+		u32 val = fwd_read(src, len, &pos, nbits);
+		int prob;
+
+		if ((val & lower) < threshold) {
+			pos--;
+			val &= lower;
+		} else if (val > lower) {
+			val -= threshold;
+		}
+		prob = (int)val - 1;
+		remaining -= prob < 0 ? -prob : prob;
+		norm[sym++] = prob;
+
+		/* A zero count is followed by 2-bit repeat flags */
+		if (!prob) {
+			uint repeat, i;
+
+			do {
+				repeat = fwd_read(src, len, &pos, 2);
+				if (sym + repeat > max_sym + 1)
+					return -EINVAL;
+				for (i = 0; i < repeat; i++)
+					norm[sym++] = 0;
+			} while (repeat == 3 && pos >> 3 < len);
+		}
+	}
+	if (remaining || (pos + 7) >> 3 > len)
+		return -EINVAL;
+	*nsym = sym;
+
+	return (pos + 7) >> 3;
+}
+
+/**
+ * fse_build() - build an FSE decoding table from normalised counts
+ *
+ * @table:	Table to fill in, 1 << @log entries
+ * @norm:	Normalised counts (-1 meaning 'less than 1')
+ * @nsym:	Number of symbols in @norm
+ * @log:	Accuracy log
+ * @return 0 if OK, -EINVAL if the counts are invalid
+ */
+static int fse_build(struct fse_entry *table, const s16 *norm, uint nsym,
+		     uint log)
+{
+	u16 next[FSE_MAX_SYMBOLS];
+	uint size = 1 << log;
+	uint mask = size - 1;
+	uint step = (size >> 1) + (size >> 3) + 3;
+	uint high = size;
+	uint pos = 0;
+	uint sym, i;
+
+	/* Low-probability symbols go at the end of the table */
+	for (sym = 0; sym < nsym; sym++) {
+		if (norm[sym] == -1) {
+			if (!high)
+				return -EINVAL;
+			table[--high].symbol = sym;
+			next[sym] = 1;
+		}
+	}
+
+	/* Spread the others over the rest of the table */
+	for (sym = 0; sym < nsym; sym++) {
+		if (norm[sym] <= 0)
+			continue;
+		next[sym] = norm[sym];
+		for (i = 0; i < norm[sym]; i++) {
+			table[pos].symbol = sym;
+			do {
+				pos = (pos + step) & mask;
+			} while (pos >= high);
+		}
+	}
+	if (pos)
+		return -EINVAL;
+
+	for (i = 0; i < size; i++) {
+		u16 state = next[table[i].symbol]++;
+
+		table[i].nbits = log - (fls(state) - 1);
+		table[i].base = (state << table[i].nbits) - size;
+	}
+
+	return 0;
+}
+
+/* Decode Huffman weights which are themselves FSE-compressed */
+static int huf_decode_weights(const u8 *src, size_t len, u8 *weights,
+			      uint *count)
+{
+	struct fse_entry table[1 << HUF_WEIGHTS_MAX_LOG];
+	s16 norm[HUF_MAX_LOG + 1];
+	struct bwd_bits b;
+	uint nsym, log, s1, s2, n = 0;
+	int ret;
+
+	ret = fse_read_counts(src, len, norm, &nsym, &log, HUF_MAX_LOG,
+			      HUF_WEIGHTS_MAX_LOG);
+	if (ret < 0)
+		return ret;
+	if (fse_build(table, norm, nsym, log))
+		return -EINVAL;
+	if (bwd_init(&b, src + ret, len - ret))
+		return -EINVAL;
+
+	/* Two interleaved states share the bit stream */
+	s1 = bwd_read(&b, log);
+	s2 = bwd_read(&b, log);
+	for (;;) {
+		if (n > HUF_MAX_SYMBOLS - 3)
+			return -EINVAL;
+		weights[n++] = table[s1].symbol;
+		s1 = table[s1].base + bwd_read(&b, table[s1].nbits);
+		bwd_reload(&b);
+		if (bwd_left(&b) < 0) {
+			weights[n++] = table[s2].symbol;
+			break;
+		}
+
+		weights[n++] = table[s2].symbol;
+		s2 = table[s2].base + bwd_read(&b, table[s2].nbits);
+		bwd_reload(&b);
+		if (bwd_left(&b) < 0) {
+			weights[n++] = table[s1].symbol;
+			break;
+		}
+	}
+	*count = n;
+
+	return 0;
+}
+
+/**
+ * huf_read_table() - read a Huffman tree description and build the table
+ *
+ * @ctx:	Decompression context, whose Huffman table is replaced
+ * @src:	Huffman tree description
+ * @len:	Bytes available at @src
+ * @return number of bytes used, or -ve on error
+ */
+static int huf_read_table(struct zstd_ctx *ctx, const u8 *src, size_t len)
+{
+	u8 weights[HUF_MAX_SYMBOLS];
+	u8 nbits[HUF_MAX_SYMBOLS];
+	u16 rank_count[HUF_MAX_LOG + 1];
+	u16 rank_idx[HUF_MAX_LOG + 1];
+	uint count, max_bits, i, j;
+	u32 total, left;
+	int used;
+
+	if (!len)
+		return -EINVAL;
+	if (src[0] >= 128) {
+		/* Directly encoded 4-bit weights */
+		count = src[0] - 127;
+		used = 1 + (count + 1) / 2;
+		if (used > len)
+			return -EINVAL;
+		for (i = 0; i < count; i++) {
+			u8 byte = src[1 + i / 2];
+
+			weights[i] = i & 1 ? byte & 0xf : byte >> 4;
+		}
+	} else {
+		used = 1 + src[0];
+		if (used > len ||
+		    huf_decode_weights(src + 1, src[0], weights, &count))
+			return -EINVAL;
+	}
+
+	/* The weight of the last symbol is implied */
+	total = 0;
+	for (i = 0; i < count; i++) {
+		if (weights[i] > HUF_MAX_LOG)
+			return -EINVAL;
+		if (weights[i])
+			total += 1 << (weights[i] - 1);
+	}
+	if (!total)
+		return -EINVAL;
+	max_bits = fls(total);
+	if (max_bits > HUF_MAX_LOG)
+		return -EINVAL;
+	left = (1 << max_bits) - total;
+	if (left & (left - 1))
+		return -EINVAL;
+	weights[count++] = fls(left);
+
+	memset(rank_count, '\0', sizeof(rank_count));
+	for (i = 0; i < count; i++) {
+		nbits[i] = weights[i] ? max_bits + 1 - weights[i] : 0;
+		rank_count[nbits[i]]++;
+	}
+
+	/* Longer codes come first in the table */
+	rank_idx[max_bits] = 0;
+	for (i = max_bits; i >= 1; i--) {
+		rank_idx[i - 1] = rank_idx[i] +
+				  rank_count[i] * (1 << (max_bits - i));
+		for (j = rank_idx[i]; j < rank_idx[i - 1]; j++)
+			ctx->huf[j].nbits = i;
+	}
+	if (rank_idx[0] != 1 << max_bits)
+		return -EINVAL;
+
+	for (i = 0; i < count; i++) {
+		uint n;
+
+		if (!nbits[i])
+			continue;
+		n = 1 << (max_bits - nbits[i]);
+		for (j = 0; j < n; j++)
+			ctx->huf[rank_idx[nbits[i]] + j].symbol = i;
+		rank_idx[nbits[i]] += n;
+	}
+	ctx->huf_log = max_bits;
+
+	return used;
+}
+
+static int huf_decode_stream(struct zstd_ctx *ctx, u8 *dst, size_t count,
+			     const u8 *src, size_t len)
+{
+	const struct huf_entry *huf = ctx->huf;
+	uint log = ctx->huf_log;
+	u8 *end = dst + count;
+	struct bwd_bits b;
+
+	if (bwd_init(&b, src, len))
+		return -EINVAL;
+
+	/* Up to 4 symbols of at most 11 bits fit in a reloaded container */
+	while (end - dst >= 4) {
+		const struct huf_entry *e;
+
+		e = &huf[bwd_peek(&b, log)];
+		*dst++ = e->symbol;
+		b.consumed += e->nbits;
+		e = &huf[bwd_peek(&b, log)];
+		*dst++ = e->symbol;
+		b.consumed += e->nbits;
+		e = &huf[bwd_peek(&b, log)];
+		*dst++ = e->symbol;
+		b.consumed += e->nbits;
+		e = &huf[bwd_peek(&b, log)];
+		*dst++ = e->symbol;
+		b.consumed += e->nbits;
+		bwd_reload(&b);
+	}
+	while (dst < end) {
+		const struct huf_entry *e = &huf[bwd_peek(&b, log)];
+
+		*dst++ = e->symbol;
+		b.consumed += e->nbits;
+	}
+
+	return bwd_left(&b) ? -EINVAL : 0;
+}
+
+/**
+ * zstd_decode_literals() - decode the literals section of a block
+ *
+ * @ctx:	Decompression context
+ * @src:	Start of the literals section
+ * @len:	Bytes available at @src
+ * @litp:	Returns a pointer to the literals
+ * @lit_size:	Returns the number of literals
+ * @return number of bytes used, or -ve on error
+ */
+static int zstd_decode_literals(struct zstd_ctx *ctx, const u8 *src,
+				size_t len, const u8 **litp, size_t *lit_size)
+{
+	uint type, format;
+	size_t hsize, size, csize, seg;
+	const u8 *p;
+	u64 hdr;
+	uint i;
+	int ret;
+
+	if (!len)
+		return -EINVAL;
+	type = src[0] & 3;
+	format = (src[0] >> 2) & 3;
+
+	if (type == ZSTD_LIT_RAW || type == ZSTD_LIT_RLE) {
+		switch (format) {
+		case 1:
+			hsize = 2;
+			break;
+		case 3:
+			hsize = 3;
+			break;
+		default:
+			hsize = 1;
+			break;
+		}
+		if (hsize > len)
+			return -EINVAL;
+		if (hsize == 1)
+			size = src[0] >> 3;
+		else if (hsize == 2)
+			size = (src[0] >> 4) + (src[1] << 4);
+		else
+			size = (src[0] >> 4) + (src[1] << 4) + (src[2] << 12);
+		if (size > ZSTD_BLOCK_SIZE_MAX)
+			return -EINVAL;
+		*lit_size = size;
+
+		if (type == ZSTD_LIT_RAW) {
+			if (hsize + size > len)
+				return -EINVAL;
+			*litp = src + hsize;
+			return hsize + size;
+		}
+		if (hsize + 1 > len)
+			return -EINVAL;
+		memset(ctx->literals, src[hsize], size);
+		*litp = ctx->literals;
+		return hsize + 1;
+	}
+
+	/* Huffman-coded literals, in one or four streams */
+	hsize = format < 2 ? 3 : format + 2;
+	if (hsize > len)
+		return -EINVAL;
+	hdr = 0;
+	for (i = 0; i < hsize; i++)
+		hdr |= (u64)src[i] << (8 * i);
+	i = format < 2 ? 10 : format == 2 ? 14 : 18;
+	size = (hdr >> 4) & ((1 << i) - 1);
+	csize = (hdr >> (4 + i)) & ((1 << i) - 1);
+	if (size > ZSTD_BLOCK_SIZE_MAX || hsize + csize > len)
+		return -EINVAL;
+
+	p = src + hsize;
+	if (type == ZSTD_LIT_COMPRESSED) {
+		ret = huf_read_table(ctx, p, csize);
+		if (ret < 0)
+			return ret;
+		p += ret;
+		csize -= ret;
+	} else if (!ctx->huf_log) {
+		return -EINVAL;
+	}
+
+	if (!format) {
+		ret = huf_decode_stream(ctx, ctx->literals, size, p, csize);
+	} else {
+		size_t s1, s2, s3;
+
+		if (csize < 6)
+			return -EINVAL;
+		s1 = get_unaligned_le16(p);
+		s2 = get_unaligned_le16(p + 2);
+		s3 = get_unaligned_le16(p + 4);
+		if (6 + s1 + s2 + s3 > csize)
+			return -EINVAL;
+		seg = (size + 3) / 4;
+		if (seg * 3 > size)
+			return -EINVAL;
+		p += 6;
+		ret = huf_decode_stream(ctx, ctx->literals, seg, p, s1);
+		if (!ret)
+			ret = huf_decode_stream(ctx, ctx->literals + seg, seg,
+						p + s1, s2);
+		if (!ret)
+			ret = huf_decode_stream(ctx, ctx->literals + 2 * seg,
+						seg, p + s1 + s2, s3);
+		if (!ret)
+			ret = huf_decode_stream(ctx, ctx->literals + 3 * seg,
+						size - 3 * seg,
+						p + s1 + s2 + s3,
+						csize - 6 - s1 - s2 - s3);
+	}
+	if (ret)
+		return ret;
+	*litp = ctx->literals;
+	*lit_size = size;
+
+	return hsize + ((hdr >> (4 + i)) & ((1 << i) - 1));
+}
+
+/**
+ * zstd_read_seq_table() - set up a sequence decoding table for a block
+ *
+ * @seq:	Table to set up
+ * @mode:	Compression mode from the block (ZSTD_MODE_...)
+ * @src:	Table description, if any
+ * @len:	Bytes available at @src
+ * @def:	Predefined distribution
+ * @def_nsym:	Number of symbols in @def
+ * @def_log:	Accuracy log of @def
+ * @max_sym:	Largest allowed symbol value
+ * @max_log:	Largest allowed accuracy log
+ * @return number of bytes used, or -ve on error
+ */
+static int zstd_read_seq_table(struct zstd_seq_table *seq, uint mode,
+			       const u8 *src, size_t len, const s16 *def,
+			       uint def_nsym, uint def_log, uint max_sym,
+			       uint max_log)
+{
+	s16 norm[FSE_MAX_SYMBOLS];
+	uint nsym, log;
+	int ret;
+
+	switch (mode) {
+	case ZSTD_MODE_PREDEFINED:
+		fse_build(seq->table, def, def_nsym, def_log);
+		seq->log = def_log;
+		seq->valid = true;
+		return 0;
+	case ZSTD_MODE_RLE:
+		if (!len || src[0] > max_sym)
+			return -EINVAL;
+		seq->table[0].symbol = src[0];
+		seq->table[0].nbits = 0;
+		seq->table[0].base = 0;
+		seq->log = 0;
+		seq->valid = true;
+		return 1;
+	case ZSTD_MODE_FSE:
+		ret = fse_read_counts(src, len, norm, &nsym, &log, max_sym,
+				      max_log);
+		if (ret < 0)
+			return ret;
+		if (fse_build(seq->table, norm, nsym, log))
+			return -EINVAL;
+		seq->log = log;
+		seq->valid = true;
+		return ret;
+	default:
+		return seq->valid ? 0 : -EINVAL;
+	}
+}
+
+static void zstd_copy_match(u8 *op, size_t offset, size_t len)
+{
+	const u8 *match = op - offset;
+
+	if (offset >= len) {
+		memcpy(op, match, len);
+		return;
+	}
+	if (offset >= 8) {
+		for (; len >= 8; len -= 8, op += 8, match += 8)
+			memcpy(op, match, 8);
+	}
+	while (len--)
+		*op++ = *match++;
+}
+
+/**
+ * zstd_decode_block() - decode a compressed block
+ *
+ * @ctx:	Decompression context
+ * @src:	Block contents
+ * @len:	Size of the block contents
+ * @ostart:	Start of the output of this frame (limit for offsets)
+ * @opp:	Current output position, updated on exit
+ * @oend:	End of the output buffer
+ * @return 0 if OK, -ENOBUFS if the output buffer is too small, other -ve
+ *	value if the data is corrupt
+ */
+static int zstd_decode_block(struct zstd_ctx *ctx, const u8 *src, size_t len,
+			     u8 *ostart, u8 **opp, u8 *oend)
+{
+	const u8 *end = src + len;
+	const u8 *lit = NULL, *lit_end;
+	size_t lit_size = 0;
+	struct bwd_bits b = { 0 };
+	uint ll_state = 0, of_state = 0, ml_state = 0;
+	u8 *op = *opp;
+	uint nseq, i;
+	uint modes;
+	int ret;
+
+	ret = zstd_decode_literals(ctx, src, len, &lit, &lit_size);
+	if (ret < 0)
+		return ret;
+	src += ret;
+	lit_end = lit + lit_size;
+
+	if (src >= end)
+		return -EINVAL;
+	nseq = *src++;
+	if (nseq >= 128) {
+		if (nseq == 255) {
+			if (end - src < 2)
+				return -EINVAL;
+			nseq = get_unaligned_le16(src) + 0x7f00;
+			src += 2;
+		} else {
+			if (src >= end)
+				return -EINVAL;
+			nseq = ((nseq - 128) << 8) + *src++;
+		}
+	}
+
+	if (nseq) {
+		if (src >= end)
+			return -EINVAL;
+		modes = *src++;
+		if (modes & 3)
+			return -EINVAL;
+
+		ret = zstd_read_seq_table(&ctx->ll, modes >> 6, src, end - src,
+					  ll_default, ARRAY_SIZE(ll_default),
+					  LL_DEFAULT_LOG, LL_MAX_SYMBOL,
+					  LL_MAX_LOG);
+		if (ret < 0)
+			return ret;
+		src += ret;
+		ret = zstd_read_seq_table(&ctx->of, (modes >> 4) & 3, src,
+					  end - src, of_default,
+					  ARRAY_SIZE(of_default),
+					  OF_DEFAULT_LOG, OF_MAX_SYMBOL,
+					  OF_MAX_LOG);
+		if (ret < 0)
+			return ret;
+		src += ret;
+		ret = zstd_read_seq_table(&ctx->ml, (modes >> 2) & 3, src,
+					  end - src, ml_default,
+					  ARRAY_SIZE(ml_default),
+					  ML_DEFAULT_LOG, ML_MAX_SYMBOL,
+					  ML_MAX_LOG);
+		if (ret < 0)
+			return ret;
+		src += ret;
+
+		if (bwd_init(&b, src, end - src))
+			return -EINVAL;
+		ll_state = bwd_read(&b, ctx->ll.log);
+		of_state = bwd_read(&b, ctx->of.log);
+		ml_state = bwd_read(&b, ctx->ml.log);
+		bwd_reload(&b);
+	}
+
+	for (i = 0; i < nseq; i++) {
+		const struct fse_entry *lle = &ctx->ll.table[ll_state];
+		const struct fse_entry *ofe = &ctx->of.table[of_state];
+		const struct fse_entry *mle = &ctx->ml.table[ml_state];
+		size_t ll, ml, offset;
+		u32 of_val;
+
+		of_val = (1U << ofe->symbol) + bwd_read(&b, ofe->symbol);
+		bwd_reload(&b);
+		ml = ml_base[mle->symbol] + bwd_read(&b, ml_bits[mle->symbol]);
+		ll = ll_base[lle->symbol] + bwd_read(&b, ll_bits[lle->symbol]);
+		bwd_reload(&b);
+
+		if (i + 1 < nseq) {
+			ll_state = lle->base + bwd_read(&b, lle->nbits);
+			ml_state = mle->base + bwd_read(&b, mle->nbits);
+			of_state = ofe->base + bwd_read(&b, ofe->nbits);
+			bwd_reload(&b);
+		}
+
+		if (of_val > 3) {
+			offset = of_val - 3;
+			ctx->rep[2] = ctx->rep[1];
+			ctx->rep[1] = ctx->rep[0];
+			ctx->rep[0] = offset;
+		} else {
+			uint idx = of_val - 1 + !ll;
+
+			if (!idx) {
+				offset = ctx->rep[0];
+			} else {
+				offset = idx < 3 ? ctx->rep[idx] :
+					 ctx->rep[0] - 1;
+				if (idx > 1)
+					ctx->rep[2] = ctx->rep[1];
+				ctx->rep[1] = ctx->rep[0];
+				ctx->rep[0] = offset;
+			}
+		}
+
+		if (ll > lit_end - lit)
+			return -EINVAL;
+		if (ll + ml > oend - op)
+			return -ENOBUFS;
+		memcpy(op, lit, ll);
+		op += ll;
+		lit += ll;
+
+		if (!offset || offset > op - ostart)
+			return -EINVAL;
+		zstd_copy_match(op, offset, ml);
+		op += ml;
+	}
+	if (nseq && bwd_left(&b))
+		return -EINVAL;
+
+	/* Remaining literals */
+	if (lit_end - lit > oend - op)
+		return -ENOBUFS;
+	memcpy(op, lit, lit_end - lit);
+	op += lit_end - lit;
+	*opp = op;
+
+	return 0;
+}
+
+#define XXH_PRIME64_1	0x9e3779b185ebca87ULL
+#define XXH_PRIME64_2	0xc2b2ae3d27d4eb4fULL
+#define XXH_PRIME64_3	0x165667b19e3779f9ULL
+#define XXH_PRIME64_4	0x85ebca77c2b2ae63ULL
+#define XXH_PRIME64_5	0x27d4eb2f165667c5ULL
+
+static inline u64 xxh64_rotl(u64 x, uint r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline u64 xxh64_round(u64 acc, u64 input)
+{
+	acc += input * XXH_PRIME64_2;
+	acc = xxh64_rotl(acc, 31);
+
+	return acc * XXH_PRIME64_1;
+}
+
+static inline u64 xxh64_merge(u64 acc, u64 val)
+{
+	acc ^= xxh64_round(0, val);
+
+	return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+/* XXH64 with a seed of 0, used for the frame content checksum */
+static u64 xxh64(const u8 *p, size_t len)
+{
+	const u8 *end = p + len;
+	u64 h;
+
+	if (len >= 32) {
+		u64 v1 = XXH_PRIME64_1 + XXH_PRIME64_2;
+		u64 v2 = XXH_PRIME64_2;
+		u64 v3 = 0;
+		u64 v4 = -XXH_PRIME64_1;
+
+		do {
+			v1 = xxh64_round(v1, get_unaligned_le64(p));
+			v2 = xxh64_round(v2, get_unaligned_le64(p + 8));
+			v3 = xxh64_round(v3, get_unaligned_le64(p + 16));
+			v4 = xxh64_round(v4, get_unaligned_le64(p + 24));
+			p += 32;
+		} while (end - p >= 32);
+
+		h = xxh64_rotl(v1, 1) + xxh64_rotl(v2, 7) +
+		    xxh64_rotl(v3, 12) + xxh64_rotl(v4, 18);
+		h = xxh64_merge(h, v1);
+		h = xxh64_merge(h, v2);
+		h = xxh64_merge(h, v3);
+		h = xxh64_merge(h, v4);
+	} else {
+		h = XXH_PRIME64_5;
+	}
+	h += len;
+
+	for (; end - p >= 8; p += 8) {
+		h ^= xxh64_round(0, get_unaligned_le64(p));
+		h = xxh64_rotl(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+	}
+	if (end - p >= 4) {
+		h ^= (u64)get_unaligned_le32(p) * XXH_PRIME64_1;
+		h = xxh64_rotl(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+		p += 4;
+	}
+	for (; p < end; p++) {
+		h ^= *p * XXH_PRIME64_5;
+		h = xxh64_rotl(h, 11) * XXH_PRIME64_1;
+	}
+
+	h ^= h >> 33;
+	h *= XXH_PRIME64_2;
+	h ^= h >> 29;
+	h *= XXH_PRIME64_3;
+	h ^= h >> 32;
+
+	return h;
+}
+
+/**
+ * zstd_decode_frame() - decode a single Zstandard frame
+ *
+ * @ctx:	Decompression context
+ * @srcp:	Start of the frame, updated to point after it on exit
+ * @in_left:	Bytes available at *@srcp
+ * @opp:	Output position, updated on exit
+ * @oend:	End of the output buffer
+ * @return 0 if OK, -ve on error
+ */
+static int zstd_decode_frame(struct zstd_ctx *ctx, const u8 **srcp,
+			     size_t in_left, u8 **opp, u8 *oend)
+{
+	static const u8 did_size[] = { 0, 1, 2, 4 };
+	static const u8 fcs_size[] = { 0, 2, 4, 8 };
+	const u8 *ip = *srcp;
+	const u8 *iend = ip + in_left;
+	u8 *ostart = *opp;
+	u8 *op = ostart;
+	uint fhd, hsize, i;
+	u64 fcs = 0;
+	bool last;
+	int ret;
+
+	if (in_left < 6)
+		return -EINVAL;
+	fhd = ip[4];
+	if (fhd & 0x08)
+		return -EINVAL;		/* reserved bit */
+
+	hsize = 5 + !(fhd & 0x20) + did_size[fhd & 3];
+	i = fcs_size[fhd >> 6];
+	if (!i && (fhd & 0x20))
+		i = 1;
+	if (hsize + i > in_left)
+		return -EINVAL;
+
+	/* Dictionaries are not supported */
+	if (fhd & 3) {
+		u32 did = 0, j;
+
+		for (j = 0; j < did_size[fhd & 3]; j++)
+			did |= ip[hsize - did_size[fhd & 3] + j] << (8 * j);
+		if (did)
+			return -EPROTONOSUPPORT;
+	}
+
+	if (i) {
+		uint j;
+
+		for (j = 0; j < i; j++)
+			fcs |= (u64)ip[hsize + j] << (8 * j);
+		if (i == 2)
+			fcs += 256;
+		if (fcs > oend - op)
+			return -ENOBUFS;
+	}
+	ip += hsize + i;
+
+	ctx->rep[0] = 1;
+	ctx->rep[1] = 4;
+	ctx->rep[2] = 8;
+	ctx->huf_log = 0;
+	ctx->ll.valid = false;
+	ctx->of.valid = false;
+	ctx->ml.valid = false;
+
+	do {
+		u32 bh;
+		size_t bsize;
+
+		if (iend - ip < 3)
+			return -EINVAL;
+		bh = ip[0] | ip[1] << 8 | ip[2] << 16;
+		ip += 3;
+		last = bh & 1;
+		bsize = bh >> 3;
+
+		switch ((bh >> 1) & 3) {
+		case ZSTD_BLOCK_RAW:
+			if (bsize > iend - ip)
+				return -EINVAL;
+			if (bsize > oend - op)
+				return -ENOBUFS;
+			memcpy(op, ip, bsize);
+			ip += bsize;
+			op += bsize;
+			break;
+		case ZSTD_BLOCK_RLE:
+			if (ip >= iend)
+				return -EINVAL;
+			if (bsize > oend - op)
+				return -ENOBUFS;
+			memset(op, *ip++, bsize);
+			op += bsize;
+			break;
+		case ZSTD_BLOCK_COMPRESSED:
+			if (bsize > iend - ip || bsize > ZSTD_BLOCK_SIZE_MAX)
+				return -EINVAL;
+			ret = zstd_decode_block(ctx, ip, bsize, ostart, &op,
+						oend);
+			*opp = op;
+			if (ret)
+				return ret;
+			ip += bsize;
+			break;
+		default:
+			return -EINVAL;
+		}
+		*opp = op;
+	} while (!last);
+
+	if (i && fcs != op - ostart)
+		return -EINVAL;
+
+	if (fhd & 0x04) {
+		if (iend - ip < 4)
+			return -EINVAL;
+		if ((u32)xxh64(ostart, op - ostart) != get_unaligned_le32(ip))
+			return -EIO;
+		ip += 4;
+	}
+	*srcp = ip;
+
+	return 0;
+}
+
+int zstd_decompress(const void *src, size_t srcn, void *dst, size_t *dstn)
+{
+	const u8 *ip = src;
+	u8 *op = dst;
+	u8 *oend;
+	struct zstd_ctx *ctx;
+	bool found = false;
+	int ret = 0;
+
+	/* Callers may pass ~0 for 'unknown', so avoid wrapping around */
+	oend = op + min(*dstn, (size_t)(~(uintptr_t)0 - (uintptr_t)op));
+	srcn = min(srcn, (size_t)(~(uintptr_t)0 - (uintptr_t)ip));
+
+	ctx = malloc(sizeof(*ctx));
+	if (!ctx)
+		return -ENOMEM;
+	ctx->ll.table = ctx->ll_fse;
+	ctx->of.table = ctx->of_fse;
+	ctx->ml.table = ctx->ml_fse;
+
+	while (srcn - (ip - (const u8 *)src) >= 4) {
+		size_t in_left = srcn - (ip - (const u8 *)src);
+		u32 magic = get_unaligned_le32(ip);
+
+		if ((magic & ZSTD_SKIPPABLE_MASK) == ZSTD_SKIPPABLE_MAGIC) {
+			size_t size;
+
+			if (in_left < 8)
+				break;
+			size = get_unaligned_le32(ip + 4);
+			if (size > in_left - 8) {
+				ret = -EINVAL;
+				break;
+			}
+			ip += 8 + size;
+			continue;
+		}
+
+		/* Anything following the last frame is ignored, like gunzip */
+		if (magic != ZSTD_MAGIC) {
+			if (!found)
+				ret = -EPROTONOSUPPORT;
+			break;
+		}
+
+		ret = zstd_decode_frame(ctx, &ip, in_left, &op, oend);
+		if (ret)
+			break;
+		found = true;
+	}
+	if (!ret && !found)
+		ret = -EINVAL;
+
+	free(ctx);
+	*dstn = op - (u8 *)dst;
+
+	return ret;
+}
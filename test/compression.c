@@ -6,9 +6,11 @@
 #include <common.h>
 #include <bootm.h>
 #include <command.h>
+#include <errno.h>
 #include <malloc.h>
 #include <mapmem.h>
 #include <asm/io.h>
+#include <asm/unaligned.h>
 
 #include <u-boot/zlib.h>
 #include <bzlib.h>
@@ -117,6 +119,87 @@ static const char lz4_compressed[] =
 	"\x9d\x12\x8c\x9d";
 static const unsigned long lz4_compressed_size = 276;
 
+/* zstd -19 /tmp/plain.txt -o /tmp/plain.zst */
+static const char zstd_compressed[] =
+	"\x28\xb5\x2f\xfd\x64\x5e\x00\xad\x05\x00\x42\x4e\x26\x17\x90\x3b"
+	"\x07\x04\x5a\x13\x8b\xa7\x65\x34\x12\x21\x6d\xb0\x39\xbb\xae\xe8"
+	"\xba\xc9\xcd\x5e\x02\x49\xd0\x2b\xa9\xfa\x96\x92\xe7\x1f\x19\x19"
+	"\x7c\x8f\xf1\x9d\x54\x37\xfc\xd6\x0a\xf3\x0c\x93\x56\xc7\x52\x4f"
+	"\x0a\x62\x3e\xd1\xa5\x83\x17\x31\xab\x5d\x8f\x57\xf3\xcc\x3b\x58"
+	"\xf8\x91\x8c\xf1\x2a\x5c\x89\xdd\xf2\x9b\x15\xb7\x92\x5b\xbe\xba"
+	"\xab\xd5\xd1\x34\xdf\xf0\x02\x0e\x61\xcd\x7b\xd6\x01\xfc\xc2\xa7"
+	"\xd4\xd1\x3d\x26\x9c\x10\x49\xb8\x5b\xcd\xba\x7c\xf7\xac\x4b\xad"
+	"\xb7\x31\x1c\xbc\xf9\xcb\x62\x8e\x2e\x9b\x0f\xd3\x87\x57\x45\x12"
+	"\x16\xfa\x3a\x79\xde\x65\xf8\xcc\x48\xd5\x43\xa6\xbd\xc3\x91\x29"
+	"\x65\x29\xa7\x5b\x9a\x08\x08\x00\x60\x13\x00\x63\xa3\x8e\x28\x94"
+	"\x79\x41\x2a\x78\xc2\x91\x70\x9f\xaa\x6a\x21\x7a\xa1\xaa\x0c\xe4"
+	"\xf4\x6e\xfa";
+static const unsigned long zstd_compressed_size = 195;
+
+/*
+ * plain repeated up to 4KiB, in four compressed blocks:
+ * zstd -19 --zstd=wlog=10 /tmp/multi.txt -o /tmp/multi.zst
+ */
+static const char zstd_multi[] =
+	"\x28\xb5\x2f\xfd\x44\x00\x00\x0f\xcc\x05\x00\x42\x4e\x26\x17\x90"
+	"\x3b\x07\x04\x5a\x13\x8b\xa7\x65\x34\x12\x21\x6d\xb0\x39\xbb\xae"
+	"\xe8\xba\xc9\xcd\x5e\x02\x49\xd0\x2b\xa9\xfa\x96\x92\xe7\x1f\x19"
+	"\x19\x7c\x8f\xf1\x9d\x54\x37\xfc\xd6\x0a\xf3\x0c\x93\x56\xc7\x52"
+	"\x4f\x0a\x62\x3e\xd1\xa5\x83\x17\x31\xab\x5d\x8f\x57\xf3\xcc\x3b"
+	"\x58\xf8\x91\x8c\xf1\x2a\x5c\x89\xdd\xf2\x9b\x15\xb7\x92\x5b\xbe"
+	"\xba\xab\xd5\xd1\x34\xdf\xf0\x02\x0e\x61\xcd\x7b\xd6\x01\xfc\xc2"
+	"\xa7\xd4\xd1\x3d\x26\x9c\x10\x49\xb8\x5b\xcd\xba\x7c\xf7\xac\x4b"
+	"\xad\xb7\x31\x1c\xbc\xf9\xcb\x62\x8e\x2e\x9b\x0f\xd3\x87\x57\x45"
+	"\x12\x16\xfa\x3a\x79\xde\x65\xf8\xcc\x48\xd5\x43\xa6\xbd\xc3\x91"
+	"\x29\x65\x29\xa7\x5b\x9a\x08\x09\x00\x9f\xc2\xb6\x1c\x6c\x2d\x60"
+	"\x0c\xd7\x11\x85\x32\x2f\x48\x05\x4f\x38\x12\xee\x53\x55\x2d\x44"
+	"\x2f\x54\x95\x01\x44\x00\x00\x00\x01\x00\xfd\xc3\xaa\x05\x04\x3c"
+	"\x00\x00\x00\x01\x00\xfd\x2b\x00\x04\x3d\x00\x00\x00\x01\x00\xfd"
+	"\x2b\x00\x04\xfa\x3a\xa1\x30";
+static const unsigned long zstd_multi_size = 231;
+#define ZSTD_MULTI_LEN	4096
+
+/*
+ * Put together by hand: the compressed block from plain.zst, followed by a
+ * raw block holding ZSTD_RAW_TEXT and an RLE block of ZSTD_RLE_LEN 'z's,
+ * with the content size and checksum filled in
+ */
+static const char zstd_blocks[] =
+	"\x28\xb5\x2f\xfd\x64\xd2\x00\xac\x05\x00\x42\x4e\x26\x17\x90\x3b"
+	"\x07\x04\x5a\x13\x8b\xa7\x65\x34\x12\x21\x6d\xb0\x39\xbb\xae\xe8"
+	"\xba\xc9\xcd\x5e\x02\x49\xd0\x2b\xa9\xfa\x96\x92\xe7\x1f\x19\x19"
+	"\x7c\x8f\xf1\x9d\x54\x37\xfc\xd6\x0a\xf3\x0c\x93\x56\xc7\x52\x4f"
+	"\x0a\x62\x3e\xd1\xa5\x83\x17\x31\xab\x5d\x8f\x57\xf3\xcc\x3b\x58"
+	"\xf8\x91\x8c\xf1\x2a\x5c\x89\xdd\xf2\x9b\x15\xb7\x92\x5b\xbe\xba"
+	"\xab\xd5\xd1\x34\xdf\xf0\x02\x0e\x61\xcd\x7b\xd6\x01\xfc\xc2\xa7"
+	"\xd4\xd1\x3d\x26\x9c\x10\x49\xb8\x5b\xcd\xba\x7c\xf7\xac\x4b\xad"
+	"\xb7\x31\x1c\xbc\xf9\xcb\x62\x8e\x2e\x9b\x0f\xd3\x87\x57\x45\x12"
+	"\x16\xfa\x3a\x79\xde\x65\xf8\xcc\x48\xd5\x43\xa6\xbd\xc3\x91\x29"
+	"\x65\x29\xa7\x5b\x9a\x08\x08\x00\x60\x13\x00\x63\xa3\x8e\x28\x94"
+	"\x79\x41\x2a\x78\xc2\x91\x70\x9f\xaa\x6a\x21\x7a\xa1\xaa\x0c\x80"
+	"\x00\x00\x72\x61\x77\x20\x62\x6c\x6f\x63\x6b\x20\x64\x61\x74\x61"
+	"\x2e\x0a\x23\x03\x00\x7a\x96\x01\xaf\x51";
+static const unsigned long zstd_blocks_size = 218;
+#define ZSTD_RAW_TEXT	"raw block data.\n"
+#define ZSTD_RLE_LEN	100
+
+/* zstd -19 --no-content-size /tmp/plain.txt -o /tmp/nocs.zst */
+static const char zstd_nocs[] =
+	"\x28\xb5\x2f\xfd\x04\x00\xad\x05\x00\x42\x4e\x26\x17\x90\x3b\x07"
+	"\x04\x5a\x13\x8b\xa7\x65\x34\x12\x21\x6d\xb0\x39\xbb\xae\xe8\xba"
+	"\xc9\xcd\x5e\x02\x49\xd0\x2b\xa9\xfa\x96\x92\xe7\x1f\x19\x19\x7c"
+	"\x8f\xf1\x9d\x54\x37\xfc\xd6\x0a\xf3\x0c\x93\x56\xc7\x52\x4f\x0a"
+	"\x62\x3e\xd1\xa5\x83\x17\x31\xab\x5d\x8f\x57\xf3\xcc\x3b\x58\xf8"
+	"\x91\x8c\xf1\x2a\x5c\x89\xdd\xf2\x9b\x15\xb7\x92\x5b\xbe\xba\xab"
+	"\xd5\xd1\x34\xdf\xf0\x02\x0e\x61\xcd\x7b\xd6\x01\xfc\xc2\xa7\xd4"
+	"\xd1\x3d\x26\x9c\x10\x49\xb8\x5b\xcd\xba\x7c\xf7\xac\x4b\xad\xb7"
+	"\x31\x1c\xbc\xf9\xcb\x62\x8e\x2e\x9b\x0f\xd3\x87\x57\x45\x12\x16"
+	"\xfa\x3a\x79\xde\x65\xf8\xcc\x48\xd5\x43\xa6\xbd\xc3\x91\x29\x65"
+	"\x29\xa7\x5b\x9a\x08\x08\x00\x60\x13\x00\x63\xa3\x8e\x28\x94\x79"
+	"\x41\x2a\x78\xc2\x91\x70\x9f\xaa\x6a\x21\x7a\xa1\xaa\x0c\xe4\xf4"
+	"\x6e\xfa";
+static const unsigned long zstd_nocs_size = 194;
+
 
 #define TEST_BUFFER_SIZE	512
 
@@ -292,6 +375,40 @@ static int uncompress_using_lz4(struct unit_test_state *uts,
 	return (ret != 0);
 }
 
+static int compress_using_zstd(struct unit_test_state *uts,
+			       void *in, unsigned long in_size,
+			       void *out, unsigned long out_max,
+			       unsigned long *out_size)
+{
+	/* There is no zstd compression in u-boot, so fake it. */
+	ut_asserteq(in_size,  strlen(plain));
+	ut_asserteq(0, memcmp(plain, in, in_size));
+
+	if (zstd_compressed_size > out_max)
+		return -1;
+
+	memcpy(out, zstd_compressed, zstd_compressed_size);
+	if (out_size)
+		*out_size = zstd_compressed_size;
+
+	return 0;
+}
+
+static int uncompress_using_zstd(struct unit_test_state *uts,
+				 void *in, unsigned long in_size,
+				 void *out, unsigned long out_max,
+				 unsigned long *out_size)
+{
+	int ret;
+	size_t output_size = out_max;
+
+	ret = zstd_decompress(in, in_size, out, &output_size);
+	if (out_size)
+		*out_size = output_size;
+
+	return (ret != 0);
+}
+
 #define errcheck(statement) if (!(statement)) { \
 	fprintf(stderr, "\tFailed: %s\n", #statement); \
 	ret = 1; \
@@ -436,6 +553,105 @@ static int compression_test_lz4(struct unit_test_state *uts)
 }
 COMPRESSION_TEST(compression_test_lz4, 0);
 
+static int compression_test_zstd(struct unit_test_state *uts)
+{
+	return run_test(uts, "zstd", compress_using_zstd,
+			uncompress_using_zstd);
+}
+COMPRESSION_TEST(compression_test_zstd, 0);
+
+/* Decompress @comp and check that it gives exactly @expect */
+static int check_zstd(struct unit_test_state *uts, const char *comp,
+		      ulong comp_size, const char *expect, ulong expect_size)
+{
+	size_t out_size = expect_size;
+	char *out;
+
+	out = malloc(expect_size + 1);
+	ut_assertnonnull(out);
+	memset(out, 'A', expect_size + 1);
+	ut_assertok(zstd_decompress(comp, comp_size, out, &out_size));
+	ut_asserteq(expect_size, out_size);
+	ut_assertok(memcmp(expect, out, expect_size));
+	ut_asserteq('A', out[expect_size]);
+	free(out);
+
+	return 0;
+}
+
+/* Frames with several blocks, raw and RLE blocks and no content size */
+static int compression_test_zstd_frames(struct unit_test_state *uts)
+{
+	ulong plain_size = strlen(plain);
+	ulong raw_size = strlen(ZSTD_RAW_TEXT);
+	char *expect;
+	int i;
+
+	expect = malloc(ZSTD_MULTI_LEN);
+	ut_assertnonnull(expect);
+
+	for (i = 0; i < ZSTD_MULTI_LEN; i++)
+		expect[i] = plain[i % plain_size];
+	ut_assertok(check_zstd(uts, zstd_multi, zstd_multi_size, expect,
+			       ZSTD_MULTI_LEN));
+
+	memcpy(expect, plain, plain_size);
+	memcpy(expect + plain_size, ZSTD_RAW_TEXT, raw_size);
+	memset(expect + plain_size + raw_size, 'z', ZSTD_RLE_LEN);
+	ut_assertok(check_zstd(uts, zstd_blocks, zstd_blocks_size, expect,
+			       plain_size + raw_size + ZSTD_RLE_LEN));
+
+	ut_assertok(check_zstd(uts, zstd_nocs, zstd_nocs_size, plain,
+			       plain_size));
+	free(expect);
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_zstd_frames, 0);
+
+/* Truncated or corrupted input must be rejected */
+static int compression_test_zstd_bad(struct unit_test_state *uts)
+{
+	size_t out_size;
+	char *in, *out;
+	int i;
+
+	in = malloc(zstd_compressed_size);
+	ut_assertnonnull(in);
+	out = malloc(TEST_BUFFER_SIZE);
+	ut_assertnonnull(out);
+	memcpy(in, zstd_compressed, zstd_compressed_size);
+
+	for (i = 0; i < zstd_compressed_size; i++) {
+		out_size = TEST_BUFFER_SIZE;
+		ut_assert(zstd_decompress(in, i, out, &out_size) != 0);
+	}
+
+	/*
+	 * Any byte inverted, in the header, the block or the checksum. Not
+	 * single bits: the header has an unused one, and the reference
+	 * decoder also ignores a few in this block.
+	 */
+	for (i = 0; i < zstd_compressed_size; i++) {
+		in[i] = ~in[i];
+		out_size = TEST_BUFFER_SIZE;
+		ut_assert(zstd_decompress(in, zstd_compressed_size, out,
+					  &out_size) != 0);
+		in[i] = ~in[i];
+	}
+
+	/* The checksum itself */
+	in[zstd_compressed_size - 1] ^= 1;
+	out_size = TEST_BUFFER_SIZE;
+	ut_asserteq(-EIO, zstd_decompress(in, zstd_compressed_size, out,
+					  &out_size));
+	free(out);
+	free(in);
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_zstd_bad, 0);
+
 static int compress_using_none(struct unit_test_state *uts,
 			       void *in, unsigned long in_size,
 			       void *out, unsigned long out_max,
@@ -526,12 +742,266 @@ static int compression_test_bootm_lz4(struct unit_test_state *uts)
 }
 COMPRESSION_TEST(compression_test_bootm_lz4, 0);
 
+static int compression_test_bootm_zstd(struct unit_test_state *uts)
+{
+	return run_bootm_test(uts, IH_COMP_ZSTD, compress_using_zstd);
+}
+COMPRESSION_TEST(compression_test_bootm_zstd, 0);
+
 static int compression_test_bootm_none(struct unit_test_state *uts)
 {
 	return run_bootm_test(uts, IH_COMP_NONE, compress_using_none);
 }
 COMPRESSION_TEST(compression_test_bootm_none, 0);
 
+/**
+ * run_bootm_inplace_test() - Test decompression over the compressed data
+ *
+ * @comp_type:	Compression type to test
+ * @compress:	Our function to compress data
+ * @return 0 if OK, non-zero on failure
+ */
+static int run_bootm_inplace_test(struct unit_test_state *uts, int comp_type,
+				  mutate_func compress)
+{
+	const ulong load_addr = 0x1000;
+	const ulong area_end = load_addr + 0x12000;
+	ulong compress_size = 1024;
+	ulong image_start, load_end;
+	void *compress_buff;
+	int unc_len;
+
+	printf("Testing in-place: %s\n", genimg_get_comp_name(comp_type));
+	compress_buff = malloc(compress_size);
+	ut_assertnonnull(compress_buff);
+	unc_len = strlen(plain);
+	compress(uts, (void *)plain, unc_len, compress_buff, compress_size,
+		 &compress_size);
+
+	/*
+	 * Our LZMA stream was written without its size, which leaves nothing
+	 * to check the overlap against, so fill it in as lzma_alone does for
+	 * a regular file
+	 */
+	if (comp_type == IH_COMP_LZMA)
+		put_unaligned_le64(unc_len, compress_buff + 5);
+
+	/* Compressed data at the end of the area, with enough margin */
+	image_start = area_end - compress_size;
+	memcpy(map_sysmem(image_start, compress_size), compress_buff,
+	       compress_size);
+	ut_assertok(bootm_decomp_image(comp_type, load_addr, image_start,
+				       IH_TYPE_KERNEL,
+				       map_sysmem(load_addr, 0),
+				       map_sysmem(image_start, 0),
+				       compress_size, area_end - load_addr,
+				       &load_end));
+	ut_asserteq(load_addr + unc_len, load_end);
+	ut_assertok(memcmp(plain, map_sysmem(load_addr, 0), unc_len));
+
+	/* Overlapping with too little margin must be refused */
+	image_start = load_addr + 0x10;
+	memcpy(map_sysmem(image_start, compress_size), compress_buff,
+	       compress_size);
+	ut_asserteq(BOOTM_ERR_OVERLAP,
+		    bootm_decomp_image(comp_type, load_addr, image_start,
+				       IH_TYPE_KERNEL,
+				       map_sysmem(load_addr, 0),
+				       map_sysmem(image_start, 0),
+				       compress_size, area_end - load_addr,
+				       &load_end));
+	free(compress_buff);
+
+	return 0;
+}
+
+static int compression_test_bootm_inplace_gzip(struct unit_test_state *uts)
+{
+	return run_bootm_inplace_test(uts, IH_COMP_GZIP, compress_using_gzip);
+}
+COMPRESSION_TEST(compression_test_bootm_inplace_gzip, 0);
+
+static int compression_test_bootm_inplace_lz4(struct unit_test_state *uts)
+{
+	return run_bootm_inplace_test(uts, IH_COMP_LZ4, compress_using_lz4);
+}
+COMPRESSION_TEST(compression_test_bootm_inplace_lz4, 0);
+
+static int compression_test_bootm_inplace_lzma(struct unit_test_state *uts)
+{
+	return run_bootm_inplace_test(uts, IH_COMP_LZMA, compress_using_lzma);
+}
+COMPRESSION_TEST(compression_test_bootm_inplace_lzma, 0);
+
+static int compression_test_bootm_inplace_zstd(struct unit_test_state *uts)
+{
+	return run_bootm_inplace_test(uts, IH_COMP_ZSTD, compress_using_zstd);
+}
+COMPRESSION_TEST(compression_test_bootm_inplace_zstd, 0);
+
+/* Size of the generated data used to test and time the inflate fast path */
+#define INFLATE_TEST_SIZE	(1 << 20)
+
+/**
+ * fill_inflate_test() - Generate data to exercise all inflate code paths
+ *
+ * The buffer gets pseudo-random words (literals with short and long
+ * matches), runs of one and two repeated bytes (overlapping matches with
+ * small distances) and a block of random bytes (stored blocks).
+ *
+ * @buf:	Buffer to fill
+ * @size:	Size of buffer in bytes
+ */
+static void fill_inflate_test(u8 *buf, ulong size)
+{
+	static const char *const words[] = {
+		"u-boot ", "kernel ", "ramdisk ", "device ", "tree ", "image ",
+		"compressed ", "the ", "a ", "of ", "\n", "0x1f8b ", "inflate ",
+	};
+	u32 seed = 0x12345678;
+	ulong pos = 0;
+
+	while (pos < size) {
+		ulong len, i;
+
+		seed = seed * 1103515245 + 12345;
+		if (pos > size - size / 8) {
+			buf[pos++] = seed >> 16;
+			continue;
+		}
+		switch ((seed >> 16) % 16) {
+		case 0:
+			len = min(size - pos, (ulong)(seed >> 24) + 3);
+			memset(buf + pos, seed >> 8, len);
+			break;
+		case 1:
+			len = min(size - pos, (ulong)(seed >> 23) + 4);
+			for (i = 0; i < len; i++)
+				buf[pos + i] = i & 1 ? 'b' : 'a';
+			break;
+		default: {
+			const char *word = words[(seed >> 20) %
+						 ARRAY_SIZE(words)];
+
+			len = min(size - pos, (ulong)strlen(word));
+			memcpy(buf + pos, word, len);
+			break;
+		}
+		}
+		pos += len;
+	}
+}
+
+static int compression_test_gzip_inflate(struct unit_test_state *uts)
+{
+	ulong comp_size = INFLATE_TEST_SIZE + INFLATE_TEST_SIZE / 8;
+	ulong unc_size, start, us;
+	u8 *orig, *comp, *unc;
+
+	orig = malloc(INFLATE_TEST_SIZE);
+	ut_assertnonnull(orig);
+	comp = malloc(comp_size);
+	ut_assertnonnull(comp);
+	unc = malloc(INFLATE_TEST_SIZE + 1);
+	ut_assertnonnull(unc);
+
+	fill_inflate_test(orig, INFLATE_TEST_SIZE);
+	ut_assertok(gzip(comp, &comp_size, orig, INFLATE_TEST_SIZE));
+
+	/* The output must be identical to the original, and nothing more */
+	memset(unc, 'A', INFLATE_TEST_SIZE + 1);
+	start = timer_get_us();
+	ut_assertok(gunzip(unc, INFLATE_TEST_SIZE, comp, &comp_size));
+	us = max(timer_get_us() - start, 1UL);
+	unc_size = comp_size;
+	ut_asserteq(INFLATE_TEST_SIZE, unc_size);
+	ut_assertok(memcmp(orig, unc, INFLATE_TEST_SIZE));
+	ut_asserteq('A', unc[INFLATE_TEST_SIZE]);
+
+	printf("inflate (%s): %lu bytes in %lu us, %lu MB/s\n",
+	       IS_ENABLED(CONFIG_ZLIB_INFFAST_WIDE) ? "wide" : "byte",
+	       unc_size, us, unc_size / us);
+	free(unc);
+	free(comp);
+	free(orig);
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_gzip_inflate, 0);
+
+/* Amount of output each codec produces in the benchmark */
+#define BENCH_SIZE	(1 << 20)
+
+/**
+ * run_bench() - Measure decompression throughput and compression ratio
+ *
+ * The test text is compressed once and then decompressed repeatedly, until
+ * at least BENCH_SIZE bytes have been produced.
+ * Throughput is given in MB/s of uncompressed output, the ratio as the
+ * compressed size relative to the original.
+ *
+ * @name:	Name of the codec
+ * @compress:	Our function to compress data
+ * @uncompress:	Our function to uncompress data
+ * @return 0 if OK, non-zero on failure
+ */
+static int run_bench(struct unit_test_state *uts, const char *name,
+		     mutate_func compress, mutate_func uncompress)
+{
+	ulong orig_size = strlen(plain);
+	ulong loops = DIV_ROUND_UP(BENCH_SIZE, orig_size);
+	ulong comp_size = TEST_BUFFER_SIZE;
+	ulong unc_size, start, us;
+	void *comp_buf, *unc_buf;
+	int i;
+
+	comp_buf = malloc(TEST_BUFFER_SIZE);
+	ut_assertnonnull(comp_buf);
+	unc_buf = malloc(TEST_BUFFER_SIZE);
+	ut_assertnonnull(unc_buf);
+	ut_assertok(compress(uts, (void *)plain, orig_size, comp_buf,
+			     comp_size, &comp_size));
+
+	start = timer_get_us();
+	for (i = 0; i < loops; i++) {
+		unc_size = TEST_BUFFER_SIZE;
+		ut_assertok(uncompress(uts, comp_buf, comp_size, unc_buf,
+				       unc_size, &unc_size));
+	}
+	us = timer_get_us() - start;
+	ut_asserteq(orig_size, unc_size);
+	ut_assertok(memcmp(plain, unc_buf, orig_size));
+
+	/* Bytes per microsecond is MB/s; keep one decimal place */
+	us = max(us, 1UL);
+	printf("%-6s %4lu -> %4lu bytes (%3lu%%), %6lu.%lu MB/s\n", name,
+	       orig_size, comp_size, comp_size * 100 / orig_size,
+	       orig_size * loops / us, orig_size * loops * 10 / us % 10);
+	free(unc_buf);
+	free(comp_buf);
+
+	return 0;
+}
+
+static int compression_test_bench(struct unit_test_state *uts)
+{
+	ut_assertok(run_bench(uts, "gzip", compress_using_gzip,
+			      uncompress_using_gzip));
+	ut_assertok(run_bench(uts, "bzip2", compress_using_bzip2,
+			      uncompress_using_bzip2));
+	ut_assertok(run_bench(uts, "lzma", compress_using_lzma,
+			      uncompress_using_lzma));
+	ut_assertok(run_bench(uts, "lzo", compress_using_lzo,
+			      uncompress_using_lzo));
+	ut_assertok(run_bench(uts, "lz4", compress_using_lz4,
+			      uncompress_using_lz4));
+	ut_assertok(run_bench(uts, "zstd", compress_using_zstd,
+			      uncompress_using_zstd));
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_bench, 0);
+
 int do_ut_compression(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 {
 	struct unit_test *tests = ll_entry_start(struct unit_test,
@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for timing device probes with bootstage
+ */
+
+#include <common.h>
+#include <bootstage.h>
+#include <console.h>
+#include <dm.h>
+#include <malloc.h>
+#include <membuff.h>
+#include <timer.h>
+#include <dm/test.h>
+#include <dm/uclass-internal.h>
+#include <dm/util.h>
+#include <test/ut.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Get the accumulated time of a record, 0 if it is not exported */
+static int get_accum(struct unit_test_state *uts, const char *name,
+		     uint *timep)
+{
+	char *buf, *ptr, key[40];
+	int len;
+
+	len = bootstage_export_json(NULL, 0);
+	buf = malloc(len + 1);
+	ut_assertnonnull(buf);
+	bootstage_export_json(buf, len + 1);
+	snprintf(key, sizeof(key), "\"name\":\"%s\",\"accum\":", name);
+	ptr = strstr(buf, key);
+	*timep = ptr ? simple_strtoul(ptr + strlen(key), NULL, 10) : 0;
+	free(buf);
+
+	return 0;
+}
+
+/* Check that the 'dm tree' line for @dev shows @time (or nothing if NULL) */
+static int check_dump(struct unit_test_state *uts, struct udevice *dev,
+		      const uint *time)
+{
+	char line[120], expect[60];
+	int len;
+
+	if (time)
+		snprintf(expect, sizeof(expect), "[ + ]   %8u  %-20.20s",
+			 *time, dev->driver->name);
+	else
+		snprintf(expect, sizeof(expect), "[   ]   %8s  %-20.20s", "",
+			 dev->driver->name);
+
+	console_record_reset_enable();
+	dm_dump_all();
+	gd->flags &= ~GD_FLG_RECORD;
+	while (membuff_readline(&gd->console_out, line, sizeof(line), ' ') > 0) {
+		len = strlen(line) - strlen(dev->name);
+		if (len >= 4 && !strcmp(line + len, dev->name) &&
+		    !strncmp(line + len - 3, "-- ", 3)) {
+			ut_assertnonnull(strstr(line, expect));
+			return 0;
+		}
+	}
+	ut_failf(uts, __FILE__, __LINE__, __func__, "dm tree",
+		 "No line for '%s'", dev->name);
+
+	return CMD_RET_FAILURE;
+}
+
+/* Test that device_probe() times each probe once the timer is ready */
+static int dm_test_bootstage_probe(struct unit_test_state *uts)
+{
+	struct udevice *early, *dev, *idle, *timer;
+	uint before, after;
+
+	ut_assertok(get_accum(uts, "testfdt_drv", &before));
+
+	/* Nothing is timed before there is a timer */
+	gd->timer = NULL;
+	ut_assertok(uclass_get_device(UCLASS_TEST_FDT, 0, &early));
+	ut_asserteq(0, early->probe_time_us);
+	ut_assertok(get_accum(uts, "testfdt_drv", &after));
+	ut_asserteq(before, after);
+
+	/* The timer itself is never timed */
+	ut_assertok(dm_timer_init());
+	timer = gd->timer;
+	ut_assertnonnull(timer);
+	ut_asserteq(UCLASS_TIMER, device_get_uclass_id(timer));
+	ut_asserteq(0, timer->probe_time_us);
+
+	/* Later probes are added to the driver's record */
+	ut_assertok(uclass_get_device(UCLASS_TEST_FDT, 1, &dev));
+	ut_assertok(get_accum(uts, "testfdt_drv", &after));
+	ut_asserteq(before + dev->probe_time_us, after);
+
+	/* 'dm tree' shows the time for each probed device */
+	ut_assertok(uclass_find_device(UCLASS_TEST_FDT, 2, &idle));
+	ut_assert(!(idle->flags & DM_FLAG_ACTIVATED));
+	ut_assertok(check_dump(uts, dev, &dev->probe_time_us));
+	ut_assertok(check_dump(uts, early, &early->probe_time_us));
+	ut_assertok(check_dump(uts, idle, NULL));
+
+	/* Don't leave the timer pointing into this test's devices */
+	gd->timer = NULL;
+
+	return 0;
+}
+DM_TEST(dm_test_bootstage_probe, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
@@ -905,3 +905,109 @@ static int dm_test_inactive_child(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_inactive_child, DM_TESTF_SCAN_PDATA);
+
+/* Test looking up devices in a large uclass */
+#define INDEX_DEV_COUNT	300
+
+/*
+ * Check that each of @count devices in UCLASS_TEST is found by position,
+ * sequence number and name, returning the time taken by the lookups in @usp
+ */
+static int check_uclass_lookups(struct unit_test_state *uts,
+				struct udevice *devs[], int count, ulong *usp)
+{
+	struct udevice *dev;
+	ulong start;
+	int i;
+
+	start = timer_get_us();
+	for (i = 0; i < count; i++) {
+		ut_assertok(uclass_find_device(UCLASS_TEST, i, &dev));
+		ut_asserteq_ptr(devs[i], dev);
+		ut_assertok(uclass_find_device_by_seq(UCLASS_TEST,
+						      devs[i]->seq, false,
+						      &dev));
+		ut_asserteq_ptr(devs[i], dev);
+		ut_assertok(uclass_find_device_by_name(UCLASS_TEST,
+						       devs[i]->name, &dev));
+		ut_asserteq_ptr(devs[i], dev);
+	}
+	*usp = timer_get_us() - start;
+
+	/* A name matching more than one device gives the first */
+	ut_assertok(uclass_find_device_by_name(UCLASS_TEST, "index", &dev));
+	ut_asserteq_ptr(devs[0], dev);
+	ut_asserteq(-ENODEV, uclass_find_device_by_name(UCLASS_TEST, "none",
+							&dev));
+	ut_asserteq(-ENODEV, uclass_find_device(UCLASS_TEST, count, &dev));
+
+	return 0;
+}
+
+/* Check that the lookups give the same devices with and without the index */
+static int check_uclass_index(struct unit_test_state *uts,
+			      struct udevice *devs[], int count)
+{
+	ulong indexed_us;
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	struct uclass_index *index;
+	struct uclass *uc;
+	ulong walk_us;
+	int ret;
+#endif
+
+	ut_assertok(check_uclass_lookups(uts, devs, count, &indexed_us));
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	ut_assertok(uclass_get(UCLASS_TEST, &uc));
+	ut_assertnonnull(uc->index);
+
+	/* Hide the index so that the lookups walk the list of devices */
+	index = uc->index;
+	uc->index = NULL;
+	ret = check_uclass_lookups(uts, devs, count, &walk_us);
+	uc->index = index;
+	ut_assertok(ret);
+	printf("%d devices: %lu us for lookups, %lu us without the index\n",
+	       count, indexed_us, walk_us);
+#endif
+
+	return 0;
+}
+
+static int dm_test_uclass_index(struct unit_test_state *uts)
+{
+	struct dm_test_state *dms = uts->priv;
+	struct udevice *devs[INDEX_DEV_COUNT], *dev;
+	char name[20];
+	int i;
+
+	dms->skip_post_probe = 1;
+	for (i = 0; i < INDEX_DEV_COUNT; i++) {
+		ut_assertok(device_bind_by_name(dms->root, false,
+						&driver_info_manual, &devs[i]));
+		snprintf(name, sizeof(name), "index%03d", i);
+		ut_assertok(device_set_name(devs[i], name));
+		ut_assertok(device_probe(devs[i]));
+	}
+	ut_assertok(check_uclass_index(uts, devs, INDEX_DEV_COUNT));
+
+	/* Removed and unbound devices must not be found */
+	i = devs[1]->seq;
+	ut_assertok(device_remove(devs[1], DM_REMOVE_NORMAL));
+	ut_asserteq(-ENODEV, uclass_find_device_by_seq(UCLASS_TEST, i, false,
+						       &dev));
+	ut_assertok(device_unbind(devs[1]));
+	ut_asserteq(-ENODEV, uclass_find_device_by_name(UCLASS_TEST,
+							"index001", &dev));
+	memmove(&devs[1], &devs[2], (INDEX_DEV_COUNT - 2) * sizeof(*devs));
+	ut_assertok(check_uclass_index(uts, devs, INDEX_DEV_COUNT - 1));
+
+	/* Renaming a device moves it in the index */
+	ut_assertok(device_set_name(devs[1], "renamed"));
+	ut_asserteq(-ENODEV, uclass_find_device_by_name(UCLASS_TEST,
+							"index002", &dev));
+	ut_assertok(check_uclass_index(uts, devs, INDEX_DEV_COUNT - 1));
+
+	return 0;
+}
+DM_TEST(dm_test_uclass_index, 0);
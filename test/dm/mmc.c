@@ -6,7 +6,10 @@
 #include <common.h>
 #include <dm.h>
 #include <mmc.h>
+#include <asm/test.h>
+#include <dm/device-internal.h>
 #include <dm/test.h>
+#include <dm/uclass-internal.h>
 #include <test/ut.h>
 
 /*
@@ -41,3 +44,176 @@ static int dm_test_mmc_blk(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_mmc_blk, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/* Test that an SD card still powering up is left pending, or waited for */
+static int dm_test_mmc_sd_op_cond(struct unit_test_state *uts)
+{
+	struct blk_desc *dev_desc;
+	struct udevice *dev;
+	struct mmc *mmc;
+	char cmp[1024];
+
+	ut_assertok(uclass_get_device(UCLASS_MMC, 0, &dev));
+	mmc = mmc_get_mmc_dev(dev);
+	ut_assertnonnull(mmc);
+
+	/* The emulated card needs a few ACMD41 commands to power up */
+	mmc->has_init = 0;
+	ut_assertok(mmc_start_init(mmc));
+	if (CONFIG_IS_ENABLED(MMC_ASYNC_INIT)) {
+		ut_asserteq(1, mmc->op_cond_pending);
+		ut_assert(!(mmc->ocr & OCR_BUSY));
+	} else {
+		ut_asserteq(0, mmc->op_cond_pending);
+		ut_assert(mmc->ocr & OCR_BUSY);
+	}
+	ut_assertok(mmc_init(mmc));
+	ut_asserteq(0, mmc->op_cond_pending);
+	ut_assert(mmc->ocr & OCR_BUSY);
+	ut_assert(mmc->high_capacity);
+
+	ut_assertok(blk_get_device_by_str("mmc", "0", &dev_desc));
+	memset(cmp, '\0', sizeof(cmp));
+	ut_asserteq(2, blk_dread(dev_desc, 0, 2, cmp));
+	ut_assertok(strcmp(cmp, "this is a test"));
+
+	return 0;
+}
+DM_TEST(dm_test_mmc_sd_op_cond, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/* Test that only the _check() iterators skip a device with deferred probe */
+static int dm_test_mmc_deferred(struct unit_test_state *uts)
+{
+	struct udevice *dev, *deferred;
+
+	/* mmc2 in test.dts has u-boot,deferred-probe and is bound first */
+	ut_assertok(uclass_find_first_device(UCLASS_MMC, &deferred));
+	ut_asserteq_str("mmc2", deferred->name);
+	if (!CONFIG_IS_ENABLED(DM_DEFERRED_PROBE)) {
+		ut_assert(!device_is_deferred(deferred));
+		return 0;
+	}
+	ut_assert(device_is_deferred(deferred));
+
+	for (uclass_first_device_check(UCLASS_MMC, &dev); dev;
+	     uclass_next_device_check(&dev))
+		ut_assert(dev != deferred);
+	ut_assert(!device_active(deferred));
+
+	/* Looking it up by index probes it, and then it is not skipped */
+	ut_assertok(uclass_get_device(UCLASS_MMC, 0, &dev));
+	ut_asserteq_ptr(deferred, dev);
+	ut_assert(device_active(deferred));
+	ut_assert(!device_is_deferred(deferred));
+	ut_assertok(uclass_first_device_check(UCLASS_MMC, &dev));
+	ut_asserteq_ptr(deferred, dev);
+
+	/* Once removed it is deferred again, except for uclass_first_device() */
+	ut_assertok(device_remove(deferred, DM_REMOVE_NORMAL));
+	ut_assert(device_is_deferred(deferred));
+	ut_assertok(uclass_first_device_check(UCLASS_MMC, &dev));
+	ut_assert(dev != deferred);
+	ut_assertok(uclass_first_device(UCLASS_MMC, &dev));
+	ut_asserteq_ptr(deferred, dev);
+	ut_assert(device_active(deferred));
+
+	return 0;
+}
+DM_TEST(dm_test_mmc_deferred, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/* Test that a rescan reuses the registers and mode found by the last init */
+static int dm_test_mmc_init_cache(struct unit_test_state *uts)
+{
+	int csd_count, ext_csd_count;
+	enum bus_mode mode;
+	struct udevice *dev;
+	struct mmc *mmc;
+	uint width;
+
+	if (!CONFIG_IS_ENABLED(MMC_INIT_CACHE))
+		return 0;
+
+	/* mmc3 in test.dts emulates an eMMC device, which has an EXT_CSD */
+	ut_assertok(uclass_get_device_by_name(UCLASS_MMC, "mmc3", &dev));
+	mmc = mmc_get_mmc_dev(dev);
+	ut_assertnonnull(mmc);
+	ut_assert(!IS_SD(mmc));
+	ut_asserteq(MMC_HS_52, mmc->selected_mode);
+	ut_asserteq(8, mmc->bus_width);
+	mode = mmc->selected_mode;
+	width = mmc->bus_width;
+
+	/* Leave the card on a boot partition, which the reset undoes */
+	ut_assertok(mmc_switch_part(mmc, 1));
+	ut_asserteq(1, mmc->ext_csd[EXT_CSD_PART_CONF] & PART_ACCESS_MASK);
+
+	csd_count = sandbox_mmc_get_cmd_count(dev, MMC_CMD_SEND_CSD);
+	ext_csd_count = sandbox_mmc_get_cmd_count(dev, MMC_CMD_SEND_EXT_CSD);
+	mmc->has_init = 0;
+	ut_assertok(mmc_init(mmc));
+
+	/*
+	 * Neither the CSD nor the EXT_CSD is read again. CMD8 is still sent
+	 * once, as SD_CMD_SEND_IF_COND to check for an SD card.
+	 */
+	ut_asserteq(csd_count,
+		    sandbox_mmc_get_cmd_count(dev, MMC_CMD_SEND_CSD));
+	ut_asserteq(ext_csd_count + 1,
+		    sandbox_mmc_get_cmd_count(dev, MMC_CMD_SEND_EXT_CSD));
+
+	/* The same mode is selected and the cached EXT_CSD matches the card */
+	ut_asserteq(mode, mmc->selected_mode);
+	ut_asserteq(width, mmc->bus_width);
+	ut_asserteq(EXT_CSD_TIMING_HS, mmc->ext_csd[EXT_CSD_HS_TIMING]);
+	ut_asserteq(EXT_CSD_BUS_WIDTH_8, mmc->ext_csd[EXT_CSD_BUS_WIDTH]);
+	ut_asserteq(0, mmc->ext_csd[EXT_CSD_PART_CONF] & PART_ACCESS_MASK);
+	ut_asserteq(0, mmc->part_config & PART_ACCESS_MASK);
+	ut_asserteq(0, mmc_get_blk_desc(mmc)->hwpart);
+
+	return 0;
+}
+DM_TEST(dm_test_mmc_init_cache, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/* Test that multiple-block reads use SET_BLOCK_COUNT if the card has it */
+static int dm_test_mmc_cmd23(struct unit_test_state *uts)
+{
+	struct blk_desc *dev_desc;
+	struct udevice *dev;
+	int sbc_count, stop_count;
+	char buf[1024];
+
+	/* mmc3 in test.dts emulates an eMMC device, which supports CMD23 */
+	ut_assertok(uclass_get_device_by_name(UCLASS_MMC, "mmc3", &dev));
+	dev_desc = mmc_get_blk_desc(mmc_get_mmc_dev(dev));
+	/* Make sure that the reads reach the device */
+	blkcache_invalidate(dev_desc->if_type, dev_desc->devnum);
+	sbc_count = sandbox_mmc_get_cmd_count(dev, MMC_CMD_SET_BLOCK_COUNT);
+	stop_count = sandbox_mmc_get_cmd_count(dev, MMC_CMD_STOP_TRANSMISSION);
+	ut_asserteq(2, blk_dread(dev_desc, 10, 2, buf));
+	ut_asserteq(sbc_count + 1,
+		    sandbox_mmc_get_cmd_count(dev, MMC_CMD_SET_BLOCK_COUNT));
+	ut_asserteq(stop_count,
+		    sandbox_mmc_get_cmd_count(dev, MMC_CMD_STOP_TRANSMISSION));
+
+	/* A single block needs neither command */
+	ut_asserteq(1, blk_dread(dev_desc, 20, 1, buf));
+	ut_asserteq(sbc_count + 1,
+		    sandbox_mmc_get_cmd_count(dev, MMC_CMD_SET_BLOCK_COUNT));
+	ut_asserteq(stop_count,
+		    sandbox_mmc_get_cmd_count(dev, MMC_CMD_STOP_TRANSMISSION));
+
+	/* The emulated SD card does not support CMD23, so it is stopped */
+	ut_assertok(uclass_get_device_by_name(UCLASS_MMC, "mmc0", &dev));
+	dev_desc = mmc_get_blk_desc(mmc_get_mmc_dev(dev));
+	blkcache_invalidate(dev_desc->if_type, dev_desc->devnum);
+	sbc_count = sandbox_mmc_get_cmd_count(dev, MMC_CMD_SET_BLOCK_COUNT);
+	stop_count = sandbox_mmc_get_cmd_count(dev, MMC_CMD_STOP_TRANSMISSION);
+	ut_asserteq(2, blk_dread(dev_desc, 10, 2, buf));
+	ut_asserteq(sbc_count,
+		    sandbox_mmc_get_cmd_count(dev, MMC_CMD_SET_BLOCK_COUNT));
+	ut_asserteq(stop_count + 1,
+		    sandbox_mmc_get_cmd_count(dev, MMC_CMD_STOP_TRANSMISSION));
+
+	return 0;
+}
+DM_TEST(dm_test_mmc_cmd23, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
@@ -2,6 +2,7 @@
 
 #include <common.h>
 #include <dm.h>
+#include <dm/of_access.h>
 #include <dm/of_extra.h>
 #include <dm/test.h>
 #include <test/ut.h>
@@ -44,6 +45,63 @@ static int dm_test_ofnode_by_prop_value(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_ofnode_by_prop_value, DM_TESTF_SCAN_FDT);
 
+/* Find the next compatible node by scanning, without any index */
+static ofnode scan_by_compatible(ofnode from, const char *compat)
+{
+	struct device_node *np;
+
+	if (!of_live_active()) {
+		return offset_to_ofnode(fdt_node_offset_by_compatible(
+				gd->fdt_blob, ofnode_to_offset(from), compat));
+	}
+	for_each_of_allnodes_from((struct device_node *)ofnode_to_np(from), np)
+		if (of_device_is_compatible(np, compat, NULL, NULL))
+			break;
+
+	return np_to_ofnode(np);
+}
+
+static int dm_test_ofnode_by_compatible(struct unit_test_state *uts)
+{
+	const char compat[] = "denx,u-boot-fdt-test";
+	ofnode node, expect;
+	int count = 0;
+
+	/* Both must find the same nodes in the same order */
+	node = ofnode_null();
+	do {
+		expect = scan_by_compatible(node, compat);
+		node = ofnode_by_compatible(node, compat);
+		ut_assert(ofnode_equal(expect, node) ||
+			  (!ofnode_valid(expect) && !ofnode_valid(node)));
+		count++;
+	} while (ofnode_valid(node));
+	ut_assert(count > 2);
+
+	ut_assert(!ofnode_valid(ofnode_by_compatible(ofnode_null(),
+						     "denx,no-such-device")));
+
+	return 0;
+}
+DM_TEST(dm_test_ofnode_by_compatible, DM_TESTF_SCAN_FDT);
+
+static int dm_test_ofnode_get_by_phandle(struct unit_test_state *uts)
+{
+	ofnode node, gpio_a;
+	uint phandle;
+
+	gpio_a = ofnode_path("/base-gpios");
+	ut_assert(ofnode_valid(gpio_a));
+	node = ofnode_path("/backlight");
+	ut_assert(ofnode_valid(node));
+	ut_assertok(ofnode_read_u32(node, "enable-gpios", &phandle));
+	ut_assert(ofnode_equal(gpio_a, ofnode_get_by_phandle(phandle)));
+	ut_assert(!ofnode_valid(ofnode_get_by_phandle(0x7fffffff)));
+
+	return 0;
+}
+DM_TEST(dm_test_ofnode_get_by_phandle, DM_TESTF_SCAN_FDT);
+
 static int dm_test_ofnode_fmap(struct unit_test_state *uts)
 {
 	struct fmap_entry entry;
@@ -6,9 +6,12 @@
 #include <common.h>
 #include <serial.h>
 #include <dm.h>
+#include <asm/test.h>
 #include <dm/test.h>
 #include <test/ut.h>
 
+DECLARE_GLOBAL_DATA_PTR;
+
 static int dm_test_serial(struct unit_test_state *uts)
 {
 	struct serial_device_info info_serial = {0};
@@ -67,3 +70,27 @@ static int dm_test_serial(struct unit_test_state *uts)
 }
 
 DM_TEST(dm_test_serial, DM_TESTF_SCAN_FDT);
+
+/* Test that serial_flush() waits until the console has sent its output */
+static int dm_test_serial_flush(struct unit_test_state *uts)
+{
+	struct udevice *dev, *old_dev = gd->cur_serial_dev;
+	struct dm_serial_ops *ops;
+
+	ut_assertok(uclass_get_device_by_name(UCLASS_SERIAL, "serial", &dev));
+	ops = serial_get_ops(dev);
+	ut_asserteq(0, ops->pending(dev, false));
+
+	sandbox_serial_set_tx_pending(dev, 5);
+	ut_asserteq(5, ops->pending(dev, false));
+	ut_asserteq(4, ops->pending(dev, false));
+
+	gd->cur_serial_dev = dev;
+	serial_flush();
+	gd->cur_serial_dev = old_dev;
+	ut_asserteq(0, ops->pending(dev, false));
+
+	return 0;
+}
+
+DM_TEST(dm_test_serial_flush, DM_TESTF_SCAN_FDT);
@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the log-structured environment in SPI flash
+ *
+ * These use the SPI flash in test.dts, with its emulation switched to the
+ * sf-log-image node so that env_sf_log.bin is used instead of spi.bin. Power
+ * cuts are simulated by putting back the old contents of the flash over the
+ * end of what a save wrote.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <dm.h>
+#include <environment.h>
+#include <malloc.h>
+#include <os.h>
+#include <spi.h>
+#include <spi_flash.h>
+#include <test/env.h>
+#include <test/ut.h>
+#include <asm/state.h>
+
+/* Size of env_sf_log.bin, as for the spansion,m25p16 in test.dts */
+#define SPI_BIN_SIZE	(2 << 20)
+#define SPI_BIN_NAME	"env_sf_log.bin"
+#define LOG_SIZE	CONFIG_ENV_SF_LOG_SIZE
+#define VAR		"sf_log_test"
+
+/* Read the log area into @buf or, if @write, erase it and write @buf */
+static int log_access(struct unit_test_state *uts, u8 *buf, bool write)
+{
+	struct udevice *dev;
+
+	/* The env code removes the device after loading, so probe it again */
+	ut_assertok(spi_flash_probe_bus_cs(CONFIG_SF_DEFAULT_BUS,
+					   CONFIG_SF_DEFAULT_CS,
+					   CONFIG_SF_DEFAULT_SPEED,
+					   CONFIG_SF_DEFAULT_MODE, &dev));
+	if (write) {
+		ut_assertok(spi_flash_erase_dm(dev, CONFIG_ENV_OFFSET,
+					       LOG_SIZE));
+		ut_assertok(spi_flash_write_dm(dev, CONFIG_ENV_OFFSET,
+					       LOG_SIZE, buf));
+	} else {
+		ut_assertok(spi_flash_read_dm(dev, CONFIG_ENV_OFFSET, LOG_SIZE,
+					      buf));
+	}
+
+	return 0;
+}
+
+/*
+ * Emulate the environment's SPI flash from the sf-log-image node if @own,
+ * else go back to the emulation from its own node (spi.bin)
+ */
+static int use_own_image(struct unit_test_state *uts, bool own)
+{
+	struct sandbox_state *state = state_get_current();
+	const int busnum = CONFIG_SF_DEFAULT_BUS, cs = CONFIG_SF_DEFAULT_CS;
+	struct udevice *bus;
+	ofnode node;
+
+	ut_assertok(uclass_get_device_by_seq(UCLASS_SPI, busnum, &bus));
+	if (state->spi[busnum][cs].emul)
+		sandbox_sf_unbind_emul(state, busnum, cs);
+	if (own) {
+		node = ofnode_path("/sf-log-image");
+		ut_assert(ofnode_valid(node));
+		ut_assertok(sandbox_sf_bind_emul(state, busnum, cs, bus, node,
+						 "sf-log-image"));
+	}
+
+	return 0;
+}
+
+static int save_val(struct unit_test_state *uts, int val)
+{
+	ut_assertok(env_set_ulong(VAR, val));
+	ut_assertok(env_save());
+
+	return 0;
+}
+
+/* Check that loading the environment gives @val, or no variable if -1 */
+static int check_load(struct unit_test_state *uts, int val)
+{
+	ut_assertok(env_set(VAR, "none"));
+	env_load();
+	ut_asserteq(val, env_get_ulong(VAR, 10, -1));
+
+	return 0;
+}
+
+/*
+ * Save @val, then simulate a power cut by undoing what was written after
+ * the first few bytes of the record header, or after half of the record
+ */
+static int save_torn(struct unit_test_state *uts, u8 *before, u8 *after,
+		     int val, bool in_header)
+{
+	int lo, hi, keep;
+
+	ut_assertok(log_access(uts, before, false));
+	ut_assertok(save_val(uts, val));
+	ut_assertok(log_access(uts, after, false));
+
+	for (lo = 0; lo < LOG_SIZE && before[lo] == after[lo]; lo++)
+		;
+	for (hi = LOG_SIZE; hi > lo && before[hi - 1] == after[hi - 1]; hi--)
+		;
+	keep = in_header ? 8 : (hi - lo) / 2;
+	ut_assert(hi - lo > keep);
+	memcpy(after + lo + keep, before + lo + keep, hi - lo - keep);
+	ut_assertok(log_access(uts, after, true));
+
+	return 0;
+}
+
+static int env_test_sf_log(struct unit_test_state *uts)
+{
+	u8 *before, *after;
+	u8 first[32];
+	bool wrapped;
+	int val;
+
+	before = malloc(SPI_BIN_SIZE);
+	ut_assertnonnull(before);
+	after = malloc(LOG_SIZE);
+	ut_assertnonnull(after);
+
+	/* Start with an erased flash: there is nothing to load */
+	memset(before, 0xff, SPI_BIN_SIZE);
+	ut_assertok(os_write_file(SPI_BIN_NAME, before, SPI_BIN_SIZE));
+	ut_assertok(use_own_image(uts, true));
+	ut_assertok(check_load(uts, -1));
+
+	/* Each save appends a record and the newest one is loaded */
+	ut_assertok(save_val(uts, 1));
+	ut_assertok(check_load(uts, 1));
+	ut_assertok(save_val(uts, 2));
+	ut_assertok(save_val(uts, 3));
+	ut_assertok(check_load(uts, 3));
+
+	/* Power cut while writing the data: the previous record is used */
+	ut_assertok(save_torn(uts, before, after, 4, false));
+	ut_assertok(check_load(uts, 3));
+	ut_assertok(save_val(uts, 5));
+	ut_assertok(check_load(uts, 5));
+
+	/* Power cut in the header: the next save starts a new sector */
+	ut_assertok(save_torn(uts, before, after, 6, true));
+	ut_assertok(check_load(uts, 5));
+	ut_assertok(log_access(uts, before, false));
+	ut_asserteq(0xff, before[CONFIG_ENV_SECT_SIZE]);
+	ut_assertok(save_val(uts, 7));
+	ut_assertok(check_load(uts, 7));
+	ut_assertok(log_access(uts, before, false));
+	ut_assert(before[CONFIG_ENV_SECT_SIZE] != 0xff);
+
+	/* Keep saving until the log goes back to the first sector */
+	memcpy(first, before, sizeof(first));
+	wrapped = false;
+	for (val = 8; !wrapped && val < 1000; val++) {
+		ut_assertok(save_val(uts, val));
+		ut_assertok(log_access(uts, before, false));
+		wrapped = memcmp(first, before, sizeof(first));
+	}
+	ut_assert(wrapped);
+	ut_assertok(check_load(uts, val - 1));
+
+	ut_assertok(use_own_image(uts, false));
+	env_set(VAR, NULL);
+	free(after);
+	free(before);
+
+	return 0;
+}
+ENV_TEST(env_test_sf_log, 0);
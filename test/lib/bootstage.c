@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for exporting bootstage records as JSON
+ */
+
+#include <common.h>
+#include <bootstage.h>
+#include <command.h>
+#include <malloc.h>
+#include <mapmem.h>
+#include <os.h>
+#include <test/lib.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+#define JSON_HEAD	"{\"version\":1,\"records\":["
+#define JSON_TAIL	"\n]}\n"
+#define JSON_FILE	"bootstage_test.json"
+
+/* Export the records into a new buffer, checking the length is consistent */
+static int export_json(struct unit_test_state *uts, char **bufp)
+{
+	char *buf;
+	int len;
+
+	len = bootstage_export_json(NULL, 0);
+	ut_assert(len > strlen(JSON_HEAD JSON_TAIL));
+	buf = malloc(len + 1);
+	ut_assertnonnull(buf);
+	memset(buf, 'x', len + 1);
+	ut_asserteq(len, bootstage_export_json(buf, len + 1));
+	ut_asserteq(len, strlen(buf));
+	*bufp = buf;
+
+	return 0;
+}
+
+static int lib_test_bootstage_export(struct unit_test_state *uts)
+{
+	char *buf, *small;
+	uint32_t start;
+	int len;
+
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "test \"export\"");
+	start = timer_get_boot_us();
+	udelay(10);
+	bootstage_accum_name("test_accum", start);
+
+	ut_assertok(export_json(uts, &buf));
+	len = strlen(buf);
+	ut_assertok(strncmp(buf, JSON_HEAD, strlen(JSON_HEAD)));
+	ut_asserteq_str(JSON_TAIL, buf + len - strlen(JSON_TAIL));
+	ut_assertnonnull(strstr(buf, "\"name\":\"reset\",\"mark\":"));
+	ut_assertnonnull(strstr(buf, "\"name\":\"test \\\"export\\\"\",\"mark\":"));
+	ut_assertnonnull(strstr(buf, "\"name\":\"test_accum\",\"accum\":"));
+
+	/* A short buffer is filled as far as it goes, with the full length */
+	small = calloc(1, len);
+	ut_assertnonnull(small);
+	memset(small, 'x', len);
+	ut_asserteq(len, bootstage_export_json(small, len));
+	ut_assertok(memcmp(buf, small, len));
+	memset(small, 'x', len);
+	ut_asserteq(len, bootstage_export_json(small, 10));
+	ut_assertok(memcmp(buf, small, 10));
+	ut_asserteq('x', small[10]);
+
+	free(small);
+	free(buf);
+
+	return 0;
+}
+LIB_TEST(lib_test_bootstage_export, 0);
+
+static int lib_test_bootstage_cmd(struct unit_test_state *uts)
+{
+	ulong addr = 0x1000;
+	char *buf, *mem;
+	char cmd[80];
+	int len;
+
+	ut_assertok(export_json(uts, &buf));
+	len = strlen(buf);
+
+	/* The command exports to memory and sets filesize */
+	mem = map_sysmem(addr, len + 1);
+	memset(mem, '\0', len + 1);
+	snprintf(cmd, sizeof(cmd), "bootstage export %lx %x", addr, len + 1);
+	ut_assertok(run_command(cmd, 0));
+	ut_asserteq(len, env_get_hex("filesize", 0));
+	ut_asserteq_str(buf, mem);
+
+	/* One byte short leaves no room for the terminator */
+	snprintf(cmd, sizeof(cmd), "bootstage export %lx %x", addr, len);
+	ut_asserteq(1, run_command(cmd, 0));
+
+#ifdef CONFIG_CMD_BOOTSTAGE_SAVE
+	memset(mem, '\0', len + 1);
+	snprintf(cmd, sizeof(cmd), "bootstage save hostfs - %s", JSON_FILE);
+	ut_assertok(run_command(cmd, 0));
+	snprintf(cmd, sizeof(cmd), "host load hostfs - %lx %s", addr, JSON_FILE);
+	ut_assertok(run_command(cmd, 0));
+	ut_asserteq(len, env_get_hex("filesize", 0));
+	ut_asserteq_str(buf, mem);
+	os_unlink(JSON_FILE);
+#endif
+	unmap_sysmem(mem);
+	free(buf);
+
+	return 0;
+}
+LIB_TEST(lib_test_bootstage_cmd, 0);
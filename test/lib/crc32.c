@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Unit tests and benchmark for the CRC32 implementations
+ *
+ * The table-driven and instruction-based implementations take different
+ * paths depending on the alignment and length of the buffer, so these are
+ * swept and the result compared with a simple bitwise implementation.
+ */
+
+#include <common.h>
+#include <malloc.h>
+#include <test/lib.h>
+#include <test/test.h>
+#include <test/ut.h>
+#include <u-boot/crc.h>
+
+/* Number of different alignment values */
+#define SWEEP		16
+/* Buffer used for the correctness checks */
+#define BUFLEN		(SWEEP + 80)
+/* Buffer used for the benchmark */
+#define BENCH_SIZE	(4 << 20)
+
+/* Reference implementation, one bit at a time */
+static uint32_t crc32_bitwise(uint32_t crc, const u8 *buf, uint len)
+{
+	int i;
+
+	crc = ~crc;
+	while (len--) {
+		crc ^= *buf++;
+		for (i = 0; i < 8; i++)
+			crc = (crc >> 1) ^ (crc & 1 ? 0xedb88320 : 0);
+	}
+
+	return ~crc;
+}
+
+static int lib_crc32(struct unit_test_state *uts)
+{
+	u8 buf[BUFLEN];
+	int offset, len, i;
+
+	ut_asserteq(0xcbf43926, crc32(0, (const u8 *)"123456789", 9));
+
+	for (i = 0; i < BUFLEN; i++)
+		buf[i] = i * 37 + 11;
+
+	for (offset = 0; offset < SWEEP; offset++) {
+		for (len = 0; len <= BUFLEN - offset; len++) {
+			ut_asserteq(crc32_bitwise(0x12345678, buf + offset, len),
+				    crc32(0x12345678, buf + offset, len));
+		}
+	}
+
+	/* Incremental use must give the same result */
+	ut_asserteq(crc32(0, buf, BUFLEN),
+		    crc32(crc32(0, buf, 13), buf + 13, BUFLEN - 13));
+
+	return 0;
+}
+
+LIB_TEST(lib_crc32, 0);
+
+static uint32_t crc32_bench(const char *impl, const u8 *buf, uint size)
+{
+	ulong start, us;
+	uint32_t crc;
+
+	start = timer_get_us();
+	crc = crc32(0, buf, size);
+	us = max(timer_get_us() - start, 1UL);
+
+	printf("crc32 %-8s %08x %8lu us %5lu MB/s\n", impl, crc, us,
+	       size / us);
+
+	return crc;
+}
+
+static int lib_crc32_bench(struct unit_test_state *uts)
+{
+	uint32_t expect;
+	u8 *buf;
+	int i;
+
+	buf = malloc(BENCH_SIZE);
+	ut_assertnonnull(buf);
+	for (i = 0; i < BENCH_SIZE; i++)
+		buf[i] = i * 7 + (i >> 8);
+	expect = crc32_bitwise(0, buf, BENCH_SIZE);
+
+#ifdef CONFIG_CRC32_ARCH
+	crc32_use_arch = 0;
+	ut_asserteq(expect, crc32_bench("generic", buf, BENCH_SIZE));
+	crc32_use_arch = 1;
+	ut_asserteq(expect, crc32_bench("arch", buf, BENCH_SIZE));
+#else
+	ut_asserteq(expect,
+		    crc32_bench(CONFIG_IS_ENABLED(CRC32_SLICE8) ? "slice8" :
+				"bytewise", buf, BENCH_SIZE));
+#endif
+	free(buf);
+
+	return 0;
+}
+
+LIB_TEST(lib_crc32_bench, 0);
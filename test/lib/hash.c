@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Known-answer tests for SHA1 and SHA256
+ *
+ * The test vectors are those from FIPS 180-2. Each message is fed in pieces
+ * of several sizes so that both the partial-block buffer and runs of whole
+ * blocks are used. Where the architecture provides its own block function,
+ * the tests are run with and without it.
+ */
+
+#include <common.h>
+#include <hash.h>
+#include <malloc.h>
+#include <test/lib.h>
+#include <test/test.h>
+#include <test/ut.h>
+#include <u-boot/sha1.h>
+#include <u-boot/sha256.h>
+
+struct hash_vector {
+	const char *msg;	/* message, repeated @count times */
+	int count;
+	const char *sha1;
+	const char *sha256;
+};
+
+static const struct hash_vector vectors[] = {
+	{
+		"", 1,
+		"da39a3ee5e6b4b0d3255bfef95601890afd80709",
+		"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+	}, {
+		"abc", 1,
+		"a9993e364706816aba3e25717850c26c9cd0d89d",
+		"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+	}, {
+		"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1,
+		"84983e441c3bd26ebaae4aa1f95129e5e54670f1",
+		"248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+	}, {
+		"aaaaaaaaaa", 100000,
+		"34aa973cd4c4daa4f61eeb2bdbad27316534016f",
+		"cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0",
+	},
+};
+
+/* Sizes of the pieces passed to each update call, 0 for all at once */
+static const uint steps[] = { 0, 1, 3, 63, 64, 65, 1000 };
+
+/* Hash @buf in pieces of @step bytes and write the digest to @hex */
+static int hash_buf(struct unit_test_state *uts, struct hash_algo *algo,
+		    const u8 *buf, uint len, uint step, char *hex)
+{
+	u8 digest[HASH_MAX_DIGEST_SIZE];
+	uint pos, todo;
+	void *ctx;
+	int i;
+
+	if (!step)
+		step = max(len, 1U);
+	ut_assertok(algo->hash_init(algo, &ctx));
+	for (pos = 0; pos < len; pos += todo) {
+		todo = min(step, len - pos);
+		ut_assertok(algo->hash_update(algo, ctx, buf + pos, todo,
+					      pos + todo == len));
+	}
+	ut_assertok(algo->hash_finish(algo, ctx, digest, sizeof(digest)));
+
+	for (i = 0; i < algo->digest_size; i++)
+		sprintf(hex + i * 2, "%02x", digest[i]);
+
+	return 0;
+}
+
+static int check_vectors(struct unit_test_state *uts, const char *name)
+{
+	char hex[HASH_MAX_DIGEST_SIZE * 2 + 1];
+	struct hash_algo *algo;
+	int i, j, k;
+
+	ut_assertok(hash_progressive_lookup_algo(name, &algo));
+	for (i = 0; i < ARRAY_SIZE(vectors); i++) {
+		const struct hash_vector *vec = &vectors[i];
+		const char *expect = strcmp(name, "sha1") ? vec->sha256 :
+				     vec->sha1;
+		uint msg_len = strlen(vec->msg);
+		uint len = msg_len * vec->count;
+		u8 *buf;
+
+		buf = malloc(len + 1);
+		ut_assertnonnull(buf);
+		for (j = 0; j < vec->count; j++)
+			memcpy(buf + j * msg_len, vec->msg, msg_len);
+
+		for (k = 0; k < ARRAY_SIZE(steps); k++) {
+			ut_assertok(hash_buf(uts, algo, buf, len, steps[k],
+					     hex));
+			ut_asserteq_str(expect, hex);
+		}
+		free(buf);
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_SHA1
+static int lib_test_sha1(struct unit_test_state *uts)
+{
+#ifdef CONFIG_SHA1_ARCH
+	int ret;
+
+	sha1_use_arch = 0;
+	ret = check_vectors(uts, "sha1");
+	sha1_use_arch = 1;
+	if (ret)
+		return ret;
+#endif
+	return check_vectors(uts, "sha1");
+}
+
+LIB_TEST(lib_test_sha1, 0);
+#endif
+
+#ifdef CONFIG_SHA256
+static int lib_test_sha256(struct unit_test_state *uts)
+{
+#ifdef CONFIG_SHA256_ARCH
+	int ret;
+
+	sha256_use_arch = 0;
+	ret = check_vectors(uts, "sha256");
+	sha256_use_arch = 1;
+	if (ret)
+		return ret;
+#endif
+	return check_vectors(uts, "sha256");
+}
+
+LIB_TEST(lib_test_sha256, 0);
+#endif
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the builtin symbol table format
+ */
+
+#include <common.h>
+#include <test/lib.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+/* Number of hex digits in each address, as printed by nm */
+#define ADDR_DIGITS	(int)(sizeof(ulong) * 2)
+
+/*
+ * Build a table like the one in common/system_map.o. Most of the names start
+ * with hex digits, which must not be taken as part of the address.
+ */
+static void build_map(char *map, int size)
+{
+	static const struct {
+		ulong addr;
+		const char *name;
+	} syms[] = {
+		{ 0x1000, "add_entry" },
+		{ 0x1040, "_start_code" },
+		{ 0x10a0, "fade" },
+		{ 0x2000, "0x_not_hex" },
+	};
+	char *ptr = map;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(syms); i++) {
+		ptr += snprintf(ptr, map + size - ptr, "%0*lx%s", ADDR_DIGITS,
+				syms[i].addr, syms[i].name) + 1;
+	}
+	*ptr = '\0';
+}
+
+static int lib_test_kallsyms(struct unit_test_state *uts)
+{
+	ulong base, next;
+	char map[200];
+
+	build_map(map, sizeof(map) - 1);
+
+	/* Before the first symbol */
+	ut_assertnull(symbol_lookup_map(map, 0xfff, &base, &next));
+	ut_asserteq(0, base);
+	ut_asserteq(0x1000, next);
+
+	ut_asserteq_str("add_entry",
+			symbol_lookup_map(map, 0x1000, &base, &next));
+	ut_asserteq(0x1000, base);
+	ut_asserteq(0x1040, next);
+	ut_asserteq_str("_start_code",
+			symbol_lookup_map(map, 0x109f, &base, &next));
+	ut_asserteq(0x1040, base);
+	ut_asserteq(0x10a0, next);
+	ut_asserteq_str("fade", symbol_lookup_map(map, 0x10a4, &base, &next));
+	ut_asserteq(0x10a0, base);
+	ut_asserteq(0x2000, next);
+
+	/* The last symbol runs to the end of memory */
+	ut_asserteq_str("0x_not_hex",
+			symbol_lookup_map(map, 0x80000000, &base, &next));
+	ut_asserteq(0x2000, base);
+	ut_assert(next == ~0UL);
+
+	return 0;
+}
+LIB_TEST(lib_test_kallsyms, 0);
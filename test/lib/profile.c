@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the sampling profiler's report
+ *
+ * Samples are taken with the sandbox profiler timer, which only fires when
+ * sandbox_profile_tick() is called. The addresses are below any function, so
+ * are shown by address whether or not there is a symbol table.
+ */
+
+#include <common.h>
+#include <console.h>
+#include <membuff.h>
+#include <profile.h>
+#include <asm/test.h>
+#include <test/lib.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Check that the next line of recorded console output is @expect */
+static int check_line(struct unit_test_state *uts, const char *expect)
+{
+	char line[80];
+
+	ut_assert(membuff_readline(&gd->console_out, line, sizeof(line),
+				   ' ') > 0);
+	ut_asserteq_str(expect, line);
+
+	return 0;
+}
+
+static int lib_test_profile_report(struct unit_test_state *uts)
+{
+	char expect[80];
+	int i;
+
+	/* Nothing is sampled unless the profiler is running */
+	ut_asserteq(0, sandbox_profile_tick(0x10, 0));
+	ut_assertok(profile_start(100));
+	ut_assert(profile_running());
+	for (i = 0; i < 3; i++)
+		ut_asserteq(1, sandbox_profile_tick(0x10, 0));
+	ut_asserteq(1, sandbox_profile_tick(0x20, 0));
+	ut_asserteq(1, sandbox_profile_tick(0x31, 0));	/* Thumb bit */
+	ut_asserteq(1, sandbox_profile_tick(0x30, 0));
+	profile_stop();
+	ut_assert(!profile_running());
+	ut_asserteq(0, sandbox_profile_tick(0x10, 0));
+
+	/* Functions with most samples first, then by address */
+	console_record_reset_enable();
+	ut_assertok(profile_report(0));
+	ut_assertok(check_line(uts, "6 samples at 100 Hz"));
+	ut_assertok(check_line(uts, " Samples      %  Function"));
+	ut_assertok(check_line(uts, "       3   50.0  00000010"));
+	ut_assertok(check_line(uts, "       2   33.3  00000030"));
+	ut_assertok(check_line(uts, "       1   16.6  00000020"));
+
+	/* Only the first few functions */
+	console_record_reset();
+	ut_assertok(profile_report(1));
+	ut_assertok(check_line(uts, "6 samples at 100 Hz"));
+	ut_assertok(check_line(uts, " Samples      %  Function"));
+	ut_assertok(check_line(uts, "       3   50.0  00000010"));
+	ut_assertok(check_line(uts, "(2 more)"));
+
+	/* Once the buffer is full, the oldest samples are dropped */
+	ut_assertok(profile_start(1000));
+	for (i = 0; i < CONFIG_PROFILE_SAMPLES + 2; i++)
+		ut_asserteq(1, sandbox_profile_tick(i < 2 ? 0x10 : 0x20, 0));
+	profile_stop();
+	console_record_reset();
+	ut_assertok(profile_report(0));
+	gd->flags &= ~GD_FLG_RECORD;
+	snprintf(expect, sizeof(expect), "%d samples at 1000 Hz, last %d kept",
+		 CONFIG_PROFILE_SAMPLES + 2, CONFIG_PROFILE_SAMPLES);
+	ut_assertok(check_line(uts, expect));
+	ut_assertok(check_line(uts, " Samples      %  Function"));
+	snprintf(expect, sizeof(expect), "%8d  100.0  00000020",
+		 CONFIG_PROFILE_SAMPLES);
+	ut_assertok(check_line(uts, expect));
+
+	/* There is nothing to report without samples */
+	ut_assertok(profile_start(100));
+	profile_stop();
+	ut_asserteq(-ENOENT, profile_report(0));
+
+	return 0;
+}
+LIB_TEST(lib_test_profile_report, 0);
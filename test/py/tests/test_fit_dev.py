@@ -0,0 +1,224 @@
+# SPDX-License-Identifier:	GPL-2.0+
+#
+# Test 'bootm dev', which reads a FIT with external data from a block device,
+# fetching only the subimages of the selected configuration
+
+from __future__ import print_function
+
+import os
+import pytest
+import u_boot_utils as util
+
+# Two kernels which are loaded to the same place, so that we can tell which
+# configuration was booted
+base_its = '''
+/dts-v1/;
+
+/ {
+        description = "FIT read from a block device";
+        #address-cells = <1>;
+
+        images {
+                kernel@1 {
+                        data = /incbin/("%(kernel1)s");
+                        type = "kernel";
+                        arch = "sandbox";
+                        os = "linux";
+                        compression = "none";
+                        load = <%(kernel_addr)#x>;
+                        entry = <%(kernel_addr)#x>;
+                };
+                kernel@2 {
+                        data = /incbin/("%(kernel2)s");
+                        type = "kernel";
+                        arch = "sandbox";
+                        os = "linux";
+                        compression = "none";
+                        load = <%(kernel_addr)#x>;
+                        entry = <%(kernel_addr)#x>;
+                };
+                ramdisk@1 {
+                        data = /incbin/("%(ramdisk)s");
+                        type = "ramdisk";
+                        arch = "sandbox";
+                        os = "linux";
+                        compression = "none";
+                        load = <%(ramdisk_addr)#x>;
+                };
+        };
+        configurations {
+                default = "conf@1";
+                conf@1 {
+                        kernel = "kernel@1";
+                };
+                conf@2 {
+                        kernel = "kernel@2";
+                        ramdisk = "ramdisk@1";
+                };
+        };
+};
+'''
+
+# A FIT whose kernel data lies far outside memory. This is built with dtc
+# rather than mkimage, which would not produce such an image.
+bad_its = '''
+/dts-v1/;
+
+/ {
+        description = "FIT with bad data position";
+        timestamp = <0>;
+        #address-cells = <1>;
+
+        images {
+                kernel@1 {
+                        data-position = <0x7ffff000>;
+                        data-size = <0x1000>;
+                        type = "kernel";
+                        arch = "sandbox";
+                        os = "linux";
+                        compression = "none";
+                        load = <0x40000>;
+                        entry = <0x40000>;
+                };
+        };
+        configurations {
+                default = "conf@1";
+                conf@1 {
+                        kernel = "kernel@1";
+                };
+        };
+};
+'''
+
+# Bind the disk image, boot from it and save what was loaded
+base_script = '''
+host bind 0 %(disk)s
+bootm dev host 0 %(fit_offset)x%(conf)s
+host save hostfs 0 %(kernel_addr)x %(kernel_out)s %(kernel_size)x
+host save hostfs 0 %(ramdisk_addr)x %(ramdisk_out)s %(ramdisk_size)x
+host bind 0
+'''
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('fit_dev_load')
+@pytest.mark.requiredtool('dtc')
+def test_fit_dev(u_boot_console):
+    def make_fname(leaf):
+        """Make a temporary filename
+
+        Args:
+            leaf: Leaf name of file to create (within temporary directory)
+        Return:
+            Temporary filename
+        """
+        return os.path.join(cons.config.build_dir, leaf)
+
+    def read_file(fname):
+        """Read the contents of a file
+
+        Args:
+            fname: Filename to read
+        Returns:
+            Contents of file as a string
+        """
+        with open(fname, 'rb') as fd:
+            return fd.read()
+
+    def make_data(filename, text):
+        """Make a sample kernel or ramdisk with test data
+
+        Args:
+            filename: Leaf name of the file to create
+            text: Text to repeat in the file
+        Returns:
+            Full path and filename of the file created
+        """
+        fname = make_fname(filename)
+        with open(fname, 'w') as fd:
+            for i in range(100):
+                print('this %s %d is unlikely to boot' % (text, i), file=fd)
+        return fname
+
+    def make_disk(fit):
+        """Make a disk image holding the FIT at params['fit_offset']
+
+        Args:
+            fit: Filename of the FIT to put on the disk
+        Returns:
+            Filename of the disk image created
+        """
+        disk = make_fname('test-fit-dev.img')
+        with open(disk, 'wb') as fd:
+            fd.truncate(1 << 20)
+            fd.seek(params['fit_offset'])
+            fd.write(read_file(fit))
+        return disk
+
+    def run_boot(conf):
+        """Boot a configuration from the disk and check what was read
+
+        Args:
+            conf: Configuration to select, or '' for the default
+        Returns:
+            Output from U-Boot, one string for each command
+        """
+        params['conf'] = conf
+        cons.restart_uboot()
+        return cons.run_command_list((base_script % params).splitlines())
+
+    cons = u_boot_console
+    mkimage = cons.config.build_dir + '/tools/mkimage'
+    kernel1 = make_data('test-fit-dev-kernel1.bin', 'kernel')
+    kernel2 = make_data('test-fit-dev-kernel2.bin', 'lenrek')
+    ramdisk = make_data('test-fit-dev-ramdisk.bin', 'ramdisk')
+    params = {
+        'fit_offset' : 0x2000,
+        'kernel1' : kernel1,
+        'kernel2' : kernel2,
+        'kernel_addr' : 0x40000,
+        'kernel_size' : os.path.getsize(kernel1),
+        'kernel_out' : make_fname('test-fit-dev-kernel-out.bin'),
+        'ramdisk' : ramdisk,
+        'ramdisk_addr' : 0xc0000,
+        'ramdisk_size' : os.path.getsize(ramdisk),
+        'ramdisk_out' : make_fname('test-fit-dev-ramdisk-out.bin'),
+    }
+
+    # Put the image data after the FIT structure, as mkimage -E does
+    its = make_fname('test-fit-dev.its')
+    with open(its, 'w') as fd:
+        print(base_its % params, file=fd)
+    fit = make_fname('test-fit-dev.fit')
+    util.run_and_log(cons, [mkimage, '-E', '-f', its, fit])
+    params['disk'] = make_disk(fit)
+
+    with cons.log.section('Default configuration'):
+        output = '\n'.join(run_boot(''))
+        assert "Reading 'kernel@1'" in output
+        assert "Reading 'kernel@2'" not in output
+        assert "Reading 'ramdisk@1'" not in output
+        assert 'Transferring control to Linux' in output
+        assert read_file(kernel1) == read_file(params['kernel_out'])
+
+    with cons.log.section('Selected configuration'):
+        output = '\n'.join(run_boot('#conf@2'))
+        assert "Reading 'kernel@1'" not in output
+        assert "Reading 'kernel@2'" in output
+        assert "Reading 'ramdisk@1'" in output
+        assert 'Transferring control to Linux' in output
+        assert read_file(kernel2) == read_file(params['kernel_out'])
+        assert read_file(ramdisk) == read_file(params['ramdisk_out'])
+
+    with cons.log.section('Data outside memory'):
+        its = make_fname('test-fit-dev-bad.its')
+        with open(its, 'w') as fd:
+            print(bad_its, file=fd)
+        fit = make_fname('test-fit-dev-bad.fit')
+        util.run_and_log(cons, ['dtc', '-I', 'dts', '-O', 'dtb', '-o', fit,
+                                its])
+        params['disk'] = make_disk(fit)
+        output = '\n'.join(run_boot(''))
+        assert ("'kernel@1' data (4096 bytes at 0x7ffff000) does not fit"
+                in output)
+        assert "Reading 'kernel@1'" not in output
+        assert 'Transferring control to Linux' not in output
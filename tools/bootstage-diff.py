@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-2.0+
+#
+# Compare U-Boot boot timelines
+#
+# Reads bootstage records written by 'bootstage export' / 'bootstage save'
+# (JSON), or the console output of 'bootstage report'. Several runs can be
+# merged into one timeline to reduce noise, and two timelines can be
+# compared, flagging stages which got slower by more than a threshold. The
+# exit status is 1 if there is any such regression, so this can be used to
+# gate releases on boot time.
+#
+# Examples:
+#   bootstage-diff.py merge -o base.json run1.json run2.json run3.json
+#   bootstage-diff.py diff -t 1000 -p 10 base.json new.json
+
+import argparse
+import json
+import re
+import statistics
+import sys
+
+MARK, ACCUM = 'mark', 'accum'
+
+
+class Record:
+    """A single bootstage record
+
+    Attributes:
+        name: Name of the record (e.g. 'board_init_f')
+        kind: MARK for a time stamp, ACCUM for an accumulated duration
+        time_us: Time stamp or duration in microseconds
+    """
+    def __init__(self, name, kind, time_us):
+        self.name = name
+        self.kind = kind
+        self.time_us = time_us
+
+
+def unique_name(records, name):
+    """Make a name unique within records, by adding '#2', '#3', etc."""
+    if name not in records:
+        return name
+    num = 2
+    while '%s#%d' % (name, num) in records:
+        num += 1
+    return '%s#%d' % (name, num)
+
+
+def parse_json(text):
+    data = json.loads(text)
+    if data.get('version') != 1:
+        raise ValueError('Unsupported version %s' % data.get('version'))
+    records = {}
+    for rec in data['records']:
+        kind = ACCUM if ACCUM in rec else MARK
+        name = unique_name(records, rec['name'])
+        records[name] = Record(name, kind, int(rec[kind]))
+    return records
+
+
+def parse_report(text):
+    """Parse the console output of 'bootstage report'
+
+    The report ends at the first line after the header which is not part of
+    it, so that numbers printed later on the console are not taken as
+    records. A later header starts another report.
+    """
+    re_mark = re.compile(r'^\s*([\d,]+)\s+([\d,]+)\s+(.*\S)\s*$')
+    re_accum = re.compile(r'^\s*([\d,]+)\s+(.*\S)\s*$')
+    records = {}
+    in_report = in_accum = False
+    for line in text.splitlines():
+        if 'Mark' in line and 'Elapsed' in line and 'Stage' in line:
+            in_report, in_accum = True, False
+            continue
+        if not in_report:
+            continue
+        if line.startswith('Accumulated time:'):
+            in_accum = True
+            continue
+        m_mark = re_mark.match(line)
+        m_accum = re_accum.match(line)
+        if not in_accum and m_mark:
+            kind, value, name = MARK, m_mark.group(1), m_mark.group(3)
+        elif m_accum:
+            kind = MARK if not in_accum else ACCUM
+            value, name = m_accum.group(1), m_accum.group(2)
+        elif not in_accum and (not line.strip() or
+                               line.startswith('Overflowed') or
+                               line.startswith('Please increase')):
+            # Blank line before 'Accumulated time:' or an overflow warning
+            continue
+        else:
+            in_report = False
+            continue
+        name = unique_name(records, name)
+        records[name] = Record(name, kind, int(value.replace(',', '')))
+    if not records:
+        raise ValueError('No bootstage report found')
+    return records
+
+
+def read_timeline(fname):
+    """Read a timeline from a file
+
+    Returns:
+        dict of Record, keyed by name
+    """
+    with open(fname) as fd:
+        text = fd.read()
+    try:
+        if text.lstrip().startswith('{'):
+            return parse_json(text)
+        return parse_report(text)
+    except (ValueError, KeyError) as e:
+        sys.exit('%s: %s' % (fname, e))
+
+
+def write_timeline(records, fname):
+    """Write a timeline in the format used by 'bootstage export'"""
+    lines = []
+    for rec in sorted(records.values(),
+                      key=lambda rec: (rec.kind == ACCUM, rec.time_us)):
+        lines.append(json.dumps({'name': rec.name, rec.kind: rec.time_us},
+                                separators=(',', ':')))
+    with open(fname, 'w') as fd:
+        fd.write('{"version":1,"records":[\n%s\n]}\n' % ',\n'.join(lines))
+
+
+def merge(timelines, method):
+    """Merge several runs into one timeline
+
+    Each record gets the median, minimum or mean of its times in the runs
+    in which it appears.
+    """
+    func = {'median': statistics.median_low, 'min': min,
+            'mean': lambda vals: int(statistics.mean(vals))}[method]
+    merged = {}
+    for name in set().union(*timelines):
+        recs = [tl[name] for tl in timelines if name in tl]
+        merged[name] = Record(name, recs[0].kind,
+                              func([rec.time_us for rec in recs]))
+    return merged
+
+
+def stage_times(records):
+    """Work out the time taken by each stage
+
+    Marks are sorted by time, and the time of each stage is the time from
+    the previous mark. Accumulated records are durations already.
+
+    Returns:
+        dict of durations in microseconds, keyed by name
+    """
+    times = {}
+    prev = 0
+    for rec in sorted([rec for rec in records.values() if rec.kind == MARK],
+                      key=lambda rec: rec.time_us):
+        times[rec.name] = rec.time_us - prev
+        prev = rec.time_us
+    times['(total)'] = prev
+    for rec in records.values():
+        if rec.kind == ACCUM:
+            times[rec.name] = rec.time_us
+    return times
+
+
+def diff(base, new, threshold_us, percent):
+    """Compare two timelines and print the differences
+
+    Returns:
+        Number of regressions found
+    """
+    base_times = stage_times(base)
+    new_times = stage_times(new)
+    regressions = 0
+
+    # Keep the order of the new timeline, with removed stages at the end
+    order = [rec.name for rec in sorted(new.values(),
+             key=lambda rec: (rec.kind == ACCUM, rec.time_us))]
+    order += [name for name in base if name not in new]
+    order.append('(total)')
+
+    print('%12s %12s %12s %8s  %s' % ('Base', 'New', 'Delta', '%', 'Stage'))
+    for name in order:
+        old, cur = base_times.get(name), new_times.get(name)
+        if old is None or cur is None:
+            print('%12s %12s %12s %8s  %s' %
+                  (old if old is not None else '-',
+                   cur if cur is not None else '-', '', '', name))
+            continue
+        delta = cur - old
+        pct = delta * 100.0 / old if old else 0.0
+        flag = ''
+        if delta > threshold_us and (percent is None or not old or
+                                     pct > percent):
+            flag = '  <-- regression'
+            regressions += 1
+        print('%12d %12d %+12d %+7.1f%%  %s%s' %
+              (old, cur, delta, pct, name, flag))
+
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare boot timelines')
+    sub = parser.add_subparsers(dest='cmd')
+
+    mrg = sub.add_parser('merge', help='Merge several runs into one')
+    mrg.add_argument('-m', '--method', default='median',
+                     choices=['median', 'min', 'mean'],
+                     help='How to combine the runs (default median)')
+    mrg.add_argument('-o', '--output', required=True,
+                     help='JSON file to write')
+    mrg.add_argument('files', nargs='+')
+
+    dif = sub.add_parser('diff', help='Compare two timelines')
+    dif.add_argument('-t', '--threshold', type=int, default=1000,
+                     help='Flag stages slower by more than this many '
+                     'microseconds (default 1000)')
+    dif.add_argument('-p', '--percent', type=float,
+                     help='...and by more than this percentage')
+    dif.add_argument('base')
+    dif.add_argument('new')
+
+    args = parser.parse_args()
+    if args.cmd == 'merge':
+        write_timeline(merge([read_timeline(f) for f in args.files],
+                             args.method), args.output)
+    elif args.cmd == 'diff':
+        regressions = diff(read_timeline(args.base), read_timeline(args.new),
+                           args.threshold, args.percent)
+        if regressions:
+            print('%d regression(s) above threshold' % regressions)
+            return 1
+    else:
+        parser.print_help()
+        return 2
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
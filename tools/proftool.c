@@ -55,6 +55,8 @@ struct func_info *func_list;
 int func_count;
 struct trace_call *call_list;
 int call_count;
+struct trace_sample *sample_list;
+int sample_count;
 int verbose;	/* Verbosity level 0=none, 1=warn, 2=notice, 3=info, 4=debug */
 unsigned long text_offset;		/* text address of first function */
 
@@ -85,6 +87,8 @@ static void usage(void)
 		"\n"
 		"Commands\n"
 		"   dump-ftrace\t\tDump out textual data in ftrace format\n"
+		"   dump-flamegraph\tDump profiler samples as folded stacks,\n"
+		"\t\t\tfor flamegraph.pl\n"
 		"\n"
 		"Options:\n"
 		"   -m <map>\tSpecify Systen.map file\n"
@@ -226,6 +230,21 @@ static int read_calls(FILE *fin, int count)
 	return 0;
 }
 
+static int read_samples(FILE *fin, int count)
+{
+	notice("sample count: %d\n", count);
+	if (!count)
+		return 0;
+	sample_list = calloc(count, sizeof(struct trace_sample));
+	if (!sample_list) {
+		error("Cannot allocate sample_list\n");
+		return -1;
+	}
+	sample_count = count;
+
+	return read_data(fin, sample_list, count * sizeof(struct trace_sample));
+}
+
 static int read_profile(FILE *fin, int *not_found)
 {
 	struct trace_output_hdr hdr;
@@ -249,6 +268,11 @@ static int read_profile(FILE *fin, int *not_found)
 			if (read_calls(fin, hdr.rec_count))
 				return 1;
 			break;
+
+		case TRACE_CHUNK_SAMPLES:
+			if (read_samples(fin, hdr.rec_count))
+				return 1;
+			break;
 		}
 	}
 	return 0;
@@ -532,6 +556,77 @@ static int make_ftrace(void)
 	return 0;
 }
 
+/* A sampled call stack, as far as we know it */
+struct folded_stack {
+	struct func_info *caller;
+	struct func_info *func;
+};
+
+static int h_cmp_stack(const void *v1, const void *v2)
+{
+	const struct folded_stack *s1 = v1, *s2 = v2;
+
+	if (s1->caller != s2->caller)
+		return s1->caller < s2->caller ? -1 : 1;
+	if (s1->func != s2->func)
+		return s1->func < s2->func ? -1 : 1;
+
+	return 0;
+}
+
+/*
+ * Output one line per distinct stack with the number of samples, in the
+ * format read by flamegraph.pl:
+ *
+ *	board_init_r;mmc_bread 102
+ *	memcpy 512
+ *
+ * The only caller we know is the function containing the sampled link
+ * register. That is not a caller if the sampled function had already
+ * made a call itself, in which case the link register points into it.
+ * Samples which cannot be placed in any function are shown as [unknown].
+ */
+static int make_flamegraph(void)
+{
+	struct folded_stack *stacks;
+	int i, count;
+
+	if (!sample_count) {
+		error("No profiler samples found\n");
+		return -1;
+	}
+	if (!func_count) {
+		error("No functions found in map file\n");
+		return -1;
+	}
+	stacks = calloc(sample_count, sizeof(*stacks));
+	if (!stacks) {
+		error("Cannot allocate stacks\n");
+		return -1;
+	}
+	for (i = 0; i < sample_count; i++) {
+		stacks[i].func = find_caller_by_offset(sample_list[i].pc);
+		stacks[i].caller = find_caller_by_offset(sample_list[i].lr);
+		if (stacks[i].caller == stacks[i].func)
+			stacks[i].caller = NULL;
+	}
+	qsort(stacks, sample_count, sizeof(*stacks), h_cmp_stack);
+
+	for (i = 0; i < sample_count; i += count) {
+		for (count = 1; i + count < sample_count; count++) {
+			if (h_cmp_stack(&stacks[i], &stacks[i + count]))
+				break;
+		}
+		if (stacks[i].caller)
+			printf("%s;", stacks[i].caller->name);
+		printf("%s %d\n", stacks[i].func ? stacks[i].func->name :
+		       "[unknown]", count);
+	}
+	free(stacks);
+
+	return 0;
+}
+
 static int prof_tool(int argc, char * const argv[],
 		     const char *prof_fname, const char *map_fname,
 		     const char *trace_config_fname)
@@ -552,6 +647,8 @@ static int prof_tool(int argc, char * const argv[],
 
 		if (0 == strcmp(cmd, "dump-ftrace"))
 			err = make_ftrace();
+		else if (0 == strcmp(cmd, "dump-flamegraph"))
+			err = make_flamegraph();
 		else
 			warn("Unknown command '%s'\n", cmd);
 	}